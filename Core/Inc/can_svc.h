@@ -0,0 +1,108 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "events.h"
+
+/* Service CAN.
+   Le backend programme les filtres d’acceptation matériels à partir de CAN_RX_TABLE
+   (can_table.c): seules les trames décrites atteignent le MCU. L’ISR de FIFO les
+   range directement dans un pool de messages (pas de recopie ensuite) et publie
+   leur handle dans une file ISR → boucle principale; can_pop_rx() les sort en
+   événements, comme tmr_pop_expired(). */
+
+/* Messages du pool (max 32: masque des libres) */
+#ifndef CAN_POOL_SIZE
+#define CAN_POOL_SIZE 16U
+#endif
+
+/* CAN FD: trames jusqu’à 64 octets, débit de données commuté (BRS). Le trafic
+   de commande reste en trames classiques; tous les nœuds du bus doivent
+   tolérer le format FD (un contrôleur classique seul le refuse en erreur). */
+#ifndef CAN_FD
+#define CAN_FD 1
+#endif
+
+/* Octets de données max par trame (8 en CAN classique, 64 en FD) */
+#ifndef CAN_MAX_DATA
+#if CAN_FD
+#define CAN_MAX_DATA 64U
+#else
+#define CAN_MAX_DATA 8U
+#endif
+#endif
+
+/* Une ligne du tableau de réception: identifiant/masque (filtre matériel),
+   FIFO matérielle cible (0 ou 1: la 1 pour les trames prioritaires, servie
+   avant la 0) et événement émis à réception. */
+typedef struct {
+    uint32_t  id;
+    uint32_t  mask;       /* bits à comparer (1 = significatif) */
+    bool      ext;        /* identifiant étendu 29 bits */
+    uint8_t   fifo;
+    EventType evt;
+} CanRxDesc;
+
+/* Tableau fourni par can_table.c */
+extern const CanRxDesc CAN_RX_TABLE[];
+extern const uint8_t   CAN_RX_TABLE_COUNT;
+
+/* Message reçu (dans le pool) */
+typedef struct {
+    uint32_t id;
+    uint32_t at_ms;       /* instant de réception (HAL_GetTick dans l’ISR) */
+    uint8_t  len;         /* octets de données */
+    uint8_t  row;         /* ligne de CAN_RX_TABLE qui a accepté la trame */
+    bool     ext;
+    uint8_t  data[CAN_MAX_DATA];
+} CanMsg;
+
+#define CAN_HANDLE_NONE 0xFFU
+
+typedef struct {
+    uint32_t received;    /* trames publiées */
+    uint32_t pool_empty;  /* trames lues mais perdues: pool plein (consommateur en retard) */
+    uint32_t hw_lost;     /* trames perdues en FIFO matérielle (signalées par le backend) */
+    uint32_t sent;        /* trames confiées au contrôleur */
+    uint32_t tx_full;     /* envois refusés: FIFO d’émission pleine */
+} CanStats;
+
+void can_init(void);
+
+/* Événement suivant: type = CAN_RX_TABLE[row].evt, arg.u8 = handle, arg.u16 = ligne.
+   Le message (can_msg(handle)) reste valide jusqu’au can_pop_rx() suivant:
+   le gestionnaire le lit en place, le copie s’il doit le garder. */
+bool can_pop_rx(EventMsg* out);
+
+/* Message associé à un handle livré par can_pop_rx(), NULL si invalide */
+const CanMsg* can_msg(uint8_t handle);
+
+void can_get_stats(CanStats* out);
+
+/* Émission sans attente (boucle principale uniquement). Retourne false si
+   len > 8 ou si la FIFO d’émission du contrôleur est pleine. */
+bool can_send(uint32_t id, bool ext, const uint8_t* data, uint8_t len);
+
+/* Idem en trame FD avec BRS, len ≤ CAN_MAX_DATA (arrondie à la taille DLC
+   supérieure, complétée par des zéros). false si CAN_FD vaut 0. */
+bool can_send_fd(uint32_t id, bool ext, const uint8_t* data, uint8_t len);
+
+/* Places libres dans la FIFO d’émission: un flux de fond en laisse une pour
+   le trafic de commande. */
+uint8_t can_tx_free(void);
+
+/* Côté backend (ISR de FIFO):
+   - can_rx_alloc(): message libre à remplir, NULL si pool plein (trame à jeter);
+   - can_rx_commit(): publie le message rempli;
+   - can_rx_free(): rend un message alloué mais non publié (lecture en échec);
+   - can_note_hw_lost(): trames perdues en FIFO matérielle. */
+CanMsg* can_rx_alloc(void);
+void    can_rx_commit(CanMsg* m);
+void    can_rx_free(CanMsg* m);
+void    can_note_hw_lost(uint32_t n);
+
+/* Hooks HARDWARE à fournir ailleurs (hw_can_stm32.c):
+   - hw_can_send(): place une trame (classique, ou FD + BRS si fd) dans la FIFO
+     d’émission, retourne false si elle est pleine (ou len > 64, > 8 en classique);
+   - hw_can_tx_free(): places libres dans cette FIFO. */
+bool    hw_can_send(uint32_t id, bool ext, const uint8_t* data, uint8_t len, bool fd);
+uint8_t hw_can_tx_free(void);
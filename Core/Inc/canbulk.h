@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_svc.h"
+#include "coord.h"
+
+/* Transfert de masse sur CAN FD (vidages de diagnostic, valise de maintenance).
+   L’outil ouvre un objet (OPEN), l’unité annonce sa taille (INFO) puis l’envoie
+   en segments FD + BRS de CANBULK_SEG_DATA octets numérotés. Contrôle de flux
+   par fenêtre: l’outil acquitte cumulativement (ACK = prochain segment attendu
+   + fenêtre accordée), l’unité n’a jamais plus de « fenêtre » segments non
+   acquittés en vol. Un trou signalé (NAK) ou un silence de CANBULK_ACK_TIMEOUT_MS
+   fait repartir du premier segment non acquitté (go-back-N).
+   Identifiants bas de priorité (0x7xx) et une place de FIFO d’émission
+   toujours laissée libre: le trafic de commande passe devant.
+
+   Outil → unité, CANBULK_ID_CMD + COORD_NODE_ID (classique ou FD):
+     OPEN  [0x01, objet, fenêtre]
+     ACK   [0x02, suivant (LE16), fenêtre]
+     ABORT [0x03]
+     NAK   [0x04, suivant (LE16), fenêtre]
+   Unité → outil, CANBULK_ID_CTRL + COORD_NODE_ID (classique, 8 octets):
+     INFO  [0x81, objet, taille (LE32), segments (LE16)]
+     DONE  [0x82, objet]
+     ERR   [0xFF, objet, code CANBULK_ERR_*]
+   Unité → outil, CANBULK_ID_DATA + COORD_NODE_ID (FD + BRS, classique si CAN_FD = 0):
+     DATA  [segment (LE16), données…] (dernier segment complété par des zéros) */
+
+#define CANBULK_ID_CMD   0x700U
+#define CANBULK_ID_CTRL  0x740U
+#define CANBULK_ID_DATA  0x780U
+
+#define CANBULK_OP_OPEN   0x01U
+#define CANBULK_OP_ACK    0x02U
+#define CANBULK_OP_ABORT  0x03U
+#define CANBULK_OP_NAK    0x04U
+#define CANBULK_OP_INFO   0x81U
+#define CANBULK_OP_DONE   0x82U
+#define CANBULK_OP_ERR    0xFFU
+
+#define CANBULK_ERR_OBJECT   1U   /* objet inconnu */
+#define CANBULK_ERR_TIMEOUT  2U   /* outil muet: transfert abandonné */
+#define CANBULK_ERR_SIZE     3U   /* objet trop grand (> 65535 segments) */
+
+/* Données par segment */
+#define CANBULK_SEG_DATA  (CAN_MAX_DATA - 2U)
+
+/* Fenêtre max (segments en vol), quelle que soit celle accordée */
+#ifndef CANBULK_MAX_WINDOW
+#define CANBULK_MAX_WINDOW 32U
+#endif
+
+/* Segments en vol sans acquittement depuis (ms): réémission */
+#ifndef CANBULK_ACK_TIMEOUT_MS
+#define CANBULK_ACK_TIMEOUT_MS 200U
+#endif
+
+/* Réémissions consécutives sans progrès avant abandon */
+#ifndef CANBULK_MAX_RETRY
+#define CANBULK_MAX_RETRY 5U
+#endif
+
+/* Outil silencieux depuis (ms): transfert oublié (fenêtre fermée comprise) */
+#ifndef CANBULK_IDLE_MS
+#define CANBULK_IDLE_MS 5000U
+#endif
+
+/* Objets de vidage complet (RAM entière, flash) en plus de l’instantané de
+   diagnostic: lisibles par n’importe quel nœud du bus, sans authentification.
+   Builds de labo seulement. */
+#ifndef CANBULK_FULL_DUMP
+#define CANBULK_FULL_DUMP 0
+#endif
+
+/* Objet transférable: taille lue à l’ouverture, lecture par morceaux */
+typedef struct {
+    uint32_t (*size)(void);
+    void     (*read)(uint32_t off, uint8_t* dst, uint32_t n);
+} CanBulkObj;
+
+/* Tableau fourni par canbulk_table.c (numéro d’objet = index) */
+extern const CanBulkObj CANBULK_OBJS[];
+extern const uint8_t    CANBULK_OBJS_COUNT;
+
+typedef struct {
+    uint32_t transfers;    /* transferts menés à terme */
+    uint32_t segments;     /* segments émis (réémissions comprises) */
+    uint32_t retransmits;  /* retours arrière (NAK ou silence) */
+    uint32_t aborted;      /* abandons (outil, silence, erreur) */
+} CanBulkStats;
+
+void canbulk_init(void);
+
+/* Trame de l’outil (EVT_CANBULK_RX) */
+void canbulk_on_rx(const CanMsg* m);
+
+/* Boucle principale: remplit la fenêtre, surveille les délais. */
+void canbulk_poll(void);
+
+void canbulk_get_stats(CanBulkStats* out);
+
+/* Hook à fournir ailleurs (main.c): temps courant en ms */
+uint32_t canbulk_now_ms(void);
@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Console de service (USART2 RX).
+   Les octets reçus sont rangés par l’ISR dans un anneau; console_poll() (boucle
+   principale) en traite au plus CON_POLL_BUDGET par passage: quel que soit le
+   débit ou le bruit en ligne, le dispatcher n’attend jamais. Lignes ASCII
+   terminées par CR ou LF, découpées en place (aucune allocation), commande
+   retrouvée par hachage parfait. Réponses en trames de télémétrie TELEM_T_TEXT
+   (même ligne TX, affichées par tools/log_decode.py).
+   Un 0x00 ouvre une trame binaire (COBS, jusqu’au 0x00 suivant) remise à
+   hil_on_frame(): le banc de test partage la ligne avec la console. */
+
+/* Anneau de réception (puissance de 2) */
+#ifndef CON_RX_RING
+#define CON_RX_RING 256U
+#endif
+
+/* Longueur max d’une ligne de commande; au-delà, la ligne est ignorée */
+#ifndef CON_LINE_MAX
+#define CON_LINE_MAX 64U
+#endif
+
+/* Arguments max (nom de commande compris) */
+#ifndef CON_MAX_ARGS
+#define CON_MAX_ARGS 6U
+#endif
+
+/* Octets traités au plus par console_poll() */
+#ifndef CON_POLL_BUDGET
+#define CON_POLL_BUDGET 64U
+#endif
+
+/* Commande: argv[0] = nom, argc >= 1 + min_args */
+typedef void (*ConCmdFn)(uint8_t argc, char* argv[]);
+
+typedef struct {
+    const char* name;
+    ConCmdFn    fn;
+    uint8_t     min_args;
+    const char* help;
+} ConCmd;
+
+/* Tableau fourni par console_cmds.c */
+extern const ConCmd  CON_CMDS[];
+extern const uint8_t CON_CMDS_COUNT;
+
+typedef struct {
+    uint32_t lines;        /* commandes exécutées */
+    uint32_t unknown;      /* commandes inconnues */
+    uint32_t rx_overrun;   /* octets perdus: anneau plein */
+    uint32_t too_long;     /* lignes ou trames ignorées: > CON_LINE_MAX */
+    uint32_t noise;        /* octets non imprimables écartés */
+} ConStats;
+
+void console_init(void);
+
+/* Boucle principale: traite les octets reçus, exécute les lignes complètes. */
+void console_poll(void);
+
+void console_get_stats(ConStats* out);
+
+/* Côté backend (ISR): octets reçus. */
+void console_rx_bytes(const uint8_t* p, uint32_t n);
+
+/* Réponses: une ligne se construit par morceaux puis part avec con_endl(). */
+void con_puts(const char* s);
+void con_putu(uint32_t v);
+void con_puti(int32_t v);
+void con_putx(uint32_t v, uint8_t digits);
+void con_endl(void);
+
+/* Entier décimal ou 0x… hexadécimal. Retourne false si invalide. */
+bool con_parse_u32(const char* s, uint32_t* out);
+
+/* Hook HARDWARE à fournir ailleurs (hw_console_stm32.c): s’assure que la
+   réception est armée (relance après une erreur de ligne). Boucle principale. */
+void hw_console_rx_kick(void);
@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_svc.h"
+
+/* Coordination multi-contrôleurs sur FDCAN1 (alimentation électrique partagée).
+   Chaque unité diffuse un état compact (état FSM, éléments allumés, éléments visés)
+   toutes les COORD_PERIOD_MS et à chaque changement. Avant d’allumer un élément,
+   la séquence demande un jeton (coord_request_stage): il n’est accordé que si
+   aucune unité n’a monté d’étage depuis COORD_GAP_MS et qu’aucune demande plus
+   ancienne (ou aussi ancienne et d’identifiant plus petit) n’est en cours.
+   Toutes les unités appliquent la même règle sur les mêmes trames: les montées
+   d’étage s’étalent sans maître. Sans pair visible (seule, bus coupé), seule la
+   règle d’écart s’applique à ses propres montées; après COORD_MAX_WAIT_MS
+   d’attente le jeton est pris quoi qu’il arrive (pair bloqué). */
+
+/* Identifiant de l’unité sur le bus (1..COORD_MAX_NODES), unique par installation */
+#ifndef COORD_NODE_ID
+#define COORD_NODE_ID 1U
+#endif
+#ifndef COORD_MAX_NODES
+#define COORD_MAX_NODES 15U
+#endif
+
+/* Trame d’état: COORD_CAN_ID_BASE + identifiant de l’unité (standard) */
+#ifndef COORD_CAN_ID_BASE
+#define COORD_CAN_ID_BASE 0x300U
+#endif
+#define COORD_CAN_ID_MASK 0x7F0U
+
+/* Période de diffusion (ms) */
+#ifndef COORD_PERIOD_MS
+#define COORD_PERIOD_MS 1000U
+#endif
+
+/* Retard toléré sur la diffusion périodique (tmr_set_slack): bien en deçà de
+   COORD_PEER_TIMEOUT_MS, elle partage le réveil des autres timers */
+#ifndef COORD_PERIOD_SLACK_MS
+#define COORD_PERIOD_SLACK_MS 100U
+#endif
+
+/* Écart minimal entre deux montées d’étage sur l’installation (ms): appel de courant résorbé */
+#ifndef COORD_GAP_MS
+#define COORD_GAP_MS 3000U
+#endif
+
+/* Une demande n’est servie qu’après ce délai: les demandes concurrentes ont été entendues */
+#ifndef COORD_SETTLE_MS
+#define COORD_SETTLE_MS 200U
+#endif
+
+/* Nouvel essai d’une demande refusée (ms) */
+#ifndef COORD_RETRY_MS
+#define COORD_RETRY_MS 250U
+#endif
+
+/* Pair silencieux depuis (ms): oublié */
+#ifndef COORD_PEER_TIMEOUT_MS
+#define COORD_PEER_TIMEOUT_MS 3500U
+#endif
+
+/* Attente max d’un jeton (ms): au-delà, accordé (un pair bloqué n’empêche pas de chauffer) */
+#ifndef COORD_MAX_WAIT_MS
+#define COORD_MAX_WAIT_MS 60000U
+#endif
+
+/* Trame d’état (8 octets) */
+#define COORD_F_WANTS   0x01U   /* demande de montée d’étage en cours */
+
+typedef struct {
+    uint8_t state;       /* FsmState */
+    uint8_t stages;      /* éléments allumés */
+    uint8_t demand;      /* éléments visés */
+    uint8_t flags;       /* COORD_F_* */
+    uint8_t req_age;     /* âge de la demande en cours (100 ms, saturé) */
+    uint8_t up_age;      /* depuis la dernière montée d’étage (100 ms, saturé) */
+    uint8_t seq;
+} CoordFrame;
+
+/* Vue d’un pair */
+typedef struct {
+    bool     alive;
+    uint32_t seen_ms;
+    CoordFrame last;
+} CoordPeer;
+
+void coord_init(void);
+
+/* Tic de diffusion (EVT_COORD_TICK, service timers): diffuse et réarme. */
+void coord_on_tick(void);
+
+/* Trame d’état reçue (EVT_COORD_RX) */
+void coord_on_rx(const CanMsg* m);
+
+/* Jeton de montée d’étage: true = allumer maintenant (la montée est enregistrée
+   et diffusée). false = réessayer plus tard (COORD_RETRY_MS). */
+bool coord_request_stage(void);
+
+/* Abandon d’une demande (séquence annulée) */
+void coord_cancel_request(void);
+
+/* Lecture de la vue d’un pair (1..COORD_MAX_NODES), false si inconnu/oublié */
+bool coord_get_peer(uint8_t node, CoordPeer* out);
+
+/* Encodage/décodage de la trame d’état */
+void coord_encode(const CoordFrame* f, uint8_t out[8]);
+void coord_decode(const uint8_t in[8], CoordFrame* f);
+
+/* Hooks à fournir ailleurs:
+   - horloge en ms (ex: HAL_GetTick);
+   - état local: état FSM, éléments allumés, éléments visés. */
+uint32_t coord_now_ms(void);
+void     coord_local(uint8_t* state, uint8_t* stages, uint8_t* demand);
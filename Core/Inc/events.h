@@ -36,10 +36,23 @@ typedef enum {
     EVT_FAULT_TIME_ELEMS,
     EVT_SENSOR_FAULT,
     EVT_FAULT_CLEAR,
+    EVT_FAULT_OUT_OVERCURRENT,  /* driver de sorties (relecture SPI), arg.u8 = octet d’état, arg.u16 = circuit */
+    EVT_FAULT_OUT_OPEN_LOAD,
+    EVT_FAULT_OUT_THERMAL,
+    EVT_FAULT_OUT_DRIVER,       /* broche OUTPUT_DRV_FAULT (EXTI), sorties déjà coupées */
+    EVT_FAULT_OUT_POWER,        /* broche OUTPUT_DRV_PGOOG (EXTI), sorties déjà coupées */
 
     /* Orchestration interne */
     EVT_SEQ_DONE,
     EVT_TRANSITION_REQ,
+    EVT_INP_SETTLE,     /* échéance de stabilité d’une entrée (mode EXTI), arg.u8 = voie */
+    EVT_TPO_EDGE,       /* prochain front de la modulation des éléments (TMR_TPO) */
+    EVT_CAN_RX,         /* trame CAN acceptée, arg.u8 = handle (can_msg), arg.u16 = ligne de CAN_RX_TABLE */
+    EVT_COORD_RX,       /* trame d’état d’une autre unité (même arg que EVT_CAN_RX) */
+    EVT_COORD_TICK,     /* diffusion de l’état de coordination (TMR_COORD) */
+    EVT_CANBULK_RX,     /* commande de l’outil de transfert de masse (même arg que EVT_CAN_RX) */
+    EVT_FWUPD_RX,       /* trame de mise à jour firmware (même arg que EVT_CAN_RX) */
+    EVT_POWER_SET,      /* consigne de puissance par élément, arg.u16 = pour-mille (TPO_DUTY_MAX) */
 
     /* Réserves */
     EVT_RESERVED_1,
@@ -82,6 +95,7 @@ typedef struct {
 void evq_init(void);
 bool evq_push(EvQueueId qid, EventType type, EventArg arg);
 bool evq_pop_next(EventMsg* out);       /* vide d’abord FAULTS, puis NORMAL */
+bool evq_pop(EvQueueId qid, EventMsg* out); /* une file précise (dispatcher) */
 void evq_note_ignored(EventType type);  /* compteur "ignored" */
 void evq_get_stats(EvQueueId qid, EvQueueStats* out);
 
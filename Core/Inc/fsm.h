@@ -24,6 +24,8 @@ typedef enum {
     GUARD_TARGET_GAS,      /* cible finale gaz */
     GUARD_TEMP_SAFE,       /* T° sous seuil safe (avec hystérésis) */
     GUARD_NO_FAULT,        /* aucune faute latched */
+    GUARD_LOCKOUT_ACTIVE,  /* anti-flap en cours (négation de GUARD_LOCKOUT_CLEAR) */
+    GUARD_COOLDOWN_DONE,   /* ventilation minimale écoulée */
     GUARD_MAX
 } GuardId;
 
@@ -53,13 +55,21 @@ typedef struct {
 /* API FSM */
 void fsm_init(FsmState init);
 FsmState fsm_state(void);
+uint8_t  fsm_stages(void);   /* éléments chauffants commandés (0..3) */
 
 /* Traite un événement: retourne true si une transition a été appliquée */
 bool fsm_handle_event(const EventMsg* ev);
 
-/* Hooks optionnels fournis par d'autres modules (implémentés ailleurs) */
+/* Défaut critique: bascule en ST_FAULT depuis n'importe quel état */
+bool fsm_is_critical(EventType type);
+
+/* Guards (fsm_guards.c): mémoire initialisée par fsm_init(), mise à jour
+   avec chaque événement avant l'évaluation de la table */
+void fsm_guards_init(void);
+void fsm_guards_observe(const EventMsg* ev);
 bool guard_lockout_clear(void);
 bool guard_target_is_elec(void);
 bool guard_target_is_gas(void);
 bool guard_temp_is_safe(void);
 bool guard_no_fault(void);
+bool guard_cooldown_done(void);
@@ -0,0 +1,108 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_svc.h"
+#include "coord.h"
+
+/* Mise à jour du firmware en service (A/B, deux banques flash).
+   L’image reçue est écrite dans la banque inactive pendant que l’application
+   continue de tourner sur l’autre (lecture pendant écriture entre banques).
+   Réception par blocs en double tampon: le bloc n se programme (flash pilotée
+   par IRQ, quad-mot après quad-mot) pendant que le bloc n+1 arrive; le débit
+   est celui de la liaison. Chaque bloc est vérifié (CRC32 matériel) avant
+   programmation, l’image entière est relue et vérifiée en flash avant
+   l’échange de banques. Échec ou abandon à tout moment: l’image en service
+   n’est jamais touchée.
+   Avant l’échange, la table de vecteurs de l’image est contrôlée (pile
+   initiale en SRAM, reset dans l’image): un binaire lié ailleurs est refusé.
+   La nouvelle image démarre ensuite à l’essai: confirmée après
+   FWUPD_CONFIRM_MS de boucle principale, sinon (blocage: chien de garde,
+   redémarrages répétés) le backend revient à l’image précédente. Pas de
+   nouvelle session pendant l’essai: la banque inactive est l’image de repli.
+
+   Outil → unité, FWUPD_ID_CMD + COORD_NODE_ID:
+     START  [0x10, taille (LE32)]                 taille multiple de 16
+     DATA   [0x20, bloc (LE16), trame, données…]  FWUPD_FRAME_DATA octets
+     BLKEND [0x21, bloc (LE16), crc32 (LE32)]
+     FINISH [0x30, crc32 de l’image (LE32)]
+     COMMIT [0x31]                                échange de banques, redémarrage (à l’essai)
+     ABORT  [0x3F]
+   Unité → outil, FWUPD_ID_RSP + COORD_NODE_ID (classique, 8 octets):
+     READY  [0xA0, taille de bloc (LE16), trames par bloc]   effacement terminé
+     ACK    [0xA1, bloc (LE16)]            bloc accepté, tampon libre pour le suivant
+     NAK    [0xA2, bloc (LE16), trames manquantes (LE16)]  (0: CRC faux, tout renvoyer)
+     DONE   [0xB0, ok, crc32 relu (LE32)]
+     ERR    [0xEE, code FWUPD_ERR_*]
+   CRC32: celui de zlib (0x04C11DB7 réfléchi, init et XOR final 0xFFFFFFFF). */
+
+#define FWUPD_ID_CMD  0x7C0U
+#define FWUPD_ID_RSP  0x7E0U
+
+#define FWUPD_OP_START   0x10U
+#define FWUPD_OP_DATA    0x20U
+#define FWUPD_OP_BLKEND  0x21U
+#define FWUPD_OP_FINISH  0x30U
+#define FWUPD_OP_COMMIT  0x31U
+#define FWUPD_OP_ABORT   0x3FU
+#define FWUPD_OP_READY   0xA0U
+#define FWUPD_OP_ACK     0xA1U
+#define FWUPD_OP_NAK     0xA2U
+#define FWUPD_OP_DONE    0xB0U
+#define FWUPD_OP_ERR     0xEEU
+
+#define FWUPD_ERR_STATE  1U   /* commande hors séquence, ou flash encore occupée */
+#define FWUPD_ERR_SIZE   2U   /* taille nulle, non multiple de 16 ou > une banque */
+#define FWUPD_ERR_FLASH  3U   /* effacement ou programmation en erreur */
+#define FWUPD_ERR_IMAGE  4U   /* image relue conforme mais non amorçable (table de vecteurs) */
+
+/* Durée de fonctionnement qui confirme une image démarrée à l’essai */
+#ifndef FWUPD_CONFIRM_MS
+#define FWUPD_CONFIRM_MS  60000U
+#endif
+
+/* Trame DATA: 4 octets d’en-tête; un bloc = 16 trames (multiple du quad-mot) */
+#define FWUPD_FRAME_DATA        (CAN_MAX_DATA - 4U)
+#define FWUPD_FRAMES_PER_BLOCK  16U
+#define FWUPD_BLOCK             (FWUPD_FRAME_DATA * FWUPD_FRAMES_PER_BLOCK)
+
+typedef enum {
+    FWUPD_IDLE = 0,
+    FWUPD_ERASING,
+    FWUPD_RECEIVING,
+    FWUPD_FINISHING,     /* FINISH reçu, derniers blocs en programmation */
+    FWUPD_VERIFIED,      /* image relue conforme, COMMIT possible */
+    FWUPD_FAILED
+} FwupdState;
+
+void fwupd_init(void);
+
+/* Trame de l’outil (EVT_FWUPD_RX) */
+void fwupd_on_rx(const CanMsg* m);
+
+/* Boucle principale: lance les programmations, réponses différées, vérification. */
+void fwupd_poll(void);
+
+FwupdState fwupd_state(void);
+
+/* Côté backend (ISR flash) */
+void fwupd_on_erase_done(bool ok);
+void fwupd_on_program_done(bool ok);
+
+/* Démarrage à l’essai pas encore confirmé (START refusé) */
+bool fwupd_on_trial(void);
+
+/* Hook HARDWARE à fournir ailleurs (main.c) */
+uint32_t fwupd_now_ms(void);
+
+/* Hooks HARDWARE à fournir ailleurs (hw_fwupd_stm32.c) */
+uint32_t       hw_fwupd_capacity(void);                          /* octets de la banque inactive */
+bool           hw_fwupd_erase_start(uint32_t size);               /* asynchrone, false si occupée */
+bool           hw_fwupd_program_start(uint32_t off, const uint8_t* src, uint32_t n); /* n multiple de 16 */
+const uint8_t* hw_fwupd_staged(void);                            /* banque inactive, cache invalidé */
+uint32_t       hw_fwupd_crc32(const uint8_t* p, uint32_t n);     /* unité CRC, boucle principale */
+void           hw_fwupd_lock(void);                              /* fin de session: flash reverrouillée */
+bool           hw_fwupd_vectors_ok(uint32_t size);               /* table de vecteurs de l’image en attente */
+void           hw_fwupd_commit(void);                            /* échange de banques + reset, ne revient pas */
+bool           hw_fwupd_trial(void);                             /* image en service à l’essai */
+void           hw_fwupd_confirm(void);                           /* image en service confirmée */
+void           hw_fwupd_kick(void);                              /* chien de garde de l’essai, boucle principale */
@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "events.h"
+
+/* Accès banc de test (HIL): injection d’événements, lecture d’état, gel et
+   pas-à-pas du dispatcher, pilotés par un script hôte (tools/hil.py).
+
+   Requêtes sur la ligne de la console (USART2 RX), en binaire, au même format
+   que la télémétrie: 0x00 COBS( TELEM_T_HIL | seq | op | args | CRC16 ) 0x00.
+   Le 0x00 de tête fait passer la console en réception de trame; le texte
+   reste utilisable entre deux requêtes.
+   Réponses en trames de télémétrie TELEM_T_HIL: [seq, op, statut, données…].
+   Une requête reçue avec le même seq que la précédente n’est pas rejouée:
+   la réponse mémorisée est renvoyée (réponse perdue, PUSH non dupliqué).
+   Entiers en little-endian.
+
+     PING   []                    → [version, EVT_MAX_ENUM, TMR_COUNT, gelé]
+     PUSH   [file, type, u8, u16] → []            evq_push(), comme un producteur réel
+     STATE  []                    → [état, étages, gelé, tick ms (LE32)]
+     EVQ    [file]                → [pushed, popped, dropped, coalesced, ignored] (LE32)
+     TMR    [premier]             → [premier, n, actifs (LE32, bit i = premier+i), restant ms (LE32) × n]
+     FREEZE [0|1]                 → []            gelé: le dispatcher ne sort plus aucun événement
+     STEP   [n (LE16)]            → [faits (LE16), dernier type, état]
+            gelé uniquement: jusqu’à n événements servis au passage suivant du
+            dispatcher (moins si les files se vident), réponse après coup.
+   Gel: seuls les événements ordinaires attendent (file NORMAL, timers
+   expirés, CAN). Les défauts (file FAULTS, défauts relus du driver de
+   sorties) sont servis malgré le gel, sans compter dans le pas-à-pas; les
+   services sans événement (entrées, sorties, Modbus, télémétrie, console)
+   et les coupures matérielles continuent. Sans requête de l’hôte pendant
+   HIL_FREEZE_MAX_MS, le gel est relâché (hôte perdu).
+
+   Compilé seulement avec HIL_ENABLE=1 (banc de test): sinon, fonctions
+   vides, le dispatcher n’est jamais retenu et les trames binaires de la
+   console sont ignorées. */
+
+#ifndef HIL_ENABLE
+#define HIL_ENABLE      0
+#endif
+
+#ifndef HIL_FREEZE_MAX_MS
+#define HIL_FREEZE_MAX_MS  30000U
+#endif
+
+#define HIL_VERSION     2U
+
+#define HIL_OP_PING     0x01U
+#define HIL_OP_PUSH     0x10U
+#define HIL_OP_STATE    0x20U
+#define HIL_OP_EVQ      0x21U
+#define HIL_OP_TMR      0x22U
+#define HIL_OP_FREEZE   0x30U
+#define HIL_OP_STEP     0x31U
+
+#define HIL_OK          0U
+#define HIL_E_ARGS      1U   /* longueur ou valeur d’argument invalide */
+#define HIL_E_OP        2U   /* opération inconnue */
+#define HIL_E_FULL      3U   /* file d’événements pleine */
+#define HIL_E_STATE     4U   /* STEP sans gel, ou pas-à-pas déjà en cours */
+
+/* Timers par réponse TMR (tient dans TELEM_MAX_PAYLOAD) */
+#define HIL_TMR_PER_FRAME  12U
+
+typedef struct {
+    uint32_t requests;     /* requêtes servies */
+    uint32_t bad_frames;   /* COBS ou CRC invalide, type inattendu */
+    uint32_t replayed;     /* seq répété: réponse renvoyée */
+    uint32_t stepped;      /* événements servis en pas-à-pas */
+    uint32_t expired;      /* gels relâchés faute de requête */
+} HilStats;
+
+#if HIL_ENABLE
+
+void hil_init(void);
+
+/* Console: trame reçue entre deux 0x00 (encodée COBS, délimiteurs exclus). */
+void hil_on_frame(const uint8_t* p, uint32_t n);
+
+/* Dispatcher: true si un événement ordinaire peut être retiré maintenant. */
+bool hil_gate(void);
+
+/* Dispatcher: événement retiré (avant de le servir). */
+void hil_on_dispatch(const EventMsg* ev);
+
+/* Boucle principale, après le service des événements: réponse de STEP,
+   fin du gel sans hôte. */
+void hil_poll(void);
+
+void hil_get_stats(HilStats* out);
+
+/* Hook à fournir ailleurs (main.c): temps courant en ms */
+uint32_t hil_now_ms(void);
+
+#else
+
+static inline void hil_init(void) {}
+static inline void hil_on_frame(const uint8_t* p, uint32_t n) { (void)p; (void)n; }
+static inline bool hil_gate(void) { return true; }
+static inline void hil_on_dispatch(const EventMsg* ev) { (void)ev; }
+static inline void hil_poll(void) {}
+
+#endif
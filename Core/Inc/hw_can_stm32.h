@@ -0,0 +1,38 @@
+// hw_can_stm32.h
+#pragma once
+#include "stm32h5xx_hal.h"
+#include "main.h"
+
+// Backend STM32 du service CAN (can_svc):
+//   FDCAN1 (PB12 RX, PB13 TX), horloge noyau HSE 25 MHz.
+//   Filtres d’acceptation programmés depuis CAN_RX_TABLE, trames non décrites
+//   rejetées par le matériel (ainsi que les trames distantes).
+//   FIFO RX 0 et 1 (3 éléments chacune sur H5) vidées dans l’ISR vers le pool.
+//   CAN_FD: contrôleur en FD + BRS, reçoit trames classiques et FD; émission
+//   classique ou FD au choix de l’appelant. FIFO d’émission (ordre conservé
+//   pour un même identifiant) de 3 éléments.
+// MX_FDCAN1_Init garde la config CubeMX (aucun filtre, timing factice);
+// hw_can_init() la reprend.
+#ifndef CAN_BITRATE
+#define CAN_BITRATE            125000U    // bus du bâtiment: long, lent
+#endif
+// 25 quanta par bit: 1 (sync) + 19 + 5 → point d’échantillonnage à 80 %
+#define CAN_TQ_PER_BIT         25U
+#define CAN_TSEG1              19U
+#define CAN_TSEG2              5U
+#define CAN_SJW                4U
+// Phase de données CAN FD (BRS): liaison courte de la valise de maintenance.
+// 25 quanta à 1 Mbit/s, échantillonnage à 80 %, compensation du délai
+// émetteur (TDC) active.
+#ifndef CAN_DATA_BITRATE
+#define CAN_DATA_BITRATE       1000000U
+#endif
+#define CAN_DATA_TQ_PER_BIT    25U
+#define CAN_DATA_TSEG1         19U
+#define CAN_DATA_TSEG2         5U
+#define CAN_DATA_SJW           5U
+#define CAN_IRQ_PRIO           4U
+
+// Reconfigure FDCAN1 (timing, filtres, IT) et démarre le contrôleur.
+// À appeler après can_init().
+void hw_can_init(void);
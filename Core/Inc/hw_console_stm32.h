@@ -0,0 +1,18 @@
+// hw_console_stm32.h
+#pragma once
+#include "stm32h5xx_hal.h"
+#include "main.h"
+
+// Backend STM32 de la console (console):
+//   USART2 RX (PA11), même UART que la télémétrie (hw_telem_stm32), FIFO
+//   matérielle déjà activée par hw_telem_init(). Réception par IT jusqu’à
+//   ligne au repos (ReceiveToIdle): une commande courte est livrée dès le
+//   silence qui la suit, sans attendre CON_RX_CHUNK octets.
+//   Pas de DMA circulaire: sur GPDMA il demande le mode liste chaînée, la FIFO
+//   (8 octets) suffit à couvrir la latence de l’IRQ au débit console.
+#ifndef CON_RX_CHUNK
+#define CON_RX_CHUNK 16U
+#endif
+
+// Arme la réception. À appeler après hw_telem_init() et console_init().
+void hw_console_init(void);
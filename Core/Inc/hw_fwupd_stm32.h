@@ -0,0 +1,45 @@
+// hw_fwupd_stm32.h
+#pragma once
+#include "stm32h5xx_hal.h"
+#include "main.h"
+
+// Backend STM32 de la mise à jour (fwupd):
+//   Flash H503: deux banques de 64 Ko (8 secteurs de 8 Ko). La banque inactive
+//   est toujours vue à FLASH_BASE + FLASH_BANK_SIZE; elle est effacée secteur
+//   par secteur puis programmée quad-mot par quad-mot, chaque fin d’opération
+//   (EOP, IRQ FLASH) enchaînant la suivante: la boucle principale n’attend
+//   jamais la flash. COMMIT inverse SWAP_BANK (option bytes) et redémarre sur
+//   la nouvelle image.
+//   CRC32 par l’unité CRC (partagée avec modbus: chacun la configure à
+//   chaque calcul, boucle principale uniquement).
+//   L’image doit tenir dans une banque (ASSERT du script d’édition de liens).
+//   Démarrage à l’essai: COMMIT pose un repère dans TAMP->BKP0R (conservé au
+//   reset, perdu sans VBAT à la coupure secteur: l’image reste alors en
+//   service). Chaque démarrage à l’essai arme l’IWDG, rafraîchi par la boucle
+//   principale; après FWUPD_TRIAL_BOOTS démarrages sans confirmation, SWAP_BANK
+//   est rebasculé vers l’image précédente. Un blocage avant main() (startup,
+//   SystemInit) n’est pas couvert: il faudrait l’IWDG matériel (option bytes).
+#define FWUPD_FLASH_IRQ_PRIO  6U
+
+#ifndef FWUPD_TRIAL_BOOTS
+#define FWUPD_TRIAL_BOOTS     3U
+#endif
+#ifndef FWUPD_IWDG_MS
+#define FWUPD_IWDG_MS         2000U    // LSI 32 kHz / 64: pas de 2 ms, 8190 ms au plus
+#endif
+
+typedef enum {
+    FWUPD_BOOT_NORMAL = 0,
+    FWUPD_BOOT_TRIAL,                  // image à l’essai, IWDG armé
+    FWUPD_BOOT_REVERTED                // retour sur cette image: la précédente n’a pas été confirmée
+} FwupdBoot;
+
+// Premier appel de main(), avant toute sortie: repère d’essai, IWDG, retour
+// à l’image précédente (redémarrage, ne revient pas dans ce cas).
+FwupdBoot hw_fwupd_boot_check(void);
+
+// Active l’IRQ flash. À appeler après fwupd_init().
+void hw_fwupd_init(void);
+
+// Handler FLASH (appelé par FLASH_IRQHandler): EOP et erreurs.
+void hw_fwupd_flash_irq(void);
@@ -4,29 +4,49 @@
 #include "stm32h5xx_hal.h"
 #include "main.h"
 
-// Thermostat (contact sec). Exemple: PA0
-#define TH_GPIO_Port      INPUT_1_GPIO_Port
-#define TH_Pin            INPUT_1_Pin
+// Les 8 voies INPUT_1..INPUT_8 sont lues par port (IDR) dans hw_inputs_snapshot().
+// Ports utilisés: GPIOA, GPIOB et GPIOC (broches dans main.h).
+// Le rôle de chaque voie est décrit par la table de inputs_table.c;
+// seules les polarités de câblage restent ici.
+
+// Thermostat (contact sec), INPUT_1
 #define TH_ACTIVE_LOW     1  
 
-// Provider bi-énergie (ex: 1 = ELEC, 0 = GAS). 
-#define PROV_GPIO_Port    INPUT_2_GPIO_Port
-#define PROV_Pin          INPUT_2_Pin
+// Provider bi-énergie (ex: 1 = ELEC, 0 = GAS), INPUT_2
 #define PROV_ACTIVE_LOW   0
 
-// Sélecteur utilisateur 3 positions exclusives (fils A/B/C)
-#define MODEA_GPIO_Port   INPUT_3_GPIO_Port
-#define MODEA_Pin         GPIO_PIN_3
+// Sélecteur utilisateur 3 positions exclusives (fils A/B/C), INPUT_3..INPUT_5
 #define MODEA_ACTIVE_LOW  0
-
-#define MODEB_GPIO_Port   INPUT_4_GPIO_Port
-#define MODEB_Pin         INPUT_4_Pin
 #define MODEB_ACTIVE_LOW  0
-
-#define MODEC_GPIO_Port   INPUT_5_GPIO_Port
-#define MODEC_Pin         INPUT_5_Pin
 #define MODEC_ACTIVE_LOW  0
 
+// Mode DMA (INP_SRC_DMA): TIM2 cadence l’échantillonnage à INP_DMA_SAMPLE_HZ.
+//   TIM2_UP  → GPDMA1 canal 0: GPIOB->IDR → buffer circulaire
+//   TIM2_CH1 → GPDMA1 canal 1: GPIOC->IDR → buffer circulaire
+//   TIM2_CH2 → GPDMA1 canal 2: GPIOA->IDR → buffer circulaire (IT demi/complet)
+// Les IT du canal 2 (le plus tardif des trois) déclenchent le traitement du demi-buffer.
+#define INP_DMA_SAMPLE_HZ   ((1000U * INP_OVERSAMPLE) / INP_TICK_MS)
+#define INP_DMA_HALF        ((INP_DMA_BLOCK_MS / INP_TICK_MS) * INP_OVERSAMPLE)
+#define INP_DMA_IRQ_PRIO    1U
+
+// Démarre TIM2 + GPDMA1 (après inputs_seed_from_hw).
+void hw_inputs_dma_start(void);
+
+// Mode EXTI (INP_SRC_EXTI): fronts montants et descendants sur les broches
+// d’entrée décrites par la table (inputs_used_mask). Lignes possibles: 3, 6, 7 (GPIOB),
+// 13/14 (GPIOC), 15 (GPIOA), une IRQ par ligne. Lignes 4/5: voir hw_inputs_exti_poll().
+#define INP_EXTI_IRQ_PRIO   2U
+
+// Bascule les broches d’entrée en EXTI (après inputs_seed_from_hw).
+void hw_inputs_exti_start(void);
+
+// Appelé par les callbacks EXTI HAL: broche → voies → inputs_on_edge().
+void hw_inputs_on_exti(uint16_t pin);
+
+// Lignes 4/5 réservées à la protection du driver de sorties: INPUT_6/INPUT_5
+// y sont lues par ce job à chaque tick (INP_TICK_MS), fronts → inputs_on_edge().
+void hw_inputs_exti_poll(void);
+
 // Helper "non câblé"
 #ifndef NC_Pin
 #define NC_Pin ((uint16_t)0)
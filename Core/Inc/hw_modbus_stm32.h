@@ -0,0 +1,39 @@
+// hw_modbus_stm32.h
+#pragma once
+#include "stm32h5xx_hal.h"
+#include "main.h"
+
+// Backend STM32 de l’esclave Modbus (modbus):
+//   USART1 (PA1 RX / PA2 TX), RX → GPDMA1 canal 6, TX → GPDMA1 canal 7.
+//   Fin de trame: timeout matériel du récepteur (RTOF) après MB_T35_BITS de
+//   silence, aucune IRQ par octet ni timer logiciel. Réception coupée
+//   (requêtes DMA + débordement désactivé) entre la trame et la fin de la
+//   réponse (TC), comme le veut le semi-duplex RTU.
+//   CRC16 par l’unité CRC matérielle (polynôme 0x8005 réfléchi).
+#ifndef MB_UART_BAUD
+#define MB_UART_BAUD        115200U
+#endif
+// Modbus: parité paire par défaut; UART_PARITY_NONE → 2 bits de stop (11 bits/caractère)
+#ifndef MB_UART_PARITY
+#define MB_UART_PARITY      UART_PARITY_EVEN
+#endif
+// Silence de fin de trame, en bits. 3,5 caractères de 11 bits: ~0,34 ms à
+// 115200 bauds. (La spec recommande 1,75 ms fixe au-delà de 19200 bauds:
+// 202 bits ici, au prix de la latence de réponse.)
+#ifndef MB_T35_BITS
+#define MB_T35_BITS         39U
+#endif
+// 1 = broche DE du transceiver RS-485 pilotée par l’USART (USART1_DE à
+// configurer dans CubeMX)
+#ifndef MB_RS485_DE
+#define MB_RS485_DE         0
+#endif
+#define MB_UART_IRQ_PRIO    5U
+#define MB_DMA_IRQ_PRIO     5U
+
+// Reconfigure USART1 + GPDMA + CRC pour modbus et arme la réception.
+// À appeler après modbus_init().
+void hw_modbus_init(void);
+
+// Handler USART1 (appelé par USART1_IRQHandler): RTOF et TC.
+void hw_modbus_uart_irq(void);
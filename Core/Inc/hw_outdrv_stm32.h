@@ -0,0 +1,62 @@
+// hw_outdrv_stm32.h
+#pragma once
+#include <stdbool.h>
+#include "stm32h5xx_hal.h"
+#include "main.h"
+
+// Backend STM32 du driver de sorties (outdrv):
+//   SPI2 en trames 16 bits, TX → GPDMA1 canal 3, RX → GPDMA1 canal 4.
+//   CS (OUTPUT_DRV_CS, actif bas) posé au lancement, relâché dans l’ISR de fin.
+//   Chaîne de OUTDRV_CHAIN_LEN circuits: un seul transfert DMA de N mots par
+//   trame, la latence ne croît que de 16 bits (~4 µs) par circuit.
+// MX_SPI2_Init garde la config CubeMX (trames 4 bits); hw_outdrv_init() la
+// reconfigure pour le circuit.
+#define OUTDRV_SPI_PRESCALER   SPI_BAUDRATEPRESCALER_64   // 250 MHz / 64 ≈ 3,9 MHz
+#define OUTDRV_DMA_IRQ_PRIO    3U
+#define OUTDRV_SPI_IRQ_PRIO    3U
+
+// Protection: OUTPUT_DRV_FAULT (PA4, actif bas) et OUTPUT_DRV_PGOOG (PA5, bas =
+// alimentation hors tolérance) en EXTI front descendant, priorité la plus haute.
+// L’ISR coupe OUTPUT_DRV_EN par BSRR avant toute autre chose, latche un relevé
+// puis signale le défaut à outdrv. Les sorties restent coupées jusqu’à
+// hw_outdrv_clear_trip(). Une entrée dans l’ISR sans front en attente ni broche
+// basse n’est pas un défaut: comptée (hw_outdrv_trip_glitches) et EN rétabli. Les lignes EXTI 4 et 5 sont prises: INPUT_6 (PB4) et
+// INPUT_5 (PB5) ne peuvent plus être en EXTI (voir hw_inputs_stm32.c).
+#define OUTDRV_TRIP_IRQ_PRIO       0U
+#define HW_EXTI_LINES_OUTDRV       (OUTPUT_DRV_FAULT_Pin | OUTPUT_DRV_PGOOG_Pin)
+
+// Seul le corps de l’ISR est chronométré (DWT, de l’entrée à EN bas relu sur
+// le port). Le délai front → entrée dans l’ISR (synchro EXTI, empilement,
+// masquage PRIMASK éventuel) n’est pas mesuré: aucune capture matérielle du
+// front sur PA4/PA5.
+
+// Relevé de coupure (latché au premier déclenchement, compteurs cumulés)
+typedef struct {
+    uint32_t count;            // déclenchements depuis le dernier hw_outdrv_clear_trip()
+    uint32_t at_ms;            // HAL_GetTick() du premier déclenchement
+    uint8_t  source;           // OUTDRV_TRIP_FAULT / OUTDRV_TRIP_PGOOD du premier déclenchement
+    uint8_t  pins;             // niveaux lus dans l’ISR: bit0 = FAULT, bit1 = PGOOD
+    uint32_t isr_cycles;       // entrée ISR → EN bas, premier déclenchement (sans le délai front → ISR)
+} OutdrvTrip;
+
+// Reconfigure SPI2 + GPDMA pour outdrv et arme la protection.
+// À appeler avant outdrv_flush().
+void hw_outdrv_init(void);
+
+// Handler des lignes EXTI 4/5 (appelé par EXTI4_IRQHandler / EXTI5_IRQHandler).
+void hw_outdrv_trip_irq(void);
+
+// Copie du relevé. Retourne false si aucune coupure depuis le dernier clear.
+bool hw_outdrv_get_trip(OutdrvTrip* out);
+
+// Réarme: efface le relevé si FAULT et PGOOD sont revenus au niveau sain.
+// Retourne false (relevé conservé, sorties coupées) si une broche est encore en
+// défaut. Ne réactive pas les sorties: hw_outdrv_enable(true) ensuite.
+bool hw_outdrv_clear_trip(void);
+
+// Entrées dans l’ISR de protection sans défaut constaté (cumul depuis le boot).
+uint32_t hw_outdrv_trip_glitches(void);
+
+// Conversion cycles CPU → ns (SystemCoreClock): quelques dizaines de cycles
+// ne font pas 1 µs
+uint32_t hw_outdrv_cycles_to_ns(uint32_t cycles);
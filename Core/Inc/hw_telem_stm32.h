@@ -0,0 +1,19 @@
+// hw_telem_stm32.h
+#pragma once
+#include "stm32h5xx_hal.h"
+#include "main.h"
+
+// Backend STM32 de la télémétrie (telem):
+//   USART2 (PA8 TX), FIFO matérielle activée, TX → GPDMA1 canal 5.
+//   La FIFO (8 octets) couvre la latence de l’ISR qui enchaîne deux trames:
+//   la ligne reste pleine entre les slots.
+// MX_USART2_UART_Init garde la config CubeMX (FIFO désactivée); hw_telem_init()
+// la reprend pour la télémétrie.
+#ifndef TELEM_UART_BAUD
+#define TELEM_UART_BAUD        115200U
+#endif
+#define TELEM_DMA_IRQ_PRIO     5U
+#define TELEM_UART_IRQ_PRIO    5U
+
+// Reconfigure USART2 + GPDMA pour telem. À appeler après telem_init().
+void hw_telem_init(void);
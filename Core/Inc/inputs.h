@@ -21,36 +21,186 @@
 #define INP_MODE_STABLE_MS 200U /* sélecteur utilisateur plus rapide */
 #endif
 
-/* Types d’entrées gérées ici */
+/* Debounce adaptatif: bornes de la fenêtre des contacts (thermostat, INPUT_6..8), en ms.
+   Câblage bruité → la fenêtre s’allonge; entrée propre → elle se raccourcit. */
+#ifndef INP_DEBOUNCE_MIN_MS
+#define INP_DEBOUNCE_MIN_MS 10U
+#endif
+#ifndef INP_DEBOUNCE_MAX_MS
+#define INP_DEBOUNCE_MAX_MS 120U
+#endif
+
+/* Vote k-parmi-n avant debounce sur le thermostat (câble long): un échantillon
+   ne compte à 1 que si au moins K des N derniers le sont (à 0 si au plus N-K).
+   Rejette les pointes CEM isolées; retard ajouté ≈ K échantillons. */
+#ifndef INP_TH_VOTE_N
+#define INP_TH_VOTE_N 5U
+#endif
+#ifndef INP_TH_VOTE_K
+#define INP_TH_VOTE_K 3U
+#endif
+
+/* Période d’évaluation de l’adaptation (ms) */
+#ifndef INP_ADAPT_PERIOD_MS
+#define INP_ADAPT_PERIOD_MS 60000U
+#endif
+
+/* Parasites par période à partir desquels la fenêtre double.
+   Aucun parasite sur une période → la fenêtre perd 1/4 (bornée par le min). */
+#ifndef INP_ADAPT_NOISY
+#define INP_ADAPT_NOISY 3U
+#endif
+
+/* Source d’échantillonnage des entrées */
+#define INP_SRC_POLL    0U   /* inputs_capture() lit les ports à chaque tick du scheduler */
+#define INP_SRC_DMA     1U   /* TIM2 → GPDMA → buffers circulaires, traités par demi-buffer */
+#define INP_SRC_EXTI    2U   /* fronts EXTI → échéance dans le service timers, niveau confirmé à l’expiration */
+
+#ifndef INP_SRC
+#define INP_SRC INP_SRC_DMA
+#endif
+
+/* Mode DMA: sous-échantillons par tick de debounce (10 → 10 kHz pour INP_TICK_MS=1).
+   Un bit ne change de niveau que si tous les sous-échantillons du tick concordent. */
+#ifndef INP_OVERSAMPLE
+#define INP_OVERSAMPLE 10U
+#endif
+
+/* Profondeur de la file d’instantanés ISR → boucle principale (puissance de 2).
+   Seuls les changements de niveau y entrent: elle ne se remplit que si plus de
+   INP_SNAP_DEPTH changements arrivent avant le passage de inputs_process(). */
+#ifndef INP_SNAP_DEPTH
+#define INP_SNAP_DEPTH 32U
+#endif
+
+/* Mode DMA: durée couverte par un demi-buffer (ms) = période des IRQ de traitement */
+#ifndef INP_DMA_BLOCK_MS
+#define INP_DMA_BLOCK_MS 25U
+#endif
+
+/* Mot d’entrées compacté: bit n = voie INPUT_(n+1) de la carte.
+   Toutes les voies sont débouncées ensemble (vdeb), un bit par entrée. */
+#define INP_CH_TH       0U   /* INPUT_1: thermostat */
+#define INP_CH_PROV     1U   /* INPUT_2: provider bi-énergie */
+#define INP_CH_MODEA    2U   /* INPUT_3: sélecteur, fil A */
+#define INP_CH_MODEB    3U   /* INPUT_4: sélecteur, fil B */
+#define INP_CH_MODEC    4U   /* INPUT_5: sélecteur, fil C */
+#define INP_CH_IN6      5U   /* INPUT_6: contact libre */
+#define INP_CH_IN7      6U   /* INPUT_7: contact libre */
+#define INP_CH_IN8      7U   /* INPUT_8: contact libre */
+#define INP_CH_COUNT    8U   /* INPUT_1..INPUT_8 */
+
+#define INP_BIT(ch)     (1UL << (ch))
+
+/* Sélecteurs N positions exclusives (un fil actif par position) */
+#ifndef INP_SEL_MAX
+#define INP_SEL_MAX     2U
+#endif
+#ifndef INP_SEL_MAX_POS
+#define INP_SEL_MAX_POS 4U
+#endif
+#define INP_SEL_NONE    0xFFU
+
+/* Descripteur d’une entrée (une ligne de table = une voie).
+   Les membres d’un sélecteur n’ont pas d’événements propres: c’est la
+   position décodée du sélecteur qui publie. */
+typedef struct {
+    uint8_t   ch;           /* voie INPUT_(ch+1), 0..INP_CH_COUNT-1 */
+    uint8_t   active_low;   /* 1: niveau logique = inverse du niveau électrique */
+    uint16_t  debounce_ms;  /* stabilité requise avant changement d’état */
+    EventType evt_rise;     /* poussé quand l’état logique passe à 1 (0 = aucun) */
+    EventType evt_fall;     /* poussé quand l’état logique passe à 0 (0 = aucun) */
+    uint8_t   sel;          /* index de sélecteur, ou INP_SEL_NONE */
+    uint8_t   pos;          /* position dans le sélecteur */
+    uint16_t  debounce_min_ms; /* bornes du debounce adaptatif; 0/0 = fenêtre fixe */
+    uint16_t  debounce_max_ms; /* (ignorées pour les membres d’un sélecteur) */
+    uint8_t   vote_n;       /* filtre k-parmi-n avant debounce: fenêtre (≤ 32), 0 = sans */
+    uint8_t   vote_k;       /* votes requis, N/2 < K ≤ N (modes POLL/DMA seulement) */
+} InpDesc;
+
+/* Sélecteur exclusif: événement publié pour chaque position.
+   Publié seulement si un seul fil est actif et que la position a changé. */
+typedef struct {
+    EventType evt[INP_SEL_MAX_POS];
+    uint8_t   npos;
+} InpSelector;
+
+/* Configuration = tables constantes (voir inputs_table.c) */
 typedef struct {
-    /* Vrai si l’entrée est active à 0 (pull-up + contact à la masse) */
-    uint8_t thermostat_active_low;
-    uint8_t provider_active_low;     /* 1: ELEC, 0: GAS (ou l’inverse, voir mapping) */
-    uint8_t modeA_active_low;        /* mode sélecteur: ELEGAS/BI: trois fils, un par position */
-    uint8_t modeB_active_low;
-    uint8_t modeC_active_low;
+    const InpDesc*     desc;
+    uint8_t            n_desc;
+    const InpSelector* sel;
+    uint8_t            n_sel;
 } InputsConfig;
 
-/* Initialisation: stocke la config, remet le debounce.
+/* Tables de la carte (inputs_table.c) */
+extern const InpDesc     INP_TABLE[];
+extern const uint8_t     INP_TABLE_COUNT;
+extern const InpSelector INP_SELECTORS[];
+extern const uint8_t     INP_SELECTORS_COUNT;
+
+/* Initialisation: compile les tables en masques/tableaux par voie, remet le debounce.
+   Les lignes invalides (voie hors bornes, durée trop longue) sont ignorées.
    Ne génère PAS d’événements. */
 void inputs_init(const InputsConfig* cfg);
 
-/* À appeler à chaque tick de INP_TICK_MS (ex: 10 ms).
-   Échantillonne, applique le debounce et pousse des événements:
-     - EVT_TH_ON / EVT_TH_OFF
-     - EVT_PROVIDER_TO_ELEC / EVT_PROVIDER_TO_GAS (après stabilité INP_PROVIDER_STABLE_MS)
-     - EVT_USER_MODE_ELEC / EVT_USER_MODE_GAS / EVT_USER_MODE_BI (après stabilité INP_MODE_STABLE_MS)
-*/
-void inputs_tick(void);
+/* Côté ISR, à appeler à chaque tick de INP_TICK_MS (mode POLL).
+   Capture seulement: un instantané, et une entrée horodatée dans la file
+   si le niveau a changé depuis le précédent. */
+void inputs_capture(void);
+
+/* Côté ISR (mode DMA): décime un bloc d’échantillons bruts (mot compacté, niveau
+   électrique non inversé), INP_OVERSAMPLE échantillons par tick de debounce, et
+   met les ticks en file comme inputs_capture(). Les sous-échantillons d’un tick
+   incomplet sont conservés pour le bloc suivant. Pur logiciel: testable sur hôte. */
+void inputs_process_block(const uint32_t* raw, uint32_t n);
+
+/* Boucle principale: rejoue les ticks capturés depuis le dernier appel (debounce,
+   stats, adaptation) et pousse les événements de la table. Aucun échantillon
+   n’est perdu tant que la file n’a pas débordé, quel que soit le retard. */
+void inputs_process(void);
+
+/* Débordements de la file d’instantanés: le changement est retenté au tick
+   suivant, il est donc daté un tick trop tard (0 en fonctionnement normal). */
+uint32_t inputs_snap_overruns(void);
+
+/* Mode EXTI: à appeler depuis l’ISR EXTI avec les voies qui ont bougé (INP_BIT(...)).
+   Ne fait que marquer les voies; les échéances sont armées par inputs_process(). */
+void inputs_on_edge(uint32_t ch_mask);
+
+/* Mode EXTI: à appeler par le dispatcher sur EVT_INP_SETTLE (arg.u8 = voie qui
+   porte l’échéance: la voie elle-même, ou la première voie d’un sélecteur;
+   now_ms = instant de l’échéance, sert aux durées d’impulsion).
+   Relit les entrées, met à jour l’état stable et pousse les événements. */
+void inputs_on_settle(uint8_t unit, uint32_t now_ms);
+
+/* Voies décrites par la table (INP_BIT(...)) */
+uint32_t inputs_used_mask(void);
+
+/* États logiques stables courants, un bit par voie */
+uint32_t inputs_stable(void);
+
+/* Statistiques de bruit par voie (télémétrie). Mises à jour dans la boucle
+   principale (inputs_process(), inputs_on_settle()), jamais en IRQ: la copie
+   faite depuis la boucle principale est cohérente. */
+typedef struct {
+    uint32_t glitches;      /* variations brutes retombées avant la fin du debounce (cumul) */
+    uint32_t pulse_min_ms;  /* plus courte durée entre deux changements stables (UINT32_MAX: aucune) */
+    uint32_t pulse_max_ms;  /* plus longue durée entre deux changements stables */
+    uint16_t debounce_ms;   /* fenêtre de debounce courante */
+} InpStats;
+
+/* Copie les stats de la voie ch. Retourne false si la voie n’est pas décrite. */
+bool inputs_get_stats(uint8_t ch, InpStats* out);
+
+/* Remet à zéro compteurs et durées (la fenêtre courante est conservée) */
+void inputs_reset_stats(void);
 
 /* Option: seed initial pour éviter un déluge d’événements au boot.
    Lit l’état matériel brut et le prend comme 'stable' sans pousser d’events. */
 void inputs_seed_from_hw(void);
 
-/* Hooks HARDWARE à fournir ailleurs: lecture niveau logique brut (0/1)
-   Ces fonctions DOIVENT être rapides et non bloquantes. */
-bool hw_read_thermostat_raw(void);
-bool hw_read_provider_raw(void);  /* ex: 1=ELEC, 0=GAS (ou l’inverse, selon ton câblage) */
-bool hw_read_modeA_raw(void);     /* sélecteur utilisateur (3 entrées exclusives) */
-bool hw_read_modeB_raw(void);
-bool hw_read_modeC_raw(void);
+/* Hook HARDWARE à fournir ailleurs: instantané brut de toutes les entrées,
+   un bit par voie (INP_BIT(INP_CH_x)), niveau électrique non inversé.
+   Doit être rapide, non bloquant, et cohérent (toutes les voies au même instant). */
+uint32_t hw_inputs_snapshot(void);
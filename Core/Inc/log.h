@@ -0,0 +1,89 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Journal tokenisé: aucune mise en forme sur la cible.
+   Chaque LOG_* range sa chaîne (fichier:ligne + format) dans la section .logstr,
+   jamais chargée en flash (INFO dans le script de liens): son adresse dans cette
+   section sert d’identifiant. À l’exécution, seuls l’identifiant, l’horodatage
+   et les arguments bruts (entiers 32 bits) sont copiés dans un anneau binaire
+   sans verrou; log_flush() les regroupe ensuite en trames de télémétrie
+   (TELEM_T_LOG). tools/log_decode.py reconstruit les messages à partir de la
+   table extraite de l’ELF au post-build (<projet>.logstr).
+
+   Arguments: entiers uniquement (%d %i %u %x %X %c, largeur/zéros permis);
+   pas de %s ni de flottants (mettre à l’échelle: %d en dixièmes, etc.). */
+
+/* Niveaux */
+#define LOG_LVL_ERR  0U
+#define LOG_LVL_WRN  1U
+#define LOG_LVL_INF  2U
+#define LOG_LVL_DBG  3U
+
+/* Niveau max compilé: les appels au-dessus disparaissent à la compilation */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LVL_INF
+#endif
+
+/* Arguments max par message */
+#ifndef LOG_MAX_ARGS
+#define LOG_MAX_ARGS 4U
+#endif
+
+/* Nombre d’entrées de l’anneau (puissance de 2) */
+#ifndef LOG_RING
+#define LOG_RING 32U
+#endif
+
+/* Trame TELEM_T_LOG: suite d’entrées, chacune
+   id (u32) | horodatage ms (u32) | niveau<<4 | nargs (u8) | args (u32 × nargs), petit-boutiste */
+
+#define LOG_XSTR_(x) LOG_STR_(x)
+#define LOG_STR_(x)  #x
+
+#define LOG_AT_(lvl, fmt, ...) do {                                                       \
+        __attribute__((section(".logstr"), used))                                          \
+        static const char log_str_[] = __FILE__ ":" LOG_XSTR_(__LINE__) "\x1f" fmt;        \
+        const uint32_t log_a_[] = { 0U, ##__VA_ARGS__ };                                   \
+        _Static_assert((sizeof(log_a_) / sizeof(log_a_[0])) <= (LOG_MAX_ARGS + 1U),        \
+                       "LOG: trop d’arguments");                                            \
+        log_write((lvl), (uint32_t)(uintptr_t)log_str_, &log_a_[1],                        \
+                  (uint8_t)((sizeof(log_a_) / sizeof(log_a_[0])) - 1U));                    \
+    } while (0)
+
+#if (LOG_LEVEL >= LOG_LVL_ERR)
+#define LOG_ERR(fmt, ...)  LOG_AT_(LOG_LVL_ERR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERR(fmt, ...)  do { } while (0)
+#endif
+#if (LOG_LEVEL >= LOG_LVL_WRN)
+#define LOG_WRN(fmt, ...)  LOG_AT_(LOG_LVL_WRN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WRN(fmt, ...)  do { } while (0)
+#endif
+#if (LOG_LEVEL >= LOG_LVL_INF)
+#define LOG_INF(fmt, ...)  LOG_AT_(LOG_LVL_INF, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INF(fmt, ...)  do { } while (0)
+#endif
+#if (LOG_LEVEL >= LOG_LVL_DBG)
+#define LOG_DBG(fmt, ...)  LOG_AT_(LOG_LVL_DBG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DBG(fmt, ...)  do { } while (0)
+#endif
+
+void log_init(void);
+
+/* Copie une entrée dans l’anneau (appelé par les macros). Tout contexte, sans
+   attente: anneau plein → entrée perdue et comptée. */
+void log_write(uint8_t lvl, uint32_t id, const uint32_t* args, uint8_t nargs);
+
+/* Regroupe les entrées prêtes en trames TELEM_T_LOG (boucle principale).
+   Télémétrie pleine: les entrées restent en place pour le prochain appel. */
+void log_flush(void);
+
+/* Entrées perdues depuis log_init() */
+uint32_t log_dropped(void);
+
+/* Hook à fournir ailleurs: horodatage en ms (ex: HAL_GetTick). Tout contexte. */
+uint32_t log_timestamp(void);
@@ -36,6 +36,24 @@ extern "C" {
 #include "events.h" 
 #include "timers.h"
 #include "fsm.h"
+#include "sched.h"
+#include "hw_outdrv_stm32.h"
+#include "outdrv.h"
+#include "tpo.h"
+#include "telem.h"
+#include "hw_telem_stm32.h"
+#include "log.h"
+#include "can_svc.h"
+#include "hw_can_stm32.h"
+#include "coord.h"
+#include "canbulk.h"
+#include "fwupd.h"
+#include "hw_fwupd_stm32.h"
+#include "console.h"
+#include "hw_console_stm32.h"
+#include "hil.h"
+#include "modbus.h"
+#include "hw_modbus_stm32.h"
 /* USER CODE END Includes */
 
 /* Exported types ------------------------------------------------------------*/
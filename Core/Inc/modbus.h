@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Esclave Modbus RTU (GTB).
+   Le backend découpe les trames au silence de ligne (timeout matériel du
+   récepteur, 3,5 caractères) et les livre par modbus_on_rx_frame() (ISR).
+   modbus_poll() (boucle principale, avant les événements) vérifie l’adresse
+   et le CRC, sert la requête et lance la réponse: la requête n’attend jamais
+   le traitement des événements du passage.
+   Fonctions: 03 (holding), 04 (input), 06 et 16 (écriture holding).
+   Les registres sont lus à la demande, directement dans la trame de réponse
+   (pas d’image mémoire copiée périodiquement), voir modbus_map.c. */
+
+#ifndef MB_SLAVE_ADDR
+#define MB_SLAVE_ADDR 1U
+#endif
+
+/* Trame RTU max (adresse + PDU 253 + CRC) */
+#define MB_ADU_MAX 256U
+
+/* Codes fonction */
+#define MB_FC_READ_HOLDING    0x03U
+#define MB_FC_READ_INPUT      0x04U
+#define MB_FC_WRITE_SINGLE    0x06U
+#define MB_FC_WRITE_MULTIPLE  0x10U
+
+/* Codes d’exception */
+#define MB_EX_ILLEGAL_FUNCTION  0x01U
+#define MB_EX_ILLEGAL_ADDRESS   0x02U
+#define MB_EX_ILLEGAL_VALUE     0x03U
+#define MB_EX_DEVICE_FAILURE    0x04U
+#define MB_EX_DEVICE_BUSY       0x06U
+
+/* Lecture d’un registre (ou d’une paire 32 bits, poids fort en premier) */
+typedef uint32_t (*MbReadFn)(void);
+/* Écriture d’un registre 16 bits. Retourne 0, ou le code d’exception:
+   MB_EX_ILLEGAL_VALUE (valeur refusée), MB_EX_DEVICE_BUSY (file pleine, à refaire) */
+typedef uint8_t (*MbWriteFn)(uint16_t value);
+
+/* Une ligne par registre (words = 1) ou par valeur 32 bits (words = 2).
+   Tables triées par adresse croissante, sans recouvrement. */
+typedef struct {
+    uint16_t  addr;
+    uint8_t   words;
+    MbReadFn  rd;
+    MbWriteFn wr;   /* NULL = lecture seule */
+} MbReg;
+
+/* Tables fournies par modbus_map.c */
+extern const MbReg   MB_INPUT_REGS[];
+extern const uint8_t MB_INPUT_REGS_COUNT;
+extern const MbReg   MB_HOLDING_REGS[];
+extern const uint8_t MB_HOLDING_REGS_COUNT;
+
+typedef struct {
+    uint32_t frames;       /* requêtes servies (diffusion comprise) */
+    uint32_t crc_errors;   /* trames au CRC faux */
+    uint32_t short_frames; /* trames trop courtes */
+    uint32_t other_addr;   /* trames pour un autre esclave */
+    uint32_t exceptions;   /* réponses d’exception */
+    uint32_t rx_overrun;   /* trame reçue avant la fin de la précédente */
+} MbStats;
+
+void modbus_init(void);
+
+/* Boucle principale: sert la trame reçue s’il y en a une. */
+void modbus_poll(void);
+
+void modbus_get_stats(MbStats* out);
+
+/* Côté backend (ISR): trame délimitée par le silence de ligne. La mémoire
+   reste au backend et n’est plus écrite jusqu’à hw_modbus_tx_start() ou
+   hw_modbus_rx_restart(). */
+void modbus_on_rx_frame(const uint8_t* adu, uint16_t len);
+
+/* Hooks HARDWARE à fournir ailleurs (hw_modbus_stm32.c) */
+uint16_t mb_crc16(const uint8_t* p, uint32_t n);        /* CRC Modbus (0xA001 réfléchi, init 0xFFFF) */
+void     hw_modbus_tx_start(const uint8_t* adu, uint16_t len); /* répond, puis réarme la réception */
+void     hw_modbus_rx_restart(void);                    /* pas de réponse: réarme la réception */
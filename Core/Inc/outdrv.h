@@ -0,0 +1,133 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "events.h"
+
+/* Driver de sorties sur SPI2: copie locale (shadow) des registres du circuit.
+   Le code applicatif écrit dans la copie voulue; seuls les registres dont la
+   valeur diffère de la dernière valeur réellement transmise partent sur le bus,
+   une trame par registre, sans jamais bloquer le dispatcher.
+   Chaîne (daisy-chain) de OUTDRV_CHAIN_LEN circuits sur le même CS: une trame
+   de chaîne = un mot 16 bits par circuit, même adresse pour tous, envoyés d’un
+   seul transfert DMA; l’état de chaque circuit revient dans le même transfert. */
+
+/* Nombre de circuits chaînés (circuit 0 = le premier après MOSI) */
+#ifndef OUTDRV_CHAIN_LEN
+#define OUTDRV_CHAIN_LEN 1U
+#endif
+
+/* Nombre de registres pilotés (adresses 0..OUTDRV_REG_COUNT-1, max 32: masque dirty) */
+#ifndef OUTDRV_REG_COUNT
+#define OUTDRV_REG_COUNT 8U
+#endif
+
+/* Registre de commande des sorties (bit n = sortie n) */
+#ifndef OUTDRV_REG_OUT
+#define OUTDRV_REG_OUT 1U
+#endif
+
+/* Format de trame 16 bits: [15]=0, [14]=R/W (1 = lecture), [13:8]=adresse, [7:0]=donnée */
+#ifndef OUTDRV_FRAME_WR
+#define OUTDRV_FRAME_WR(addr, data)  ((uint16_t)((((uint16_t)(addr) & 0x3FU) << 8) | ((uint16_t)(data) & 0xFFU)))
+#endif
+#ifndef OUTDRV_FRAME_RD
+#define OUTDRV_FRAME_RD(addr)        ((uint16_t)(0x4000U | (((uint16_t)(addr) & 0x3FU) << 8)))
+#endif
+
+/* Relecture full-duplex: chaque trame envoyée ramène en [15:8] l’octet d’état
+   du circuit, sans transaction supplémentaire. Bits décodés: */
+#ifndef OUTDRV_ST_OVERCURRENT
+#define OUTDRV_ST_OVERCURRENT  0x01U
+#endif
+#ifndef OUTDRV_ST_OPEN_LOAD
+#define OUTDRV_ST_OPEN_LOAD    0x02U
+#endif
+#ifndef OUTDRV_ST_THERMAL
+#define OUTDRV_ST_THERMAL      0x04U
+#endif
+#define OUTDRV_RX_STATUS(rx)   ((uint8_t)((uint16_t)(rx) >> 8))
+
+/* Registre relu quand aucune écriture n’est en attente (outdrv_request_diag) */
+#ifndef OUTDRV_REG_DIAG
+#define OUTDRV_REG_DIAG 0U
+#endif
+
+/* Période de rafraîchissement des diagnostics quand les sorties ne bougent pas (ms) */
+#ifndef OUTDRV_DIAG_PERIOD_MS
+#define OUTDRV_DIAG_PERIOD_MS 100U
+#endif
+
+/* Compteurs (télémétrie) */
+typedef struct {
+    uint32_t frames;        /* trames de chaîne transmises */
+    uint32_t skipped;       /* écritures sans effet (valeur déjà en place ou en file) */
+    uint32_t errors;        /* démarrages refusés ou transferts en erreur */
+} OutdrvStats;
+
+/* Mot d’un circuit dans une trame de chaîne: le premier mot envoyé traverse
+   toute la chaîne et finit dans le dernier circuit; le premier mot reçu vient
+   du dernier circuit (le plus proche de MISO). */
+#define OUTDRV_CHAIN_SLOT(dev)  ((uint32_t)OUTDRV_CHAIN_LEN - 1U - (uint32_t)(dev))
+
+/* Initialisation: tous les registres marqués à écrire (état des circuits inconnu
+   au boot), valeurs voulues à 0. Ne transmet rien: voir outdrv_flush(). */
+void outdrv_init(void);
+
+/* Valeur voulue d’un registre du circuit dev. Transmission lancée si nécessaire.
+   Retourne false si dev ou reg est hors bornes. */
+bool outdrv_dev_write(uint8_t dev, uint8_t reg, uint8_t val);
+
+/* Lecture-modification-écriture sur la copie voulue: (val & ~clr) | set */
+bool outdrv_dev_modify(uint8_t dev, uint8_t reg, uint8_t clr, uint8_t set);
+
+/* Valeur voulue courante (pas forcément encore transmise) */
+uint8_t outdrv_dev_get(uint8_t dev, uint8_t reg);
+
+/* Raccourcis sur le circuit 0 */
+static inline bool outdrv_write(uint8_t reg, uint8_t val) { return outdrv_dev_write(0U, reg, val); }
+static inline bool outdrv_modify(uint8_t reg, uint8_t clr, uint8_t set) { return outdrv_dev_modify(0U, reg, clr, set); }
+static inline uint8_t outdrv_get(uint8_t reg) { return outdrv_dev_get(0U, reg); }
+
+/* Lance la transmission des registres en attente si le bus est libre */
+void outdrv_flush(void);
+
+/* Vrai si aucun registre n’attend et qu’aucune trame n’est en cours */
+bool outdrv_idle(void);
+
+void outdrv_get_stats(OutdrvStats* out);
+
+/* Demande une trame de lecture si le bus n’a rien d’autre à faire: garde l’état
+   à jour quand les sorties ne changent pas. Appelable depuis une ISR (scheduler). */
+void outdrv_request_diag(void);
+
+/* Sources de coupure matérielle (outdrv_on_hw_trip) */
+#define OUTDRV_TRIP_FAULT  0x01U   /* broche FAULT du circuit */
+#define OUTDRV_TRIP_PGOOD  0x02U   /* perte de PGOOD: le circuit a pu perdre ses registres */
+
+/* À appeler par le backend depuis l’ISR de protection, sorties déjà coupées:
+   livre EVT_FAULT_OUT_DRIVER / EVT_FAULT_OUT_POWER via outdrv_pop_fault().
+   Sur PGOOD, tous les registres seront réécrits au prochain flush. */
+void outdrv_on_hw_trip(uint8_t src);
+
+/* Dernier octet d’état reçu du circuit dev */
+uint8_t outdrv_dev_status(uint8_t dev);
+static inline uint8_t outdrv_status(void) { return outdrv_dev_status(0U); }
+
+/* Défauts apparus depuis la dernière livraison (bit posé en fin de trame, ISR):
+   sort un EVT_FAULT_OUT_* par défaut, comme tmr_pop_expired(). Retourne false si aucun.
+   arg.u8 = octet d’état, arg.u16 = circuit (0 pour les coupures matérielles, communes à la chaîne). */
+bool outdrv_pop_fault(EventMsg* out);
+
+/* À appeler par le backend en fin de transfert (ISR), CS déjà relâché.
+   ok = false: la trame est reprogrammée. rx = OUTDRV_CHAIN_LEN mots reçus pendant
+   l’envoi, dans l’ordre du bus (octets d’état décodés ici, dans le temps d’une trame). */
+void outdrv_on_xfer_done(bool ok, const uint16_t* rx);
+
+/* Hooks HARDWARE à fournir ailleurs (hw_outdrv_stm32.c, ou un faux backend sur hôte):
+   - démarre l’envoi de n mots en un seul transfert en arrière-plan (CS actif jusqu’à
+     la fin: les circuits prennent leur mot au relâchement), retourne false si
+     impossible; la fin est signalée par outdrv_on_xfer_done(). tx reste valide
+     jusque-là.
+   - pilote la broche d’activation des sorties (commune à la chaîne). */
+bool hw_outdrv_xfer_start(const uint16_t* tx, uint32_t n);
+void hw_outdrv_enable(bool on);
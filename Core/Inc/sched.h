@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Période de base du scheduler (ms) = période de TIM6 (1 kHz) */
+#ifndef SCHED_TICK_MS
+#define SCHED_TICK_MS 1U
+#endif
+
+/* Nombre max de jobs périodiques enregistrés */
+#ifndef SCHED_MAX_JOBS
+#define SCHED_MAX_JOBS 8U
+#endif
+
+/* Trame de statistiques: les temps d’exécution sont relevés par slot
+   (tick % SCHED_FRAME_TICKS). Choisir les périodes comme diviseurs de la trame. */
+#ifndef SCHED_FRAME_TICKS
+#define SCHED_FRAME_TICKS 10U
+#endif
+
+/* Phase automatique: le scheduler choisit le décalage qui chevauche le moins
+   les jobs déjà enregistrés. */
+#define SCHED_PHASE_AUTO 0xFFFFU
+
+typedef void (*SchedJobFn)(void);
+
+/* Statistiques par job (en cycles CPU, voir hw_cycle_counter) */
+typedef struct {
+    uint32_t runs;
+    uint32_t last_cycles;
+    uint32_t max_cycles;
+} SchedJobStats;
+
+/* Initialisation: aucun job, stats à zéro. */
+void sched_init(void);
+
+/* Enregistre un job exécuté tous les period_ticks ticks, au tick où
+   (tick % period_ticks) == phase. Retourne l’id du job, ou -1 si refusé. */
+int8_t sched_add(SchedJobFn fn, uint16_t period_ticks, uint16_t phase);
+
+/* À appeler depuis l’ISR de TIM6 (HAL_TIM_PeriodElapsedCallback). */
+void sched_tick(void);
+
+/* Lecture des stats */
+bool     sched_get_job_stats(uint8_t job, SchedJobStats* out);
+uint32_t sched_slot_max_cycles(uint8_t slot);  /* pire durée totale observée du slot */
+uint32_t sched_worst_cycles(void);             /* pire durée d’un tick, tous slots */
+void     sched_reset_stats(void);
+
+/* Hook HARDWARE à fournir ailleurs: compteur de cycles libre 32 bits (ex: DWT->CYCCNT). */
+uint32_t hw_cycle_counter(void);
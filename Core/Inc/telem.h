@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Flux de télémétrie série, non bloquant.
+   Chaque trame est encodée dès l’envoi dans un slot d’un anneau sans verrou
+   (plusieurs producteurs, n’importe quel contexte: main, ISR), puis émise en
+   arrière-plan par le backend (DMA); les trames s’enchaînent depuis l’ISR de
+   fin d’émission. Anneau plein: la trame est perdue et comptée, jamais d’attente.
+
+   Format sur la ligne: COBS( type | seq | données | CRC16 ) puis 0x00.
+   CRC16-CCITT (poly 0x1021, init 0xFFFF) sur type..données, octet fort en tête.
+   seq = numéro de réservation (mod 256): un trou côté récepteur = trame perdue
+   en émission (les refus sur anneau plein ne prennent pas de numéro: dropped). */
+
+/* Nombre de slots (puissance de 2) */
+#ifndef TELEM_SLOTS
+#define TELEM_SLOTS 16U
+#endif
+
+/* Données max par trame (octets) */
+#ifndef TELEM_MAX_PAYLOAD
+#define TELEM_MAX_PAYLOAD 60U
+#endif
+
+/* Types de trames */
+#define TELEM_T_TEXT   0x01U   /* texte brut (stdout) */
+#define TELEM_T_LOG    0x02U   /* entrées de journal tokenisé (log.h) */
+#define TELEM_T_HIL    0x03U   /* réponses banc de test (hil.h) */
+
+typedef struct {
+    uint32_t frames;        /* trames émises */
+    uint32_t bytes;         /* octets émis (encodés, délimiteurs compris) */
+    uint32_t dropped;       /* anneau plein ou trame trop longue */
+    uint32_t errors;        /* démarrages refusés ou émissions en erreur */
+} TelemStats;
+
+/* Initialisation: anneau vide. */
+void telem_init(void);
+
+/* Encode et met en file une trame. Appelable depuis n’importe quel contexte.
+   Retourne false si len > TELEM_MAX_PAYLOAD ou si l’anneau est plein. */
+bool telem_send(uint8_t type, const void* data, uint16_t len);
+
+/* Texte de longueur quelconque, découpé en trames TELEM_T_TEXT.
+   Retourne le nombre d’octets acceptés. */
+uint32_t telem_write_text(const char* s, uint32_t len);
+
+/* CRC16-CCITT du format de ligne (aussi pour vérifier les trames reçues, hil.c) */
+uint16_t telem_crc16(const uint8_t* p, uint32_t n);
+
+/* Slots en attente ou en cours d’émission */
+uint32_t telem_pending(void);
+
+void telem_get_stats(TelemStats* out);
+
+/* À appeler par le backend en fin d’émission d’un slot (ISR). */
+void telem_on_tx_done(bool ok);
+
+/* Hook HARDWARE à fournir ailleurs (hw_telem_stm32.c): démarre l’émission de len
+   octets en arrière-plan, retourne false si impossible; la fin est signalée par
+   telem_on_tx_done(). buf reste valide jusque-là. */
+bool hw_telem_tx_start(const uint8_t* buf, uint16_t len);
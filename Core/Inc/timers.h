@@ -9,9 +9,9 @@
 #endif
 
 /* Nombre de timers logiciels disponibles.
-   Tu peux augmenter si tu en veux plus. */
+   Tu peux augmenter si tu en veux plus (max 32: bitmap d’expirations). */
 #ifndef TMR_COUNT
-#define TMR_COUNT 8U
+#define TMR_COUNT 18U
 #endif
 
 /* Identifiants de timers.
@@ -23,6 +23,10 @@ typedef enum {
     TMR_COOLDOWN_MIN,   /* ventilation minimale */
     TMR_MAX_BURNER,     /* sécurité */
     TMR_MAX_ELEMS,      /* sécurité */
+    TMR_INP_0,          /* entrées mode EXTI: échéance de stabilité de la voie n = TMR_INP_0 + n */
+    TMR_INP_LAST = TMR_INP_0 + 7,
+    TMR_TPO,            /* modulation des éléments: prochain front du planning */
+    TMR_COORD,          /* coordination CAN: diffusion périodique de l’état */
     TMR_USER_0,         /* libre */
     TMR_USER_1,         /* libre */
     /* ... jusqu’à TMR_COUNT-1 */
@@ -33,18 +37,35 @@ void tmr_init(void);
 
 /* Armer un timer one-shot.
    delay_ms sera arrondi à la granularité TMR_TICK_MS vers le haut.
-   À l’expiration: un événement (type/arg) est poussé sur EVQ_NORMAL. */
+   À l’expiration: le timer est marqué dans un bitmap d’expirations,
+   et l’événement (type/arg) est livré au dispatcher via tmr_pop_expired().
+   Réarmer un timer expiré mais pas encore livré annule l’ancienne expiration. */
 bool tmr_set(TimerId id, uint32_t delay_ms, EventType evt, EventArg arg);
 
+/* Variante avec tolérance: l’expiration peut être retardée d’au plus slack_ms
+   (jamais avancée) pour tomber sur le même tick qu’un autre timer actif, ou à défaut
+   sur une frontière commune (multiple de 2^n ticks ≤ slack). Les timers peu précis
+   (TMR_MIN_OFF, TMR_COOLDOWN_MIN...) expirent alors ensemble: moins de réveils/dispatchs.
+   slack_ms < TMR_TICK_MS ⇒ identique à tmr_set(). */
+bool tmr_set_slack(TimerId id, uint32_t delay_ms, uint32_t slack_ms, EventType evt, EventArg arg);
+
 /* Annuler un timer. */
 void tmr_cancel(TimerId id);
 
-/* Est-ce que le timer est actif ? */
+/* Est-ce que le timer est actif ? (vrai aussi si expiré mais pas encore livré) */
 bool tmr_is_active(TimerId id);
 
 /* Temps restant (ms) arrondi au multiple de TMR_TICK_MS. 0 si inactif. */
 uint32_t tmr_remaining_ms(TimerId id);
 
+/* Temps (ms) jusqu’à la prochaine expiration, tous timers confondus.
+   UINT32_MAX si aucun timer actif (utile pour dormir entre deux événements). */
+uint32_t tmr_next_expiry_ms(void);
+
 /* À appeler périodiquement toutes les TMR_TICK_MS (ex: depuis un ISR ou une tâche).
-   Décrémente, émet l’événement à 0, désarme. */
+   Décrémente, marque l’expiration à 0, désarme. Ne touche pas aux files d’événements. */
 void tmr_tick(void);
+
+/* Côté dispatcher: retire une expiration en attente et la rend sous forme d’EventMsg.
+   Retourne false si aucune. O(1), jamais de perte même si EVQ_NORMAL est pleine. */
+bool tmr_pop_expired(EventMsg* out);
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "events.h"
+
+/* Modulation temporelle (PWM lente) des éléments chauffants.
+   Un rapport cyclique par élément; le planning d’une période est calculé une
+   seule fois en début de période, puis appliqué par échéances du service timers
+   (un seul timer armé, sur le prochain front). Aucun travail entre deux fronts. */
+
+/* Nombre d’éléments modulés (max 32) */
+#ifndef TPO_CH_COUNT
+#define TPO_CH_COUNT 3U
+#endif
+
+/* Période de modulation (ms), multiple de TMR_TICK_MS */
+#ifndef TPO_PERIOD_MS
+#define TPO_PERIOD_MS 10000U
+#endif
+
+/* Impulsion minimale (ms): en dessous, l’élément reste coupé (ou reste
+   allumé toute la période si c’est le temps de coupure qui est trop court). */
+#ifndef TPO_MIN_PULSE_MS
+#define TPO_MIN_PULSE_MS 200U
+#endif
+
+/* Rapport cyclique en pour-mille */
+#define TPO_DUTY_MAX 1000U
+
+/* Initialisation: tout à 0 %, modulation arrêtée. */
+void tpo_init(void);
+
+/* Rapport cyclique d’un élément (0..TPO_DUTY_MAX), pris en compte à la période suivante.
+   Retourne false si ch ou duty hors bornes. */
+bool tpo_set_duty(uint8_t ch, uint16_t duty);
+
+/* Démarre une période immédiatement (applique les rapports courants). */
+void tpo_start(void);
+
+/* Arrête la modulation et coupe tous les éléments. */
+void tpo_stop(void);
+
+/* À appeler par le dispatcher sur EVT_TPO_EDGE (échéance TMR_TPO). */
+void tpo_on_edge(void);
+
+/* Masque des éléments actuellement commandés (bit n = élément n) */
+uint32_t tpo_outputs(void);
+
+/* Hook à fournir ailleurs: applique le masque des éléments allumés
+   (ex: outdrv_modify() sur le registre de commande). Contexte dispatcher. */
+void tpo_apply(uint32_t on_mask);
@@ -0,0 +1,39 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Debounce bit-parallèle à compteurs verticaux.
+   Jusqu’à 32 entrées par mot; le compteur de l’entrée n est éclaté sur les
+   plans cnt[k] (bit n du plan k = bit k du compteur). Un tick = quelques
+   AND/XOR par plan, quel que soit le nombre d’entrées. */
+
+/* Nombre de plans = largeur des compteurs (seuil max = 2^VDEB_BITS - 1 échantillons) */
+#ifndef VDEB_BITS
+#define VDEB_BITS 12U
+#endif
+
+#define VDEB_MAX_SAMPLES ((1UL << VDEB_BITS) - 1UL)
+
+typedef struct {
+    uint32_t stable;            /* niveaux stables, bit par entrée */
+    uint32_t mask;              /* entrées gérées */
+    uint32_t cnt[VDEB_BITS];    /* compteurs verticaux (échantillons != stable) */
+    uint32_t tgt[VDEB_BITS];    /* seuils par entrée, éclatés en plans */
+    uint32_t aborted;           /* dernier step: comptages interrompus (retour à l’état stable) */
+} VDeb;
+
+/* Init: aucune entrée stable à 1, seuils à 1 échantillon. */
+void vdeb_init(VDeb* d, uint32_t mask);
+
+/* Seuil (en échantillons) pour un groupe d’entrées. Retourne false si hors bornes.
+   Les comptages en cours du groupe repartent à zéro (un compteur déjà au-delà
+   d’un seuil abaissé ne l’atteindrait plus). */
+bool vdeb_set_threshold(VDeb* d, uint32_t group_mask, uint32_t samples);
+
+/* Prend 'level' comme état stable (seed au boot), compteurs à zéro. */
+void vdeb_seed(VDeb* d, uint32_t level);
+
+/* Un échantillon: retourne le masque des entrées dont l’état stable vient de basculer.
+   Une entrée bascule après 'seuil' échantillons consécutifs différents de son état stable.
+   d->aborted reçoit les entrées qui comptaient et sont revenues à l’état stable (parasites). */
+uint32_t vdeb_step(VDeb* d, uint32_t level);
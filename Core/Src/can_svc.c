@@ -0,0 +1,143 @@
+#include "can_svc.h"
+#include <string.h>
+#include <stdatomic.h>
+
+_Static_assert((CAN_POOL_SIZE >= 2U) && (CAN_POOL_SIZE <= 32U), "CAN_POOL_SIZE hors bornes (2..32)");
+_Static_assert((CAN_POOL_SIZE & (CAN_POOL_SIZE - 1U)) == 0U, "CAN_POOL_SIZE doit être une puissance de 2");
+
+#define ALL_FREE  ((CAN_POOL_SIZE == 32U) ? UINT32_MAX : ((1UL << CAN_POOL_SIZE) - 1UL))
+
+static CanMsg g_pool[CAN_POOL_SIZE];
+
+/* Messages libres: bit i = g_pool[i]. Pris par l’ISR, rendus par la boucle principale. */
+static atomic_uint_least32_t g_free;
+
+/* Handles publiés, ISR → boucle principale (un producteur, un consommateur).
+   Jamais plus de CAN_POOL_SIZE handles en circulation: la file ne peut pas déborder. */
+static uint8_t g_ready[CAN_POOL_SIZE];
+static atomic_uint_least32_t g_ready_head;   /* écrit par l’ISR */
+static atomic_uint_least32_t g_ready_tail;   /* écrit par la boucle principale */
+
+/* Message livré par le dernier can_pop_rx(), rendu au suivant */
+static uint8_t g_held;
+
+/* sent / tx_full: boucle principale; compteurs de réception: ISR, atomiques */
+static CanStats g_stats;
+static atomic_uint_least32_t g_hw_lost;
+static atomic_uint_least32_t g_received;
+static atomic_uint_least32_t g_pool_empty;
+
+void can_init(void)
+{
+    (void)memset(g_pool, 0, sizeof(g_pool));
+    (void)memset(&g_stats, 0, sizeof(g_stats));
+    atomic_store_explicit(&g_free, ALL_FREE, memory_order_relaxed);
+    atomic_store_explicit(&g_ready_head, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_ready_tail, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_hw_lost, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_received, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_pool_empty, 0U, memory_order_relaxed);
+    g_held = CAN_HANDLE_NONE;
+}
+
+CanMsg* can_rx_alloc(void)
+{
+    uint32_t free = atomic_load_explicit(&g_free, memory_order_acquire);
+    while (free != 0U) {
+        const uint32_t i = (uint32_t)__builtin_ctz(free);
+        if (atomic_compare_exchange_weak_explicit(&g_free, &free, free & ~(1UL << i),
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            return &g_pool[i];
+        }
+    }
+    (void)atomic_fetch_add_explicit(&g_pool_empty, 1U, memory_order_relaxed);
+    return NULL;
+}
+
+void can_rx_free(CanMsg* m)
+{
+    (void)atomic_fetch_or_explicit(&g_free, 1UL << (uint32_t)(m - g_pool), memory_order_release);
+}
+
+void can_rx_commit(CanMsg* m)
+{
+    const uint32_t head = atomic_load_explicit(&g_ready_head, memory_order_relaxed);
+    g_ready[head & (CAN_POOL_SIZE - 1U)] = (uint8_t)(m - g_pool);
+    atomic_store_explicit(&g_ready_head, head + 1U, memory_order_release);
+    (void)atomic_fetch_add_explicit(&g_received, 1U, memory_order_relaxed);
+}
+
+void can_note_hw_lost(uint32_t n)
+{
+    (void)atomic_fetch_add_explicit(&g_hw_lost, n, memory_order_relaxed);
+}
+
+bool can_pop_rx(EventMsg* out)
+{
+    if (out == NULL) { return false; }
+
+    /* Le message précédent a été traité: retour au pool */
+    if (g_held != CAN_HANDLE_NONE) {
+        (void)atomic_fetch_or_explicit(&g_free, 1UL << g_held, memory_order_release);
+        g_held = CAN_HANDLE_NONE;
+    }
+
+    const uint32_t tail = atomic_load_explicit(&g_ready_tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&g_ready_head, memory_order_acquire)) { return false; }
+
+    const uint8_t h = g_ready[tail & (CAN_POOL_SIZE - 1U)];
+    atomic_store_explicit(&g_ready_tail, tail + 1U, memory_order_release);
+    g_held = h;
+
+    const uint8_t row = g_pool[h].row;
+    out->type = (row < CAN_RX_TABLE_COUNT) ? CAN_RX_TABLE[row].evt : EVT_CAN_RX;
+    out->arg.u8  = h;
+    out->arg.u16 = row;
+    out->tick = 0U;
+    return true;
+}
+
+const CanMsg* can_msg(uint8_t handle)
+{
+    return (handle < CAN_POOL_SIZE) ? &g_pool[handle] : NULL;
+}
+
+static bool send(uint32_t id, bool ext, const uint8_t* data, uint8_t len, bool fd)
+{
+    if ((data == NULL) && (len != 0U)) { return false; }
+    if (!hw_can_send(id, ext, data, len, fd)) {
+        g_stats.tx_full++;
+        return false;
+    }
+    g_stats.sent++;
+    return true;
+}
+
+bool can_send(uint32_t id, bool ext, const uint8_t* data, uint8_t len)
+{
+    return (len <= 8U) && send(id, ext, data, len, false);
+}
+
+bool can_send_fd(uint32_t id, bool ext, const uint8_t* data, uint8_t len)
+{
+#if CAN_FD
+    return (len <= CAN_MAX_DATA) && send(id, ext, data, len, true);
+#else
+    (void)id; (void)ext; (void)data; (void)len;
+    return false;
+#endif
+}
+
+uint8_t can_tx_free(void)
+{
+    return hw_can_tx_free();
+}
+
+void can_get_stats(CanStats* out)
+{
+    if (out == NULL) { return; }
+    *out = g_stats;
+    out->received = atomic_load_explicit(&g_received, memory_order_relaxed);
+    out->pool_empty = atomic_load_explicit(&g_pool_empty, memory_order_relaxed);
+    out->hw_lost = atomic_load_explicit(&g_hw_lost, memory_order_relaxed);
+}
@@ -0,0 +1,15 @@
+#include "can_svc.h"
+#include "coord.h"
+#include "canbulk.h"
+#include "fwupd.h"
+
+/* Une ligne par famille de trames acceptée. Ajouter une trame = ajouter une ligne;
+   le backend en fait un filtre matériel (28 standards / 8 étendus max). */
+const CanRxDesc CAN_RX_TABLE[] = {
+    /* identifiant   masque      étendu  FIFO  événement */
+    { 0x100U,        0x7F0U,     false,  0U,   EVT_CAN_RX },   /* supervision: 0x100..0x10F */
+    { COORD_CAN_ID_BASE, COORD_CAN_ID_MASK, false, 1U, EVT_COORD_RX }, /* états des autres unités */
+    { CANBULK_ID_CMD + COORD_NODE_ID, 0x7FFU, false, 0U, EVT_CANBULK_RX }, /* outil de maintenance */
+    { FWUPD_ID_CMD + COORD_NODE_ID,   0x7FFU, false, 0U, EVT_FWUPD_RX },   /* mise à jour firmware */
+};
+const uint8_t CAN_RX_TABLE_COUNT = (uint8_t)(sizeof(CAN_RX_TABLE) / sizeof(CAN_RX_TABLE[0]));
@@ -0,0 +1,167 @@
+#include "canbulk.h"
+#include <string.h>
+
+/* Sans CAN FD: segments classiques de 6 octets, même protocole (lent) */
+#if CAN_FD
+#define SEND_DATA can_send_fd
+#else
+#define SEND_DATA can_send
+#endif
+
+_Static_assert((CANBULK_MAX_WINDOW >= 1U) && (CANBULK_MAX_WINDOW <= 255U), "CANBULK_MAX_WINDOW hors bornes");
+
+typedef struct {
+    bool     active;
+    uint8_t  obj;
+    uint32_t size;
+    uint16_t nseg;
+    uint16_t acked;      /* segments reçus par l’outil: [0, acked) */
+    uint16_t next;       /* prochain segment à émettre */
+    uint16_t high;       /* segments émis au moins une fois: [0, high) */
+    uint8_t  window;     /* accordée par l’outil */
+    uint8_t  retries;
+    uint32_t ack_ms;     /* dernier progrès (ou début de vol) */
+    uint32_t rx_ms;      /* dernière trame de l’outil */
+} BulkTx;
+
+static BulkTx       g_tx;
+static CanBulkStats g_stats;
+
+static void put16(uint8_t* p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | ((uint16_t)p[1] << 8)); }
+
+static void send_ctrl(uint8_t op, uint8_t a, uint8_t b)
+{
+    uint8_t f[8] = { op, g_tx.obj, a, b, 0U, 0U, 0U, 0U };
+    (void)can_send(CANBULK_ID_CTRL + COORD_NODE_ID, false, f, 8U);   /* FIFO pleine: l’outil relance */
+}
+
+static void stop(bool aborted)
+{
+    if (aborted) { g_stats.aborted++; }
+    g_tx.active = false;
+}
+
+static void tx_open(uint8_t obj, uint8_t window, uint32_t now)
+{
+    if (g_tx.active) { stop(true); }
+    g_tx.obj = obj;
+    if (obj >= CANBULK_OBJS_COUNT) { send_ctrl(CANBULK_OP_ERR, CANBULK_ERR_OBJECT, 0U); return; }
+
+    const uint32_t size = CANBULK_OBJS[obj].size();
+    const uint32_t nseg = (size + CANBULK_SEG_DATA - 1U) / CANBULK_SEG_DATA;
+    if (nseg > 0xFFFFU) { send_ctrl(CANBULK_OP_ERR, CANBULK_ERR_SIZE, 0U); return; }
+
+    uint8_t f[8] = { CANBULK_OP_INFO, obj, 0U, 0U, 0U, 0U, 0U, 0U };
+    put16(&f[2], size);
+    put16(&f[4], size >> 16);
+    put16(&f[6], nseg);
+    (void)can_send(CANBULK_ID_CTRL + COORD_NODE_ID, false, f, 8U);
+
+    g_tx.size = size;
+    g_tx.nseg = (uint16_t)nseg;
+    g_tx.acked = 0U;
+    g_tx.next = 0U;
+    g_tx.high = 0U;
+    g_tx.window = (window > CANBULK_MAX_WINDOW) ? (uint8_t)CANBULK_MAX_WINDOW : window;
+    g_tx.retries = 0U;
+    g_tx.ack_ms = now;
+    g_tx.rx_ms = now;
+    g_tx.active = true;
+    if (nseg == 0U) { send_ctrl(CANBULK_OP_DONE, 0U, 0U); g_stats.transfers++; stop(false); }
+}
+
+/* ACK/NAK: progrès cumulatif, fenêtre, retour arrière sur NAK */
+static void ack(uint16_t next, uint8_t window, bool nak, uint32_t now)
+{
+    if ((next > g_tx.high) || (next < g_tx.acked)) { return; }   /* incohérent ou périmé */
+    if (next > g_tx.acked) {
+        g_tx.acked = next;
+        g_tx.retries = 0U;
+        g_tx.ack_ms = now;
+        if (g_tx.next < next) { g_tx.next = next; }   /* acquittement tardif après un retour arrière */
+    }
+    g_tx.window = (window > CANBULK_MAX_WINDOW) ? (uint8_t)CANBULK_MAX_WINDOW : window;
+    if (g_tx.acked == g_tx.nseg) {
+        send_ctrl(CANBULK_OP_DONE, 0U, 0U);
+        g_stats.transfers++;
+        stop(false);
+        return;
+    }
+    if (nak && (g_tx.next != g_tx.acked)) {
+        g_tx.next = g_tx.acked;
+        g_stats.retransmits++;
+    }
+}
+
+void canbulk_init(void)
+{
+    (void)memset(&g_tx, 0, sizeof(g_tx));
+    (void)memset(&g_stats, 0, sizeof(g_stats));
+}
+
+void canbulk_on_rx(const CanMsg* m)
+{
+    if ((m == NULL) || (m->len < 1U)) { return; }
+    const uint32_t now = canbulk_now_ms();
+    const uint8_t* d = m->data;
+
+    switch (d[0]) {
+    case CANBULK_OP_OPEN:
+        if (m->len >= 3U) { tx_open(d[1], d[2], now); }
+        break;
+    case CANBULK_OP_ACK:
+    case CANBULK_OP_NAK:
+        if (g_tx.active && (m->len >= 4U)) {
+            g_tx.rx_ms = now;
+            ack(get16(&d[1]), d[3], d[0] == CANBULK_OP_NAK, now);
+        }
+        break;
+    case CANBULK_OP_ABORT:
+        if (g_tx.active) { stop(true); }
+        break;
+    default:
+        break;
+    }
+}
+
+void canbulk_poll(void)
+{
+    if (!g_tx.active) { return; }
+    const uint32_t now = canbulk_now_ms();
+
+    if ((now - g_tx.rx_ms) >= CANBULK_IDLE_MS) { stop(true); return; }
+
+    /* Segments en vol sans progrès: on repart du premier non acquitté */
+    if ((g_tx.next != g_tx.acked) && ((now - g_tx.ack_ms) >= CANBULK_ACK_TIMEOUT_MS)) {
+        if (++g_tx.retries > CANBULK_MAX_RETRY) {
+            send_ctrl(CANBULK_OP_ERR, CANBULK_ERR_TIMEOUT, 0U);
+            stop(true);
+            return;
+        }
+        g_tx.next = g_tx.acked;
+        g_tx.ack_ms = now;
+        g_stats.retransmits++;
+    }
+
+    /* Remplit la fenêtre tant que la FIFO garde une place au trafic de commande */
+    while ((g_tx.next < g_tx.nseg) && ((uint32_t)g_tx.next < ((uint32_t)g_tx.acked + g_tx.window))
+           && (can_tx_free() > 1U)) {
+        uint8_t f[CAN_MAX_DATA];
+        const uint32_t off = (uint32_t)g_tx.next * CANBULK_SEG_DATA;
+        const uint32_t n = ((g_tx.size - off) < CANBULK_SEG_DATA) ? (g_tx.size - off) : CANBULK_SEG_DATA;
+        put16(f, g_tx.next);
+        CANBULK_OBJS[g_tx.obj].read(off, &f[2], n);
+        if (!SEND_DATA(CANBULK_ID_DATA + COORD_NODE_ID, false, f, (uint8_t)(2U + n))) { break; }
+        if (g_tx.next == g_tx.acked) { g_tx.ack_ms = now; }   /* début de vol: le délai court d’ici */
+        g_tx.next++;
+        if (g_tx.next > g_tx.high) { g_tx.high = g_tx.next; }
+        g_stats.segments++;
+    }
+}
+
+void canbulk_get_stats(CanBulkStats* out)
+{
+    if (out == NULL) { return; }
+    *out = g_stats;
+}
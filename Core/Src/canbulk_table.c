@@ -0,0 +1,104 @@
+#include "canbulk.h"
+#include "stm32h5xx_hal.h"
+#include "events.h"
+#include "fsm.h"
+#include "tpo.h"
+#include "inputs.h"
+#include "outdrv.h"
+#include "telem.h"
+#include "log.h"
+#include "hw_outdrv_stm32.h"
+#include <string.h>
+
+/* Objets transférables par canbulk (numéro = index). Ajouter un objet = une
+   fonction de taille + une fonction de lecture + une ligne.
+   Par défaut, seul l’instantané de diagnostic est exposé: le bus est partagé
+   par l’installation, la mémoire de l’unité n’y est pas publiée. */
+
+/* 0: instantané de diagnostic, figé à l’ouverture (size() n’est appelé qu’au
+   OPEN): états et compteurs publiés par les modules, rien d’autre.
+   Mots 32 bits petit-boutistes, dans l’ordre des champs. */
+#define CANBULK_DIAG_VERSION 1U
+
+typedef struct {
+    uint32_t     version;                       /* CANBULK_DIAG_VERSION */
+    uint32_t     at_ms;
+    uint32_t     fsm_state;
+    uint32_t     stages;
+    uint32_t     tpo_out;
+    uint32_t     inputs;                        /* inputs_stable() */
+    EvQueueStats evq[2];                        /* EVQ_NORMAL, EVQ_FAULTS */
+    CanStats     can;
+    OutdrvStats  outdrv;
+    TelemStats   telem;
+    uint32_t     log_dropped;
+    uint32_t     snap_overruns;
+    uint32_t     trip_count;                    /* 0: aucune coupure latchée */
+    uint32_t     trip_source;
+    uint32_t     trip_isr_cycles;               /* entrée ISR → EN bas, sans le délai front → ISR */
+    uint32_t     trip_glitches;                 /* ISR de protection sans défaut */
+    uint32_t     inp_glitches[INP_CH_COUNT];    /* UINT32_MAX: voie non décrite */
+    uint32_t     inp_debounce_ms[INP_CH_COUNT];
+} CanBulkDiag;
+
+_Static_assert((sizeof(CanBulkDiag) % 4U) == 0U, "CanBulkDiag: mots 32 bits uniquement");
+
+static CanBulkDiag g_diag;
+
+static uint32_t diag_size(void)
+{
+    OutdrvTrip t;
+    InpStats in;
+
+    (void)memset(&g_diag, 0, sizeof(g_diag));
+    g_diag.version = CANBULK_DIAG_VERSION;
+    g_diag.at_ms = HAL_GetTick();
+    g_diag.fsm_state = (uint32_t)fsm_state();
+    g_diag.stages = fsm_stages();
+    g_diag.tpo_out = tpo_outputs();
+    g_diag.inputs = inputs_stable();
+    evq_get_stats(EVQ_NORMAL, &g_diag.evq[0]);
+    evq_get_stats(EVQ_FAULTS, &g_diag.evq[1]);
+    can_get_stats(&g_diag.can);
+    outdrv_get_stats(&g_diag.outdrv);
+    telem_get_stats(&g_diag.telem);
+    g_diag.log_dropped = log_dropped();
+    g_diag.snap_overruns = inputs_snap_overruns();
+    if (hw_outdrv_get_trip(&t)) {
+        g_diag.trip_count = t.count;
+        g_diag.trip_source = t.source;
+        g_diag.trip_isr_cycles = t.isr_cycles;
+    }
+    g_diag.trip_glitches = hw_outdrv_trip_glitches();
+    for (uint8_t ch = 0U; ch < INP_CH_COUNT; ch++) {
+        if (inputs_get_stats(ch, &in)) {
+            g_diag.inp_glitches[ch] = in.glitches;
+            g_diag.inp_debounce_ms[ch] = in.debounce_ms;
+        } else {
+            g_diag.inp_glitches[ch] = UINT32_MAX;
+        }
+    }
+    return sizeof(g_diag);
+}
+
+static void diag_read(uint32_t off, uint8_t* dst, uint32_t n) { (void)memcpy(dst, (const uint8_t*)&g_diag + off, n); }
+
+#if CANBULK_FULL_DUMP
+/* 1: RAM entière (SRAM1 + SRAM2 contiguës), lue en marche: vidage post-mortem
+   des états, journaux et compteurs */
+static uint32_t ram_size(void) { return SRAM1_SIZE + SRAM2_SIZE; }
+static void ram_read(uint32_t off, uint8_t* dst, uint32_t n) { (void)memcpy(dst, (const uint8_t*)SRAM1_BASE + off, n); }
+
+/* 2: flash (image programmée), contrôle de l’image en service */
+static uint32_t flash_size(void) { return FLASH_SIZE; }
+static void flash_read(uint32_t off, uint8_t* dst, uint32_t n) { (void)memcpy(dst, (const uint8_t*)FLASH_BASE + off, n); }
+#endif
+
+const CanBulkObj CANBULK_OBJS[] = {
+    { diag_size,  diag_read },
+#if CANBULK_FULL_DUMP
+    { ram_size,   ram_read },
+    { flash_size, flash_read },
+#endif
+};
+const uint8_t CANBULK_OBJS_COUNT = (uint8_t)(sizeof(CANBULK_OBJS) / sizeof(CANBULK_OBJS[0]));
@@ -0,0 +1,242 @@
+#include "console.h"
+#include "telem.h"
+#include "hil.h"
+#include <string.h>
+#include <stdatomic.h>
+
+_Static_assert((CON_RX_RING >= 16U) && ((CON_RX_RING & (CON_RX_RING - 1U)) == 0U),
+               "CON_RX_RING doit être une puissance de 2");
+
+/* Table de hachage des commandes (adressage ouvert): sans collision pour le jeu
+   actuel, une seule comparaison de chaîne par ligne. */
+#define CON_HASH_SIZE  16U
+#define CON_SLOT_NONE  0xFFU
+_Static_assert((CON_HASH_SIZE & (CON_HASH_SIZE - 1U)) == 0U, "CON_HASH_SIZE: puissance de 2");
+
+static uint8_t g_slot[CON_HASH_SIZE];
+
+/* Anneau ISR → boucle principale (un producteur, un consommateur) */
+static uint8_t g_rx[CON_RX_RING];
+static atomic_uint_least32_t g_rx_head;   /* écrit par l’ISR */
+static atomic_uint_least32_t g_rx_tail;   /* écrit par la boucle principale */
+static atomic_uint_least32_t g_rx_overrun;
+
+/* Ligne en cours */
+static char    g_line[CON_LINE_MAX + 1U];
+static uint8_t g_len;
+static bool    g_discard;   /* ligne trop longue: ignorée jusqu’à la fin */
+static bool    g_bin;       /* entre deux 0x00: trame binaire (hil.h), pas du texte */
+
+/* Réponse en cours */
+static char    g_out[TELEM_MAX_PAYLOAD];
+static uint8_t g_out_len;
+
+static ConStats g_stats;
+
+/* h = longueur + premier caractère + 10 × dernier (choisi sans collision pour CON_CMDS) */
+static uint32_t cmd_hash(const char* s, uint32_t len)
+{
+    return (len + (uint8_t)s[0] + (10U * (uint8_t)s[len - 1U])) & (CON_HASH_SIZE - 1U);
+}
+
+void console_init(void)
+{
+    (void)memset(g_slot, CON_SLOT_NONE, sizeof(g_slot));
+    for (uint8_t i = 0U; (i < CON_CMDS_COUNT) && (i < CON_HASH_SIZE); i++) {
+        uint32_t h = cmd_hash(CON_CMDS[i].name, (uint32_t)strlen(CON_CMDS[i].name));
+        while (g_slot[h] != CON_SLOT_NONE) { h = (h + 1U) & (CON_HASH_SIZE - 1U); }   /* collision: sonde */
+        g_slot[h] = i;
+    }
+    atomic_store_explicit(&g_rx_head, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_rx_tail, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_rx_overrun, 0U, memory_order_relaxed);
+    (void)memset(&g_stats, 0, sizeof(g_stats));
+    g_len = 0U;
+    g_discard = false;
+    g_bin = false;
+    g_out_len = 0U;
+}
+
+void console_rx_bytes(const uint8_t* p, uint32_t n)
+{
+    uint32_t head = atomic_load_explicit(&g_rx_head, memory_order_relaxed);
+    const uint32_t tail = atomic_load_explicit(&g_rx_tail, memory_order_acquire);
+    for (uint32_t i = 0U; i < n; i++) {
+        if ((head - tail) >= CON_RX_RING) {
+            (void)atomic_fetch_add_explicit(&g_rx_overrun, n - i, memory_order_relaxed);
+            break;
+        }
+        g_rx[head & (CON_RX_RING - 1U)] = p[i];
+        head++;
+    }
+    atomic_store_explicit(&g_rx_head, head, memory_order_release);
+}
+
+/* ---- Réponses ---- */
+
+static void out_char(char c)
+{
+    if (g_out_len >= sizeof(g_out)) { con_endl(); }   /* ligne longue: part en plusieurs trames */
+    g_out[g_out_len++] = c;
+}
+
+void con_puts(const char* s)
+{
+    while (*s != '\0') { out_char(*s++); }
+}
+
+void con_putu(uint32_t v)
+{
+    char d[10];
+    uint32_t n = 0U;
+    do { d[n++] = (char)('0' + (v % 10U)); v /= 10U; } while (v != 0U);
+    while (n != 0U) { out_char(d[--n]); }
+}
+
+void con_puti(int32_t v)
+{
+    if (v < 0) { out_char('-'); con_putu((uint32_t)0U - (uint32_t)v); }
+    else       { con_putu((uint32_t)v); }
+}
+
+void con_putx(uint32_t v, uint8_t digits)
+{
+    static const char HEX[] = "0123456789abcdef";
+    if ((digits == 0U) || (digits > 8U)) { digits = 8U; }
+    for (int32_t i = (int32_t)digits - 1; i >= 0; i--) { out_char(HEX[(v >> (4U * (uint32_t)i)) & 0x0FU]); }
+}
+
+void con_endl(void)
+{
+    if (g_out_len < sizeof(g_out)) { g_out[g_out_len++] = '\n'; }
+    (void)telem_write_text(g_out, g_out_len);   /* télémétrie pleine: réponse perdue, jamais d’attente */
+    g_out_len = 0U;
+}
+
+bool con_parse_u32(const char* s, uint32_t* out)
+{
+    uint32_t v = 0U;
+    uint32_t base = 10U;
+    if ((s[0] == '0') && ((s[1] == 'x') || (s[1] == 'X'))) { base = 16U; s += 2; }
+    if (*s == '\0') { return false; }
+    for (; *s != '\0'; s++) {
+        uint32_t d;
+        if ((*s >= '0') && (*s <= '9'))                      { d = (uint32_t)(*s - '0'); }
+        else if ((base == 16U) && (*s >= 'a') && (*s <= 'f')) { d = (uint32_t)(*s - 'a') + 10U; }
+        else if ((base == 16U) && (*s >= 'A') && (*s <= 'F')) { d = (uint32_t)(*s - 'A') + 10U; }
+        else { return false; }
+        if (v > ((UINT32_MAX - d) / base)) { return false; }
+        v = (v * base) + d;
+    }
+    *out = v;
+    return true;
+}
+
+/* ---- Exécution ---- */
+
+static const ConCmd* lookup(const char* name)
+{
+    const uint32_t len = (uint32_t)strlen(name);
+    uint32_t h = cmd_hash(name, len);
+    for (uint32_t probe = 0U; probe < CON_HASH_SIZE; probe++) {
+        const uint8_t i = g_slot[h];
+        if (i == CON_SLOT_NONE) { return NULL; }
+        if (strcmp(CON_CMDS[i].name, name) == 0) { return &CON_CMDS[i]; }
+        h = (h + 1U) & (CON_HASH_SIZE - 1U);
+    }
+    return NULL;
+}
+
+/* Découpe en place sur les espaces: argv pointe dans g_line */
+static void exec_line(void)
+{
+    char* argv[CON_MAX_ARGS];
+    uint8_t argc = 0U;
+    char* p = g_line;
+
+    g_line[g_len] = '\0';
+    while ((*p != '\0') && (argc < CON_MAX_ARGS)) {
+        while (*p == ' ') { p++; }
+        if (*p == '\0') { break; }
+        argv[argc++] = p;
+        while ((*p != ' ') && (*p != '\0')) { p++; }
+        if (*p == ' ') { *p++ = '\0'; }
+    }
+    if (argc == 0U) { return; }
+
+    const ConCmd* c = lookup(argv[0]);
+    if (c == NULL) {
+        g_stats.unknown++;
+        con_puts("? "); con_puts(argv[0]); con_puts(" (help)"); con_endl();
+        return;
+    }
+    if ((uint8_t)(argc - 1U) < c->min_args) {
+        con_puts("usage: "); con_puts(c->help); con_endl();
+        return;
+    }
+    g_stats.lines++;
+    c->fn(argc, argv);
+}
+
+void console_poll(void)
+{
+    hw_console_rx_kick();
+
+    uint32_t tail = atomic_load_explicit(&g_rx_tail, memory_order_relaxed);
+    const uint32_t head = atomic_load_explicit(&g_rx_head, memory_order_acquire);
+
+    for (uint32_t budget = CON_POLL_BUDGET; (budget != 0U) && (tail != head); budget--) {
+        const uint8_t ch = g_rx[tail & (CON_RX_RING - 1U)];
+        tail++;
+
+        if (ch == 0U) {
+            /* Délimiteur: ouvre une trame binaire, ou ferme celle en cours */
+            if (g_bin && ((g_len != 0U) || g_discard)) {
+                if (!g_discard) {
+                    atomic_store_explicit(&g_rx_tail, tail, memory_order_release);
+                    hil_on_frame((const uint8_t*)g_line, g_len);
+                }
+                g_bin = false;
+            } else {
+                g_bin = true;
+            }
+            g_len = 0U;
+            g_discard = false;
+        } else if (g_bin) {
+            if (g_discard) {
+                /* reste d’une trame trop longue */
+            } else if (g_len >= CON_LINE_MAX) {
+                g_stats.too_long++;
+                g_discard = true;
+            } else {
+                g_line[g_len++] = (char)ch;
+            }
+        } else if ((ch == (uint8_t)'\r') || (ch == (uint8_t)'\n')) {
+            if (!g_discard && (g_len != 0U)) {
+                atomic_store_explicit(&g_rx_tail, tail, memory_order_release);   /* libère l’anneau avant d’exécuter */
+                exec_line();
+            }
+            g_len = 0U;
+            g_discard = false;
+        } else if ((ch == 0x08U) || (ch == 0x7FU)) {
+            if (g_len != 0U) { g_len--; }
+        } else if ((ch < 0x20U) || (ch > 0x7EU)) {
+            g_stats.noise++;
+        } else if (g_discard) {
+            /* reste d’une ligne trop longue */
+        } else if (g_len >= CON_LINE_MAX) {
+            g_stats.too_long++;
+            g_discard = true;
+        } else {
+            g_line[g_len++] = (char)ch;
+        }
+    }
+    atomic_store_explicit(&g_rx_tail, tail, memory_order_release);
+}
+
+void console_get_stats(ConStats* out)
+{
+    if (out == NULL) { return; }
+    *out = g_stats;
+    out->rx_overrun = atomic_load_explicit(&g_rx_overrun, memory_order_relaxed);
+}
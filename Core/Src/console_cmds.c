@@ -0,0 +1,217 @@
+#include "console.h"
+#include "events.h"
+#include "fsm.h"
+#include "timers.h"
+#include "outdrv.h"
+#include "hw_outdrv_stm32.h"
+#include "inputs.h"
+#include "telem.h"
+#include "log.h"
+#include "can_svc.h"
+#include "coord.h"
+#include "modbus.h"
+#include "canbulk.h"
+#include "hil.h"
+
+/* Commandes de service. Ajouter une commande = une fonction + une ligne
+   (console_init() en refait la table de hachage). */
+
+static void cmd_help(uint8_t argc, char* argv[]);
+
+static void cmd_state(uint8_t argc, char* argv[])
+{
+    (void)argc; (void)argv;
+    con_puts("state "); con_putu((uint32_t)fsm_state());
+    con_puts(" stages "); con_putu(fsm_stages());
+    con_endl();
+}
+
+static void put_evq(const char* name, EvQueueId q)
+{
+    EvQueueStats s;
+    evq_get_stats(q, &s);
+    con_puts(name);
+    con_puts(" push "); con_putu(s.pushed);
+    con_puts(" pop "); con_putu(s.popped);
+    con_puts(" drop "); con_putu(s.dropped);
+    con_puts(" coal "); con_putu(s.coalesced);
+    con_puts(" ign "); con_putu(s.ignored);
+    con_endl();
+}
+
+static void cmd_evq(uint8_t argc, char* argv[])
+{
+    (void)argc; (void)argv;
+    put_evq("faults", EVQ_FAULTS);
+    put_evq("normal", EVQ_NORMAL);
+}
+
+static void cmd_tmr(uint8_t argc, char* argv[])
+{
+    uint32_t id;
+    (void)argc;
+    if (!con_parse_u32(argv[1], &id) || (id >= TMR_COUNT)) { con_puts("id 0.."); con_putu(TMR_COUNT - 1U); con_endl(); return; }
+    con_puts("tmr "); con_putu(id);
+    con_puts(" reste "); con_putu(tmr_remaining_ms((TimerId)id)); con_puts(" ms");
+    con_endl();
+}
+
+/* inject <evt> [u8] [u16]: passe par la file normale, comme un producteur réel */
+static void cmd_inject(uint8_t argc, char* argv[])
+{
+    uint32_t evt, u8 = 0U, u16 = 0U;
+    if (!con_parse_u32(argv[1], &evt) || (evt == 0U) || (evt >= (uint32_t)EVT_MAX_ENUM)
+        || ((argc > 2U) && (!con_parse_u32(argv[2], &u8) || (u8 > 0xFFU)))
+        || ((argc > 3U) && (!con_parse_u32(argv[3], &u16) || (u16 > 0xFFFFU)))) {
+        con_puts("evt 1.."); con_putu((uint32_t)EVT_MAX_ENUM - 1U); con_puts(" u8 u16"); con_endl();
+        return;
+    }
+    const EventArg a = { .u8 = (uint8_t)u8, .u16 = (uint16_t)u16 };
+    con_puts(evq_push(EVQ_NORMAL, (EventType)evt, a) ? "ok" : "file pleine");
+    con_endl();
+}
+
+static void cmd_stats(uint8_t argc, char* argv[])
+{
+    TelemStats t;
+    CanStats c;
+    OutdrvStats o;
+    ConStats k;
+    MbStats m;
+    CanBulkStats b;
+#if HIL_ENABLE
+    HilStats h;
+#endif
+    InpStats in;
+
+    if ((argc > 1U) && (argv[1][0] == 'c')) {
+        inputs_reset_stats();
+        con_puts("stats entrees effacees"); con_endl();
+        return;
+    }
+
+    telem_get_stats(&t);
+    con_puts("telem fr "); con_putu(t.frames); con_puts(" drop "); con_putu(t.dropped);
+    con_puts(" err "); con_putu(t.errors); con_puts(" log_drop "); con_putu(log_dropped());
+    con_endl();
+
+    can_get_stats(&c);
+    con_puts("can rx "); con_putu(c.received); con_puts(" pool "); con_putu(c.pool_empty);
+    con_puts(" hw "); con_putu(c.hw_lost); con_puts(" tx "); con_putu(c.sent);
+    con_puts(" full "); con_putu(c.tx_full);
+    con_endl();
+
+    canbulk_get_stats(&b);
+    con_puts("bulk ok "); con_putu(b.transfers); con_puts(" seg "); con_putu(b.segments);
+    con_puts(" retx "); con_putu(b.retransmits); con_puts(" abort "); con_putu(b.aborted);
+    con_endl();
+
+    outdrv_get_stats(&o);
+    con_puts("outdrv fr "); con_putu(o.frames); con_puts(" skip "); con_putu(o.skipped);
+    con_puts(" err "); con_putu(o.errors); con_puts(" snap_ovr "); con_putu(inputs_snap_overruns());
+    con_endl();
+
+    modbus_get_stats(&m);
+    con_puts("mb fr "); con_putu(m.frames); con_puts(" crc "); con_putu(m.crc_errors);
+    con_puts(" court "); con_putu(m.short_frames); con_puts(" autre "); con_putu(m.other_addr);
+    con_puts(" ex "); con_putu(m.exceptions);
+    con_endl();
+
+    console_get_stats(&k);
+    con_puts("con lines "); con_putu(k.lines); con_puts(" unk "); con_putu(k.unknown);
+    con_puts(" ovr "); con_putu(k.rx_overrun); con_puts(" long "); con_putu(k.too_long);
+    con_puts(" noise "); con_putu(k.noise);
+    con_endl();
+
+#if HIL_ENABLE
+    hil_get_stats(&h);
+    con_puts("hil req "); con_putu(h.requests); con_puts(" bad "); con_putu(h.bad_frames);
+    con_puts(" rejeu "); con_putu(h.replayed); con_puts(" pas "); con_putu(h.stepped);
+    con_puts(" exp "); con_putu(h.expired);
+    con_endl();
+#endif
+
+    /* Bruit par voie décrite: parasites, fenêtre courante, impulsions min/max */
+    for (uint8_t ch = 0U; ch < INP_CH_COUNT; ch++) {
+        if (!inputs_get_stats(ch, &in)) { continue; }
+        con_puts("inp "); con_putu((uint32_t)ch + 1U);
+        con_puts(" gl "); con_putu(in.glitches);
+        con_puts(" deb "); con_putu(in.debounce_ms);
+        con_puts(" min ");
+        if (in.pulse_min_ms == UINT32_MAX) { con_puts("-"); } else { con_putu(in.pulse_min_ms); }
+        con_puts(" max "); con_putu(in.pulse_max_ms);
+        con_endl();
+    }
+}
+
+static void cmd_trip(uint8_t argc, char* argv[])
+{
+    OutdrvTrip t;
+    /* clear: relevé effacé puis sorties réactivées, seulement si les broches
+       FAULT/PGOOD sont revenues (l’état des sorties reste celui de la FSM) */
+    if ((argc > 1U) && (argv[1][0] == 'c')) {
+        if (!hw_outdrv_clear_trip()) { con_puts("trip actif: broche en defaut"); con_endl(); return; }
+        hw_outdrv_enable(true);
+        con_puts("trip efface, sorties reactivees"); con_endl();
+        return;
+    }
+    if (!hw_outdrv_get_trip(&t)) {
+        con_puts("trip aucun, parasites "); con_putu(hw_outdrv_trip_glitches()); con_endl();
+        return;
+    }
+    con_puts("trip n "); con_putu(t.count); con_puts(" at "); con_putu(t.at_ms);
+    con_puts(" src "); con_putu(t.source); con_puts(" pins "); con_putx(t.pins, 2U);
+    con_puts(" isr_ns "); con_putu(hw_outdrv_cycles_to_ns(t.isr_cycles));
+    con_puts(" parasites "); con_putu(hw_outdrv_trip_glitches());
+    con_endl();
+}
+
+static void cmd_peers(uint8_t argc, char* argv[])
+{
+    CoordPeer p;
+    bool any = false;
+    (void)argc; (void)argv;
+    for (uint8_t n = 1U; n <= COORD_MAX_NODES; n++) {
+        if (!coord_get_peer(n, &p)) { continue; }
+        any = true;
+        con_puts("node "); con_putu(n);
+        con_puts(" st "); con_putu(p.last.state);
+        con_puts(" stg "); con_putu(p.last.stages); con_puts("/"); con_putu(p.last.demand);
+        con_puts(" fl "); con_putx(p.last.flags, 2U);
+        con_puts(" vu "); con_putu(p.seen_ms);
+        con_endl();
+    }
+    if (!any) { con_puts("aucun pair"); con_endl(); }
+}
+
+static void cmd_outs(uint8_t argc, char* argv[])
+{
+    (void)argc; (void)argv;
+    for (uint8_t d = 0U; d < OUTDRV_CHAIN_LEN; d++) {
+        con_puts("dev "); con_putu(d);
+        con_puts(" st "); con_putx(outdrv_dev_status(d), 2U);
+        con_puts(" reg");
+        for (uint8_t r = 0U; r < OUTDRV_REG_COUNT; r++) { con_puts(" "); con_putx(outdrv_dev_get(d, r), 2U); }
+        con_endl();
+    }
+}
+
+const ConCmd CON_CMDS[] = {
+    /* nom       fonction     args min  aide */
+    { "help",    cmd_help,    0U, "help" },
+    { "state",   cmd_state,   0U, "state" },
+    { "evq",     cmd_evq,     0U, "evq" },
+    { "tmr",     cmd_tmr,     1U, "tmr <id>" },
+    { "inject",  cmd_inject,  1U, "inject <evt> [u8] [u16]" },
+    { "stats",   cmd_stats,   0U, "stats [clear]" },
+    { "trip",    cmd_trip,    0U, "trip [clear]" },
+    { "peers",   cmd_peers,   0U, "peers" },
+    { "outs",    cmd_outs,    0U, "outs" },
+};
+const uint8_t CON_CMDS_COUNT = (uint8_t)(sizeof(CON_CMDS) / sizeof(CON_CMDS[0]));
+
+static void cmd_help(uint8_t argc, char* argv[])
+{
+    (void)argc; (void)argv;
+    for (uint8_t i = 0U; i < CON_CMDS_COUNT; i++) { con_puts(CON_CMDS[i].help); con_endl(); }
+}
@@ -0,0 +1,167 @@
+#include "coord.h"
+#include "timers.h"
+#include <string.h>
+
+_Static_assert((COORD_NODE_ID >= 1U) && (COORD_NODE_ID <= COORD_MAX_NODES), "COORD_NODE_ID hors bornes");
+_Static_assert(COORD_MAX_NODES <= 15U, "COORD_MAX_NODES > 15: sort de COORD_CAN_ID_MASK");
+
+#define AGE_UNIT_MS  100U
+
+static CoordPeer g_peers[COORD_MAX_NODES + 1U];   /* indexé par identifiant, [0] inutilisé */
+
+static bool     g_wants;
+static uint32_t g_req_ms;           /* début de la demande locale */
+static uint32_t g_last_up_ms;       /* dernière montée connue sur l’installation (locale ou d’un pair) */
+static bool     g_any_up;           /* g_last_up_ms valide */
+static uint32_t g_my_up_ms;         /* dernière montée locale */
+static bool     g_my_up;
+static uint8_t  g_seq;
+
+static uint8_t age_u8(uint32_t ms)
+{
+    const uint32_t a = ms / AGE_UNIT_MS;
+    return (a > 255U) ? 255U : (uint8_t)a;
+}
+
+static void note_up(uint32_t at_ms)
+{
+    /* Garde la plus récente (comparaison modulo 2^32) */
+    if (!g_any_up || ((int32_t)(at_ms - g_last_up_ms) > 0)) {
+        g_last_up_ms = at_ms;
+        g_any_up = true;
+    }
+}
+
+void coord_encode(const CoordFrame* f, uint8_t out[8])
+{
+    out[0] = f->state;
+    out[1] = f->stages;
+    out[2] = f->demand;
+    out[3] = f->flags;
+    out[4] = f->req_age;
+    out[5] = f->up_age;
+    out[6] = f->seq;
+    out[7] = 0U;
+}
+
+void coord_decode(const uint8_t in[8], CoordFrame* f)
+{
+    f->state   = in[0];
+    f->stages  = in[1];
+    f->demand  = in[2];
+    f->flags   = in[3];
+    f->req_age = in[4];
+    f->up_age  = in[5];
+    f->seq     = in[6];
+}
+
+static void broadcast(uint32_t now)
+{
+    CoordFrame f;
+    coord_local(&f.state, &f.stages, &f.demand);
+    f.flags   = g_wants ? COORD_F_WANTS : 0U;
+    f.req_age = g_wants ? age_u8(now - g_req_ms) : 0U;
+    f.up_age  = g_my_up ? age_u8(now - g_my_up_ms) : 255U;
+    f.seq     = g_seq++;
+
+    uint8_t buf[8];
+    coord_encode(&f, buf);
+    (void)can_send(COORD_CAN_ID_BASE + COORD_NODE_ID, false, buf, 8U);   /* FIFO pleine: le prochain tic rattrape */
+}
+
+void coord_init(void)
+{
+    (void)memset(g_peers, 0, sizeof(g_peers));
+    g_wants = false;
+    g_any_up = false;
+    g_my_up = false;
+    g_seq = 0U;
+    (void)tmr_set_slack(TMR_COORD, COORD_PERIOD_MS, COORD_PERIOD_SLACK_MS, EVT_COORD_TICK, EVARG_NONE());
+}
+
+void coord_on_tick(void)
+{
+    const uint32_t now = coord_now_ms();
+    for (uint32_t n = 1U; n <= COORD_MAX_NODES; n++) {
+        if (g_peers[n].alive && ((now - g_peers[n].seen_ms) > COORD_PEER_TIMEOUT_MS)) {
+            g_peers[n].alive = false;
+        }
+    }
+    broadcast(now);
+    (void)tmr_set_slack(TMR_COORD, COORD_PERIOD_MS, COORD_PERIOD_SLACK_MS, EVT_COORD_TICK, EVARG_NONE());
+}
+
+void coord_on_rx(const CanMsg* m)
+{
+    if ((m == NULL) || m->ext || (m->len < 8U)) { return; }
+    const uint32_t node = m->id - COORD_CAN_ID_BASE;
+    if ((node == 0U) || (node > COORD_MAX_NODES) || (node == COORD_NODE_ID)) { return; }
+
+    CoordPeer* p = &g_peers[node];
+    CoordFrame f;
+    coord_decode(m->data, &f);
+
+    /* Montée d’étage du pair: vue directement (étages en hausse) ou par son âge */
+    if (p->alive && (f.stages > p->last.stages)) { note_up(m->at_ms); }
+    if (f.up_age != 255U) { note_up(m->at_ms - ((uint32_t)f.up_age * AGE_UNIT_MS)); }
+
+    p->last = f;
+    p->seen_ms = m->at_ms;
+    p->alive = true;
+}
+
+/* Un pair passe avant nous: demande plus ancienne, ou égale et identifiant plus petit */
+static bool peer_has_priority(uint32_t node, const CoordPeer* p, uint32_t now)
+{
+    if (!p->alive || ((p->last.flags & COORD_F_WANTS) == 0U)) { return false; }
+    const uint32_t peer_age = (now - p->seen_ms) + ((uint32_t)p->last.req_age * AGE_UNIT_MS);
+    const uint32_t my_age = now - g_req_ms;
+    /* Âges connus à AGE_UNIT_MS près: en dessous, départage par identifiant */
+    if (peer_age > (my_age + AGE_UNIT_MS)) { return true; }
+    if ((peer_age + AGE_UNIT_MS) < my_age) { return false; }
+    return node < COORD_NODE_ID;
+}
+
+bool coord_request_stage(void)
+{
+    const uint32_t now = coord_now_ms();
+
+    if (!g_wants) {
+        g_wants = true;
+        g_req_ms = now;
+        broadcast(now);   /* les autres doivent l’entendre avant qu’on se serve */
+        return false;
+    }
+
+    bool granted = (now - g_req_ms) >= COORD_MAX_WAIT_MS;
+    if (!granted && ((now - g_req_ms) >= COORD_SETTLE_MS)) {
+        granted = !g_any_up || ((now - g_last_up_ms) >= COORD_GAP_MS);
+        for (uint32_t n = 1U; granted && (n <= COORD_MAX_NODES); n++) {
+            if (peer_has_priority(n, &g_peers[n], now)) { granted = false; }
+        }
+    }
+    if (!granted) { return false; }
+
+    g_wants = false;
+    g_my_up_ms = now;
+    g_my_up = true;
+    note_up(now);
+    /* Diffusée au prochain passage: l’appelant allume d’abord (étages à jour) */
+    (void)tmr_set(TMR_COORD, 1U, EVT_COORD_TICK, EVARG_NONE());
+    return true;
+}
+
+void coord_cancel_request(void)
+{
+    if (g_wants) {
+        g_wants = false;
+        broadcast(coord_now_ms());
+    }
+}
+
+bool coord_get_peer(uint8_t node, CoordPeer* out)
+{
+    if ((out == NULL) || (node == 0U) || (node > COORD_MAX_NODES) || !g_peers[node].alive) { return false; }
+    *out = g_peers[node];
+    return true;
+}
@@ -104,25 +104,28 @@ bool evq_push(EvQueueId qid, EventType type, EventArg arg){
     }
 }
 
-/* Pop: d’abord FAULTS, puis NORMAL. Retourne false si rien à lire. */
-bool evq_pop_next(EventMsg* out){
+/* Pop sur une file précise. Retourne false si vide. */
+bool evq_pop(EvQueueId qid, EventMsg* out){
     if (!out) return false;
 
-    /* FAULTS prioritaire */
-    if (!rb_empty_u16(q_faults.head, q_faults.tail)) {
+    if (qid == EVQ_FAULTS) {
+        if (rb_empty_u16(q_faults.head, q_faults.tail)) return false;
         *out = q_faults.buf[q_faults.tail];
         q_faults.tail = rb_next_u16(q_faults.tail, EVQ_FAULTS_CAP);
         q_faults.stats.popped++;
         return true;
     }
-    /* Puis NORMAL */
-    if (!rb_empty_u16(q_normal.head, q_normal.tail)) {
-        *out = q_normal.buf[q_normal.tail];
-        q_normal.tail = rb_next_u16(q_normal.tail, EVQ_NORMAL_CAP);
-        q_normal.stats.popped++;
-        return true;
-    }
-    return false;
+    if (rb_empty_u16(q_normal.head, q_normal.tail)) return false;
+    *out = q_normal.buf[q_normal.tail];
+    q_normal.tail = rb_next_u16(q_normal.tail, EVQ_NORMAL_CAP);
+    q_normal.stats.popped++;
+    return true;
+}
+
+/* Pop: d’abord FAULTS, puis NORMAL. Retourne false si rien à lire. */
+bool evq_pop_next(EventMsg* out){
+    if (evq_pop(EVQ_FAULTS, out)) return true;
+    return evq_pop(EVQ_NORMAL, out);
 }
 
 void evq_get_stats(EvQueueId qid, EvQueueStats* out){
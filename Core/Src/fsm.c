@@ -1,14 +1,44 @@
 #include "fsm.h"
+#include "coord.h"
+#include "tpo.h"
 #include "stddef.h"
 /* --------- Paramètres locaux de séquence --------- */
 #ifndef SEQ_DELAY_MS
 #define SEQ_DELAY_MS 12000U   /* délai 12 s entre étapes, adapte si besoin */
 #endif
 
+/* Anti-flap: pas de redémarrage avant MIN_OFF_MS après la fin de chauffe.
+   Délais de confort, pas de sécurité: la tolérance laisse le service de
+   timers les aligner sur un réveil commun (tmr_set_slack). */
+#ifndef MIN_OFF_MS
+#define MIN_OFF_MS 120000U
+#endif
+#ifndef MIN_OFF_SLACK_MS
+#define MIN_OFF_SLACK_MS 5000U
+#endif
+
+/* Ventilation minimale en COOLDOWN */
+#ifndef COOLDOWN_MIN_MS
+#define COOLDOWN_MIN_MS 60000U
+#endif
+#ifndef COOLDOWN_SLACK_MS
+#define COOLDOWN_SLACK_MS 5000U
+#endif
+
+/* Puissance de chaque élément allumé (pour-mille), modulée par tpo.
+   Modifiable par EVT_POWER_SET. */
+#ifndef SEQ_ELEM_DUTY
+#define SEQ_ELEM_DUTY TPO_DUTY_MAX
+#endif
+
+_Static_assert(TPO_CH_COUNT >= 3U, "la séquence pilote 3 éléments modulés");
+
 /* Séquence interne: sens + étape courante */
 typedef enum { SEQ_DIR_NONE=0, SEQ_DIR_UP, SEQ_DIR_DOWN } seq_dir_t;
 static seq_dir_t g_seq_dir = SEQ_DIR_NONE;
-static uint8_t   g_seq_step = 0U;   /* 0..3 pour UP, 3..0 pour DOWN */
+static uint8_t   g_seq_step = 0U;   /* UP: éléments déjà allumés 0..3, DOWN: 3..0 */
+static uint8_t   g_stages = 0U;     /* éléments commandés (diffusé par la coordination) */
+static uint16_t  g_elem_duty = SEQ_ELEM_DUTY;
 
 /* État courant de la FSM */
 static FsmState g_state = ST_IDLE;
@@ -35,6 +65,8 @@ static bool guard_eval(GuardId g)
         case GUARD_TARGET_GAS:     return guard_target_is_gas();
         case GUARD_TEMP_SAFE:      return guard_temp_is_safe();
         case GUARD_NO_FAULT:       return guard_no_fault();
+        case GUARD_LOCKOUT_ACTIVE: return !guard_lockout_clear();
+        case GUARD_COOLDOWN_DONE:  return guard_cooldown_done();
         default:                   return false;
     }
 }
@@ -58,10 +90,14 @@ static void action_exec(ActionId a)
 /* --------- La table FSM (triée par événement) --------- */
 static const FsmTransition FSM[] = {
     /* Thermostat ON (anti-flap + cible) */
-    { ST_IDLE,      EVT_TH_ON,          GUARD_LOCKOUT_CLEAR, ACT_NONE,        ST_IDLE },      /* guard commune, affiner ci-dessous via TRANSITION_REQ si besoin */
+    { ST_IDLE,      EVT_TH_ON,          GUARD_LOCKOUT_ACTIVE, ACT_NONE,       ST_IDLE },      /* anti-flap: absorbé, la demande reste mémorisée */
     { ST_IDLE,      EVT_TH_ON,          GUARD_TARGET_ELEC,   ACT_SEQ_START,   ST_STARTING },
     { ST_IDLE,      EVT_TH_ON,          GUARD_TARGET_GAS,    ACT_ENTER_GAS,   ST_HEAT_GAS },
 
+    /* Fin d'anti-flap: demande arrivée pendant le lockout servie maintenant */
+    { ST_IDLE,      EVT_MIN_OFF_DONE,   GUARD_TARGET_ELEC,   ACT_SEQ_START,   ST_STARTING },
+    { ST_IDLE,      EVT_MIN_OFF_DONE,   GUARD_TARGET_GAS,    ACT_ENTER_GAS,   ST_HEAT_GAS },
+
     /* Fin d'étape de séquence (STARTING/STOPPING) */
     { ST_STARTING,  EVT_SEQ_STEP_TIMEOUT, GUARD_NONE,       ACT_SEQ_STEP,    ST_STARTING },  /* reste en STARTING jusqu'à fin */
     { ST_STOPPING,  EVT_SEQ_STEP_TIMEOUT, GUARD_NONE,       ACT_SEQ_STEP,    ST_STOPPING },
@@ -74,8 +110,9 @@ static const FsmTransition FSM[] = {
     { ST_HEAT_ELEC, EVT_TH_OFF,        GUARD_NONE,          ACT_SEQ_STOP,    ST_STOPPING },
     { ST_HEAT_GAS,  EVT_TH_OFF,        GUARD_NONE,          ACT_ENTER_COOL,  ST_COOLDOWN },
 
-    /* Température redevenue sûre pendant COOLDOWN */
-    { ST_COOLDOWN,  EVT_TEMP_SAFE,     GUARD_NONE,          ACT_ALL_OFF,     ST_IDLE },
+    /* Fin de COOLDOWN: ventilation minimale écoulée et température sûre (dans les deux ordres) */
+    { ST_COOLDOWN,  EVT_TEMP_SAFE,     GUARD_COOLDOWN_DONE, ACT_ALL_OFF,     ST_IDLE },
+    { ST_COOLDOWN,  EVT_COOLDOWN_TIMEOUT, GUARD_TEMP_SAFE,  ACT_ALL_OFF,     ST_IDLE },
 
     /* Bascule bi-énergie demandée (orchestration) */
     { ST_HEAT_ELEC, EVT_TRANSITION_REQ, GUARD_TARGET_GAS,   ACT_SEQ_STOP,    ST_STOPPING },
@@ -86,26 +123,57 @@ static const FsmTransition FSM[] = {
 };
 static const uint32_t FSM_COUNT = (uint32_t)(sizeof(FSM)/sizeof(FSM[0]));
 
+/* Éléments 1..n à la puissance courante, les autres coupés. Le planning de
+   modulation est refait tout de suite (le placement évite les allumages groupés). */
+static void stages_apply(uint8_t n)
+{
+    g_stages = n;
+    for (uint8_t ch = 0U; ch < TPO_CH_COUNT; ch++) {
+        (void)tpo_set_duty(ch, (ch < n) ? g_elem_duty : 0U);
+    }
+    if (n == 0U) { tpo_stop(); } else { tpo_start(); }
+}
+
 /* --------- API --------- */
-void fsm_init(FsmState init) { g_state = init; g_seq_dir = SEQ_DIR_NONE; g_seq_step = 0U; }
+void fsm_init(FsmState init) { g_state = init; g_seq_dir = SEQ_DIR_NONE; g_seq_step = 0U; g_stages = 0U; g_elem_duty = SEQ_ELEM_DUTY; fsm_guards_init(); }
 FsmState fsm_state(void) { return g_state; }
+uint8_t fsm_stages(void) { return g_stages; }
+
+bool fsm_is_critical(EventType type)
+{
+    return (type == EVT_OVERTEMP_CRIT ||
+            type == EVT_FAULT_REDUNDANCY ||
+            type == EVT_FAULT_TIME_BURNER ||
+            type == EVT_FAULT_TIME_ELEMS ||
+            type == EVT_FAULT_OUT_OVERCURRENT ||
+            type == EVT_FAULT_OUT_THERMAL ||
+            type == EVT_FAULT_OUT_DRIVER ||
+            type == EVT_FAULT_OUT_POWER ||
+            type == EVT_SENSOR_FAULT);
+}
 
 /* Moteur: applique la première transition qui matche (src,evt,guard) */
 bool fsm_handle_event(const EventMsg* ev)
 {
     if (ev == NULL) { return false; }
 
+    fsm_guards_observe(ev);
+
     /* Fast-path sécurité: défaut critique → FAULT partout */
-    if (ev->type == EVT_OVERTEMP_CRIT ||
-        ev->type == EVT_FAULT_REDUNDANCY ||
-        ev->type == EVT_FAULT_TIME_BURNER ||
-        ev->type == EVT_FAULT_TIME_ELEMS ||
-        ev->type == EVT_SENSOR_FAULT) {
+    if (fsm_is_critical(ev->type)) {
         action_exec(ACT_ENTER_FAULT);
         g_state = ST_FAULT;
         return true;
     }
 
+    /* Consigne de puissance: retenue dans tous les états, appliquée aux étages en cours */
+    if (ev->type == EVT_POWER_SET) {
+        if (ev->arg.u16 > TPO_DUTY_MAX) { return false; }
+        g_elem_duty = ev->arg.u16;
+        if (g_stages != 0U) { stages_apply(g_stages); }
+        return true;
+    }
+
     for (uint32_t i = 0U; i < FSM_COUNT; i++) {
         const FsmTransition* t = &FSM[i];
         if ((t->evt == ev->type) && (t->src == g_state)) {
@@ -128,45 +196,47 @@ bool fsm_handle_event(const EventMsg* ev)
 static void seq_start_begin(void)
 {
     g_seq_dir  = SEQ_DIR_UP;
-    g_seq_step = 0U;  /* 0: E1, 1: E2, 2: E3 */
-    /* TODO: intention: fan_on(); el1_on(); */
-    (void)tmr_set(TMR_SEQ, SEQ_DELAY_MS, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE());
+    g_seq_step = 0U;  /* aucun élément encore allumé */
+    /* TODO: intention: fan_on(); */
+    seq_step();       /* E1 dès que la coordination l’accorde */
 }
 
 static void seq_stop_begin(void)
 {
+    coord_cancel_request();   /* montée en attente abandonnée */
     g_seq_dir  = SEQ_DIR_DOWN;
-    g_seq_step = 3U;  /* 3: E3 off, 2: E2 off, 1: E1 off */
-    /* TODO: intention: el3_off(); */
-    (void)tmr_set(TMR_SEQ, SEQ_DELAY_MS, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE());
+    g_seq_step = g_stages;    /* éléments réellement allumés, coupés du dernier au premier */
+    seq_step();               /* le dernier tout de suite */
 }
 
 /* Avance d'une étape. Si séquence terminée, émet EVT_SEQ_DONE. */
 static void seq_step(void)
 {
     if (g_seq_dir == SEQ_DIR_UP) {
-        if (g_seq_step == 0U) {
-            /* TODO: el2_on(); */
-            g_seq_step = 1U;
-            (void)tmr_set(TMR_SEQ, SEQ_DELAY_MS, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE());
-        } else if (g_seq_step == 1U) {
-            /* TODO: el3_on(); */
-            g_seq_step = 2U;
-            /* Fin de séquence UP au prochain "done" immédiat */
-            EventMsg done = { .type = EVT_SEQ_DONE, .arg = EVARG_NONE(), .tick = 0U };
-            (void)evq_push(EVQ_NORMAL, done.type, done.arg);
-            g_seq_dir = SEQ_DIR_NONE;
+        if (g_seq_step < 3U) {
+            /* Montée d’étage: jeton de coordination, les unités de l’installation
+               n’allument jamais ensemble (appel de courant étalé). Refus → réessai. */
+            if (!coord_request_stage()) {
+                (void)tmr_set(TMR_SEQ, COORD_RETRY_MS, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE());
+                return;
+            }
+            g_seq_step++;
+            stages_apply(g_seq_step);   /* E1, E2 puis E3 modulés */
+            if (g_seq_step < 3U) {
+                (void)tmr_set(TMR_SEQ, SEQ_DELAY_MS, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE());
+            } else {
+                /* Fin de séquence UP au prochain "done" immédiat */
+                EventMsg done = { .type = EVT_SEQ_DONE, .arg = EVARG_NONE(), .tick = 0U };
+                (void)evq_push(EVQ_NORMAL, done.type, done.arg);
+                g_seq_dir = SEQ_DIR_NONE;
+            }
         } else {
             /* déjà fini */
         }
     } else if (g_seq_dir == SEQ_DIR_DOWN) {
-        if (g_seq_step == 3U) {
-            /* TODO: el2_off(); */
-            g_seq_step = 2U;
-            (void)tmr_set(TMR_SEQ, SEQ_DELAY_MS, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE());
-        } else if (g_seq_step == 2U) {
-            /* TODO: el1_off(); */
-            g_seq_step = 1U;
+        if (g_seq_step > 0U) {
+            g_seq_step--;
+            stages_apply(g_seq_step);   /* E3, E2 puis E1 coupés; à 0, modulation arrêtée */
             (void)tmr_set(TMR_SEQ, SEQ_DELAY_MS, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE());
         } else {
             /* plus rien à éteindre: fin de séquence DOWN */
@@ -193,18 +263,29 @@ static void mark_enter_gas(void)
 
 static void mark_enter_cool(void)
 {
-    /* TODO: intention: status=COOLDOWN; fan_on; éventuellement tmr_set(TMR_COOLDOWN_MIN, ...) */
-    (void)0;
+    /* TODO: intention: status=COOLDOWN; fan_on; */
+    /* Fin de chauffe: éléments coupés, l'anti-flap et la ventilation minimale partent d'ici */
+    stages_apply(0U);
+    (void)tmr_set_slack(TMR_MIN_OFF, MIN_OFF_MS, MIN_OFF_SLACK_MS, EVT_MIN_OFF_DONE, EVARG_NONE());
+    (void)tmr_set_slack(TMR_COOLDOWN_MIN, COOLDOWN_MIN_MS, COOLDOWN_SLACK_MS, EVT_COOLDOWN_TIMEOUT, EVARG_NONE());
 }
 
 static void mark_all_off(void)
 {
     /* TODO: intention: tout OFF; status=IDLE; */
-    (void)0;
+    coord_cancel_request();
+    stages_apply(0U);
+    /* Lockout déjà écoulé pendant le COOLDOWN: EVT_MIN_OFF_DONE n'a trouvé aucune
+       ligne, on le reposte pour que la demande mémorisée soit servie depuis IDLE */
+    if (guard_lockout_clear()) {
+        (void)evq_push(EVQ_NORMAL, EVT_MIN_OFF_DONE, EVARG_NONE());
+    }
 }
 
 static void mark_enter_fault(void)
 {
     /* TODO: intention: outputs_off_sauf_fan; status=FAULT; latch; */
+    coord_cancel_request();
     g_seq_dir = SEQ_DIR_NONE;
+    stages_apply(0U);
 }
@@ -0,0 +1,87 @@
+#include "fsm.h"
+#include "stddef.h"
+
+/* --------- Guards de la table FSM ---------
+   Conditions sans effet de bord, évaluées pendant fsm_handle_event().
+   Leur mémoire (mode, demande, défauts, température) est tenue à jour par
+   fsm_guards_observe(), appelé avec chaque événement avant la table: les
+   événements sans transition (mode, fournisseur…) comptent quand même. */
+
+typedef enum { TARGET_ELEC = 0, TARGET_GAS } energy_t;
+
+static bool     g_demand;         /* thermostat: chauffe demandée */
+static uint8_t  g_user_mode;      /* EVT_USER_MODE_*: 0 ELEC, 1 GAS, 2 BI */
+static energy_t g_provider;       /* en BI: énergie imposée par le fournisseur */
+static bool     g_fault;          /* défaut critique latché jusqu’à EVT_FAULT_CLEAR */
+static bool     g_overtemp;       /* EVT_OVERTEMP_* reçu depuis le dernier EVT_TEMP_SAFE */
+
+void fsm_guards_init(void)
+{
+    g_demand    = false;
+    g_user_mode = 0U;             /* ELEC par défaut: pas de brûleur sans sélection */
+    g_provider  = TARGET_ELEC;
+    g_fault     = false;
+    g_overtemp  = false;
+}
+
+void fsm_guards_observe(const EventMsg* ev)
+{
+    if (ev == NULL) { return; }
+
+    switch (ev->type) {
+        case EVT_TH_ON:             g_demand = true;           break;
+        case EVT_TH_OFF:            g_demand = false;          break;
+        case EVT_USER_MODE_ELEC:    g_user_mode = 0U;          break;
+        case EVT_USER_MODE_GAS:     g_user_mode = 1U;          break;
+        case EVT_USER_MODE_BI:      g_user_mode = 2U;          break;
+        case EVT_PROVIDER_TO_ELEC:  g_provider = TARGET_ELEC;  break;
+        case EVT_PROVIDER_TO_GAS:   g_provider = TARGET_GAS;   break;
+        case EVT_OVERTEMP_WARN:
+        case EVT_OVERTEMP_CRIT:     g_overtemp = true;         break;
+        case EVT_TEMP_SAFE:         g_overtemp = false;        break;
+        case EVT_FAULT_CLEAR:       g_fault = false;           break;
+        default:                                               break;
+    }
+    if (fsm_is_critical(ev->type)) { g_fault = true; }
+}
+
+/* Énergie visée en ce moment (mode utilisateur, fournisseur en BI) */
+static energy_t target(void)
+{
+    if (g_user_mode == 1U) { return TARGET_GAS; }
+    if (g_user_mode == 2U) { return g_provider; }
+    return TARGET_ELEC;
+}
+
+/* Anti-flap: TMR_MIN_OFF inactif (expiration livrée comprise) */
+bool guard_lockout_clear(void)
+{
+    return !tmr_is_active(TMR_MIN_OFF);
+}
+
+/* Cible finale: chauffe demandée et énergie visée */
+bool guard_target_is_elec(void)
+{
+    return g_demand && (target() == TARGET_ELEC);
+}
+
+bool guard_target_is_gas(void)
+{
+    return g_demand && (target() == TARGET_GAS);
+}
+
+/* Ventilation minimale: TMR_COOLDOWN_MIN inactif */
+bool guard_cooldown_done(void)
+{
+    return !tmr_is_active(TMR_COOLDOWN_MIN);
+}
+
+bool guard_temp_is_safe(void)
+{
+    return !g_overtemp;
+}
+
+bool guard_no_fault(void)
+{
+    return !g_fault;
+}
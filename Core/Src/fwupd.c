@@ -0,0 +1,269 @@
+#include "fwupd.h"
+#include <string.h>
+#include <stdatomic.h>
+
+_Static_assert((FWUPD_BLOCK % 16U) == 0U, "FWUPD_BLOCK: multiple du quad-mot flash");
+
+typedef enum { BUF_FREE = 0, BUF_FILLING, BUF_QUEUED, BUF_PROGRAMMING } BufState;
+
+typedef struct {
+    BufState state;
+    uint16_t blk;
+    uint16_t frames;     /* trames reçues (bit n = trame n) */
+    uint8_t  data[FWUPD_BLOCK] __attribute__((aligned(16)));
+} FwBuf;
+
+static FwBuf      g_buf[2];
+static FwupdState g_state;
+static uint32_t   g_size;
+static uint16_t   g_nblk;
+static uint16_t   g_next;        /* prochain bloc attendu */
+static bool       g_ack_due;     /* bloc g_next-1 accepté, ACK en attente d’un tampon libre */
+static bool       g_ready_due;   /* effacement terminé, READY à envoyer */
+static uint32_t   g_image_crc;
+static uint32_t   g_read_crc;    /* relu en flash (DONE rejoué si perdu) */
+static bool       g_unlocked;    /* flash déverrouillée par hw_fwupd_erase_start() */
+static bool       g_trial;       /* image en service à l’essai, banque inactive = repli */
+static uint32_t   g_trial_t0;
+
+/* Fin d’opérations flash (ISR) */
+static atomic_bool g_erase_done, g_erase_ok;
+static atomic_bool g_prog_done, g_prog_ok;
+static bool        g_flash_busy;
+
+static void put16(uint8_t* p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(&p[2], v >> 16); }
+static uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | ((uint16_t)p[1] << 8)); }
+static uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(&p[2]) << 16); }
+
+static void reply(uint8_t op, uint32_t a, uint32_t b)
+{
+    uint8_t f[8] = { op, 0U, 0U, 0U, 0U, 0U, 0U, 0U };
+    if (op == FWUPD_OP_DONE) { f[1] = (uint8_t)a; put32(&f[2], b); }
+    else if (op == FWUPD_OP_ERR) { f[1] = (uint8_t)a; }
+    else { put16(&f[1], a); put16(&f[3], b); }
+    (void)can_send(FWUPD_ID_RSP + COORD_NODE_ID, false, f, 8U);   /* FIFO pleine: l’outil relance */
+}
+
+static void fail(uint8_t code)
+{
+    reply(FWUPD_OP_ERR, code, 0U);
+    g_state = FWUPD_FAILED;
+}
+
+/* Octets du bloc b (le dernier peut être court) */
+static uint32_t blk_len(uint16_t b)
+{
+    const uint32_t off = (uint32_t)b * FWUPD_BLOCK;
+    return ((g_size - off) < FWUPD_BLOCK) ? (g_size - off) : FWUPD_BLOCK;
+}
+
+static uint16_t frames_mask(uint16_t b)
+{
+    const uint32_t n = (blk_len(b) + FWUPD_FRAME_DATA - 1U) / FWUPD_FRAME_DATA;
+    return (n >= 16U) ? 0xFFFFU : (uint16_t)((1UL << n) - 1U);
+}
+
+static FwBuf* buf_in(BufState s)
+{
+    for (uint32_t i = 0U; i < 2U; i++) { if (g_buf[i].state == s) { return &g_buf[i]; } }
+    return NULL;
+}
+
+/* Tampon de réception du bloc g_next, pris sur un libre si besoin */
+static FwBuf* filling(void)
+{
+    FwBuf* b = buf_in(BUF_FILLING);
+    if ((b == NULL) && (g_next < g_nblk) && ((b = buf_in(BUF_FREE)) != NULL)) {
+        b->state = BUF_FILLING;
+        b->blk = g_next;
+        b->frames = 0U;
+        (void)memset(b->data, 0xFF, sizeof(b->data));
+    }
+    return b;
+}
+
+static void start(uint32_t size)
+{
+    if (g_flash_busy || g_trial) { reply(FWUPD_OP_ERR, FWUPD_ERR_STATE, 0U); return; }   /* session en vol, ou repli à garder */
+    if ((size == 0U) || ((size % 16U) != 0U) || (size > hw_fwupd_capacity())) { fail(FWUPD_ERR_SIZE); return; }
+    (void)memset(g_buf, 0, sizeof(g_buf));
+    g_size = size;
+    g_nblk = (uint16_t)((size + FWUPD_BLOCK - 1U) / FWUPD_BLOCK);
+    g_next = 0U;
+    g_ack_due = false;
+    g_ready_due = false;
+    atomic_store_explicit(&g_erase_done, false, memory_order_relaxed);
+    g_unlocked = true;
+    if (!hw_fwupd_erase_start(size)) { fail(FWUPD_ERR_FLASH); return; }
+    g_flash_busy = true;
+    g_state = FWUPD_ERASING;
+}
+
+static void data(uint16_t blk, uint8_t idx, const uint8_t* p, uint8_t n)
+{
+    FwBuf* b = filling();
+    if ((b == NULL) || (blk != b->blk) || (idx >= FWUPD_FRAMES_PER_BLOCK)) { return; }   /* doublon ou hors fenêtre */
+    const uint32_t off = (uint32_t)idx * FWUPD_FRAME_DATA;
+    const uint32_t len = blk_len(blk);
+    if (off >= len) { return; }
+    if (n > (len - off)) { n = (uint8_t)(len - off); }
+    (void)memcpy(&b->data[off], p, n);
+    b->frames |= (uint16_t)(1U << idx);
+}
+
+static void blkend(uint16_t blk, uint32_t crc)
+{
+    if ((uint32_t)blk + 1U == g_next) {          /* ACK perdu: le rejouer dès que possible */
+        if (!g_ack_due) { reply(FWUPD_OP_ACK, blk, 0U); }
+        return;
+    }
+    FwBuf* b = filling();
+    if ((b == NULL) || (blk != b->blk)) { return; }
+    const uint16_t missing = (uint16_t)(frames_mask(blk) & ~b->frames);
+    if (missing != 0U) { reply(FWUPD_OP_NAK, blk, missing); return; }
+    if (hw_fwupd_crc32(b->data, blk_len(blk)) != crc) {
+        b->frames = 0U;
+        reply(FWUPD_OP_NAK, blk, 0U);
+        return;
+    }
+    b->state = BUF_QUEUED;
+    g_next++;
+    g_ack_due = true;   /* envoyé par fwupd_poll() quand un tampon est libre */
+}
+
+void fwupd_init(void)
+{
+    (void)memset(g_buf, 0, sizeof(g_buf));
+    g_state = FWUPD_IDLE;
+    g_flash_busy = false;
+    g_unlocked = false;
+    atomic_store_explicit(&g_erase_done, false, memory_order_relaxed);
+    atomic_store_explicit(&g_prog_done, false, memory_order_relaxed);
+    g_trial = hw_fwupd_trial();
+    g_trial_t0 = fwupd_now_ms();
+}
+
+FwupdState fwupd_state(void)
+{
+    return g_state;
+}
+
+bool fwupd_on_trial(void)
+{
+    return g_trial;
+}
+
+void fwupd_on_rx(const CanMsg* m)
+{
+    if ((m == NULL) || (m->len < 1U)) { return; }
+    const uint8_t* d = m->data;
+
+    switch (d[0]) {
+    case FWUPD_OP_START:
+        if (m->len >= 5U) { start(get32(&d[1])); }
+        break;
+    case FWUPD_OP_DATA:
+        if ((g_state == FWUPD_RECEIVING) && (m->len > 4U)) { data(get16(&d[1]), d[3], &d[4], (uint8_t)(m->len - 4U)); }
+        break;
+    case FWUPD_OP_BLKEND:
+        if ((g_state == FWUPD_RECEIVING) && (m->len >= 7U)) { blkend(get16(&d[1]), get32(&d[3])); }
+        break;
+    case FWUPD_OP_FINISH:
+        if ((g_state == FWUPD_RECEIVING) && (m->len >= 5U) && (g_next == g_nblk)) {
+            g_image_crc = get32(&d[1]);
+            g_state = FWUPD_FINISHING;
+        } else if (g_state == FWUPD_VERIFIED) {
+            reply(FWUPD_OP_DONE, 1U, g_read_crc);
+        } else if (g_state != FWUPD_FINISHING) {
+            reply(FWUPD_OP_ERR, FWUPD_ERR_STATE, 0U);
+        }
+        break;
+    case FWUPD_OP_COMMIT:
+        if ((g_state == FWUPD_VERIFIED) && hw_fwupd_vectors_ok(g_size)) { hw_fwupd_commit(); }
+        reply(FWUPD_OP_ERR, FWUPD_ERR_STATE, 0U);
+        break;
+    case FWUPD_OP_ABORT:
+        g_state = FWUPD_IDLE;   /* opération flash en cours: menée à terme, sans suite */
+        break;
+    default:
+        break;
+    }
+}
+
+void fwupd_on_erase_done(bool ok)
+{
+    atomic_store_explicit(&g_erase_ok, ok, memory_order_relaxed);
+    atomic_store_explicit(&g_erase_done, true, memory_order_release);
+}
+
+void fwupd_on_program_done(bool ok)
+{
+    atomic_store_explicit(&g_prog_ok, ok, memory_order_relaxed);
+    atomic_store_explicit(&g_prog_done, true, memory_order_release);
+}
+
+void fwupd_poll(void)
+{
+    /* Essai: la boucle principale tourne, confirmation au bout du délai */
+    hw_fwupd_kick();
+    if (g_trial && ((fwupd_now_ms() - g_trial_t0) >= FWUPD_CONFIRM_MS)) {
+        hw_fwupd_confirm();
+        g_trial = false;
+    }
+
+    /* Fin d’effacement */
+    if (atomic_exchange_explicit(&g_erase_done, false, memory_order_acquire)) {
+        g_flash_busy = false;
+        if (g_state == FWUPD_ERASING) {
+            if (atomic_load_explicit(&g_erase_ok, memory_order_relaxed)) { g_state = FWUPD_RECEIVING; g_ready_due = true; }
+            else { fail(FWUPD_ERR_FLASH); }
+        }
+    }
+    if (g_ready_due) {
+        reply(FWUPD_OP_READY, FWUPD_BLOCK, FWUPD_FRAMES_PER_BLOCK);
+        g_ready_due = false;
+    }
+
+    /* Fin de programmation d’un bloc: tampon rendu */
+    if (atomic_exchange_explicit(&g_prog_done, false, memory_order_acquire)) {
+        FwBuf* b = buf_in(BUF_PROGRAMMING);
+        g_flash_busy = false;
+        if (b != NULL) { b->state = BUF_FREE; }
+        if (!atomic_load_explicit(&g_prog_ok, memory_order_relaxed) && (g_state != FWUPD_IDLE)) { fail(FWUPD_ERR_FLASH); }
+    }
+
+    if ((g_state != FWUPD_RECEIVING) && (g_state != FWUPD_FINISHING)) {
+        if ((g_state == FWUPD_IDLE) || (g_state == FWUPD_FAILED)) {
+            for (uint32_t i = 0U; i < 2U; i++) { if (g_buf[i].state != BUF_PROGRAMMING) { g_buf[i].state = BUF_FREE; } }
+            g_ack_due = false;
+        }
+        if (g_unlocked && !g_flash_busy) { hw_fwupd_lock(); g_unlocked = false; }   /* fin de session */
+        return;
+    }
+
+    /* Bloc validé suivant → flash (un seul à la fois) */
+    if (!g_flash_busy) {
+        FwBuf* b = buf_in(BUF_QUEUED);
+        if (b != NULL) {
+            if (!hw_fwupd_program_start((uint32_t)b->blk * FWUPD_BLOCK, b->data, blk_len(b->blk))) { fail(FWUPD_ERR_FLASH); return; }
+            b->state = BUF_PROGRAMMING;
+            g_flash_busy = true;
+        }
+    }
+
+    /* ACK dès qu’un tampon attend le bloc suivant (ou que c’était le dernier) */
+    if (g_ack_due && ((g_next == g_nblk) || (filling() != NULL))) {
+        reply(FWUPD_OP_ACK, (uint32_t)g_next - 1U, 0U);
+        g_ack_due = false;
+    }
+
+    /* Tout est en flash: relecture et vérification */
+    if ((g_state == FWUPD_FINISHING) && !g_flash_busy && (buf_in(BUF_QUEUED) == NULL)) {
+        g_read_crc = hw_fwupd_crc32(hw_fwupd_staged(), g_size);
+        const bool ok = (g_read_crc == g_image_crc);
+        if (ok && !hw_fwupd_vectors_ok(g_size)) { fail(FWUPD_ERR_IMAGE); return; }
+        reply(FWUPD_OP_DONE, ok ? 1U : 0U, g_read_crc);
+        g_state = ok ? FWUPD_VERIFIED : FWUPD_FAILED;
+    }
+}
@@ -0,0 +1,231 @@
+#include "hil.h"
+
+#if HIL_ENABLE
+
+#include "telem.h"
+#include "fsm.h"
+#include "timers.h"
+#include <string.h>
+
+/* Trame décodée: type, seq, op, arguments (≤ 5), CRC16 */
+#define HIL_RAW_MAX  16U
+
+static bool     g_frozen;
+static uint16_t g_credit;       /* événements encore permis au pas-à-pas */
+static bool     g_step_due;     /* STEP accepté, réponse après le passage du dispatcher */
+static uint8_t  g_step_seq;
+static uint16_t g_step_done;
+static uint8_t  g_step_last;
+static uint32_t g_host_ms;      /* dernière requête valide: le gel expire sans hôte */
+
+/* Dernière réponse, renvoyée telle quelle si le même seq revient */
+static uint8_t  g_last[TELEM_MAX_PAYLOAD];
+static uint8_t  g_last_len;
+static bool     g_have_last;
+
+static HilStats g_stats;
+
+static void put32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+/* COBS inverse: n octets sans 0x00 (délimiteurs retirés). Retourne la longueur, 0 si invalide. */
+static uint32_t cobs_decode(const uint8_t* in, uint32_t n, uint8_t* out, uint32_t cap)
+{
+    uint32_t i = 0U;
+    uint32_t o = 0U;
+    while (i < n) {
+        const uint8_t code = in[i++];
+        if ((code == 0U) || ((i + code - 1U) > n) || ((o + code) > cap)) { return 0U; }
+        for (uint8_t k = 1U; k < code; k++) { out[o++] = in[i++]; }
+        if ((code < 0xFFU) && (i < n)) { out[o++] = 0U; }
+    }
+    return o;
+}
+
+static void send(uint8_t len)
+{
+    g_last_len = len;
+    g_have_last = true;
+    (void)telem_send(TELEM_T_HIL, g_last, len);   /* télémétrie pleine: l’hôte relance, même seq */
+}
+
+/* Réponse en cours: g_last[0..2] = seq, op, statut; les données suivent */
+static uint8_t* reply_start(uint8_t seq, uint8_t op, uint8_t status)
+{
+    g_last[0] = seq;
+    g_last[1] = op;
+    g_last[2] = status;
+    return &g_last[3];
+}
+
+static void req_tmr(uint8_t seq, uint8_t first)
+{
+    uint8_t* d = reply_start(seq, HIL_OP_TMR, HIL_OK);
+    const uint32_t left = (first < TMR_COUNT) ? (TMR_COUNT - first) : 0U;
+    const uint8_t n = (uint8_t)((left < HIL_TMR_PER_FRAME) ? left : HIL_TMR_PER_FRAME);
+    uint32_t active = 0U;
+    for (uint8_t i = 0U; i < n; i++) {
+        const TimerId id = (TimerId)(first + i);
+        if (tmr_is_active(id)) { active |= 1UL << i; }
+        put32(&d[6U + (4U * i)], tmr_remaining_ms(id));
+    }
+    d[0] = first;
+    d[1] = n;
+    put32(&d[2], active);
+    send((uint8_t)(3U + 6U + (4U * n)));
+}
+
+static void request(uint8_t seq, uint8_t op, const uint8_t* a, uint32_t n)
+{
+    uint8_t* d;
+    g_stats.requests++;
+    g_host_ms = hil_now_ms();
+
+    switch (op) {
+    case HIL_OP_PING:
+        d = reply_start(seq, op, HIL_OK);
+        d[0] = HIL_VERSION;
+        d[1] = (uint8_t)EVT_MAX_ENUM;
+        d[2] = (uint8_t)TMR_COUNT;
+        d[3] = g_frozen ? 1U : 0U;
+        send(3U + 4U);
+        break;
+
+    case HIL_OP_PUSH: {
+        if ((n < 5U) || (a[0] > (uint8_t)EVQ_FAULTS) || (a[1] == 0U) || (a[1] >= (uint8_t)EVT_MAX_ENUM)) {
+            (void)reply_start(seq, op, HIL_E_ARGS);
+            send(3U);
+            break;
+        }
+        const EventArg arg = { .u8 = a[2], .u16 = (uint16_t)(a[3] | ((uint16_t)a[4] << 8)) };
+        (void)reply_start(seq, op, evq_push((EvQueueId)a[0], (EventType)a[1], arg) ? HIL_OK : HIL_E_FULL);
+        send(3U);
+        break;
+    }
+
+    case HIL_OP_STATE:
+        d = reply_start(seq, op, HIL_OK);
+        d[0] = (uint8_t)fsm_state();
+        d[1] = fsm_stages();
+        d[2] = g_frozen ? 1U : 0U;
+        put32(&d[3], hil_now_ms());
+        send(3U + 7U);
+        break;
+
+    case HIL_OP_EVQ: {
+        EvQueueStats s;
+        if ((n < 1U) || (a[0] > (uint8_t)EVQ_FAULTS)) { (void)reply_start(seq, op, HIL_E_ARGS); send(3U); break; }
+        evq_get_stats((EvQueueId)a[0], &s);
+        d = reply_start(seq, op, HIL_OK);
+        put32(&d[0], s.pushed);
+        put32(&d[4], s.popped);
+        put32(&d[8], s.dropped);
+        put32(&d[12], s.coalesced);
+        put32(&d[16], s.ignored);
+        send(3U + 20U);
+        break;
+    }
+
+    case HIL_OP_TMR:
+        req_tmr(seq, (n >= 1U) ? a[0] : 0U);
+        break;
+
+    case HIL_OP_FREEZE:
+        if ((n < 1U) || (a[0] > 1U)) { (void)reply_start(seq, op, HIL_E_ARGS); send(3U); break; }
+        g_frozen = (a[0] != 0U);
+        if (!g_frozen) { g_credit = 0U; }   /* STEP en attente: répondu au passage suivant */
+        (void)reply_start(seq, op, HIL_OK);
+        send(3U);
+        break;
+
+    case HIL_OP_STEP: {
+        const uint16_t steps = (n >= 2U) ? (uint16_t)(a[0] | ((uint16_t)a[1] << 8)) : 0U;
+        if (steps == 0U) { (void)reply_start(seq, op, HIL_E_ARGS); send(3U); break; }
+        if (!g_frozen || g_step_due) { (void)reply_start(seq, op, HIL_E_STATE); send(3U); break; }
+        g_credit = steps;
+        g_step_due = true;
+        g_step_done = 0U;
+        g_step_last = 0U;
+        g_step_seq = seq;
+        break;
+    }
+
+    default:
+        (void)reply_start(seq, op, HIL_E_OP);
+        send(3U);
+        break;
+    }
+}
+
+void hil_init(void)
+{
+    g_frozen = false;
+    g_credit = 0U;
+    g_step_due = false;
+    g_have_last = false;
+    (void)memset(&g_stats, 0, sizeof(g_stats));
+}
+
+void hil_on_frame(const uint8_t* p, uint32_t n)
+{
+    uint8_t raw[HIL_RAW_MAX];
+    const uint32_t len = cobs_decode(p, n, raw, sizeof(raw));
+
+    /* type, seq, op, CRC16 au minimum */
+    if ((len < 5U) || (raw[0] != TELEM_T_HIL)
+        || (telem_crc16(raw, len - 2U) != (uint16_t)(((uint16_t)raw[len - 2U] << 8) | raw[len - 1U]))) {
+        g_stats.bad_frames++;
+        return;
+    }
+    const uint8_t seq = raw[1];
+    if (g_step_due && (seq == g_step_seq)) { return; }   /* STEP répété: la réponse viendra */
+    if (g_have_last && (seq == g_last[0])) {
+        g_stats.replayed++;
+        (void)telem_send(TELEM_T_HIL, g_last, g_last_len);
+        return;
+    }
+    request(seq, raw[2], &raw[3], len - 5U);
+}
+
+bool hil_gate(void)
+{
+    return !g_frozen || (g_credit != 0U);
+}
+
+void hil_on_dispatch(const EventMsg* ev)
+{
+    if (!g_frozen) { return; }
+    g_credit--;
+    g_step_done++;
+    g_step_last = (uint8_t)ev->type;
+    g_stats.stepped++;
+}
+
+void hil_poll(void)
+{
+    if (g_frozen && ((hil_now_ms() - g_host_ms) >= HIL_FREEZE_MAX_MS)) {
+        g_frozen = false;
+        g_credit = 0U;   /* STEP en attente: répondu ci-dessous */
+        g_stats.expired++;
+    }
+    if (!g_step_due) { return; }
+    /* Le dispatcher vient de passer: crédit épuisé ou files vides */
+    g_credit = 0U;
+    g_step_due = false;
+    uint8_t* d = reply_start(g_step_seq, HIL_OP_STEP, HIL_OK);
+    d[0] = (uint8_t)g_step_done;
+    d[1] = (uint8_t)(g_step_done >> 8);
+    d[2] = g_step_last;
+    d[3] = (uint8_t)fsm_state();
+    send(3U + 4U);
+}
+
+void hil_get_stats(HilStats* out)
+{
+    if (out == NULL) { return; }
+    *out = g_stats;
+}
+
+#endif /* HIL_ENABLE */
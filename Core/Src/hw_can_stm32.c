@@ -0,0 +1,153 @@
+// hw_can_stm32.c
+#include "hw_can_stm32.h"
+#include "can_svc.h"
+#include <string.h>
+
+_Static_assert((HSE_VALUE % (CAN_BITRATE * CAN_TQ_PER_BIT)) == 0U, "CAN_BITRATE: pas de prescaler entier depuis HSE");
+_Static_assert((1U + CAN_TSEG1 + CAN_TSEG2) == CAN_TQ_PER_BIT, "CAN: segments incohérents");
+_Static_assert(CAN_MAX_DATA >= 8U, "CAN_MAX_DATA < 8");
+#if CAN_FD
+_Static_assert((HSE_VALUE % (CAN_DATA_BITRATE * CAN_DATA_TQ_PER_BIT)) == 0U, "CAN_DATA_BITRATE: pas de prescaler entier depuis HSE");
+_Static_assert((1U + CAN_DATA_TSEG1 + CAN_DATA_TSEG2) == CAN_DATA_TQ_PER_BIT, "CAN FD: segments de données incohérents");
+_Static_assert(CAN_MAX_DATA <= 64U, "CAN_MAX_DATA > 64");
+#endif
+
+#define HW_CAN_STD_FILTERS  28U   // mémoire message FDCAN H5
+#define HW_CAN_EXT_FILTERS  8U
+
+extern FDCAN_HandleTypeDef hfdcan1;
+
+// Filtre matériel → ligne de CAN_RX_TABLE
+static uint8_t g_std_row[HW_CAN_STD_FILTERS];
+static uint8_t g_ext_row[HW_CAN_EXT_FILTERS];
+
+// Code DLC → octets (CAN FD au-delà de 8)
+static const uint8_t DLC_LEN[16] = { 0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U };
+
+void hw_can_init(void) {
+    uint32_t nstd = 0U;
+    uint32_t next = 0U;
+    for (uint32_t r = 0U; r < CAN_RX_TABLE_COUNT; r++) {
+        if (CAN_RX_TABLE[r].ext) { next++; } else { nstd++; }
+    }
+    if ((nstd > HW_CAN_STD_FILTERS) || (next > HW_CAN_EXT_FILTERS)) { Error_Handler(); }
+
+    if (HAL_FDCAN_DeInit(&hfdcan1) != HAL_OK) { Error_Handler(); }
+    hfdcan1.Init.AutoRetransmission = ENABLE;
+    hfdcan1.Init.NominalPrescaler = HSE_VALUE / (CAN_BITRATE * CAN_TQ_PER_BIT);
+    hfdcan1.Init.NominalSyncJumpWidth = CAN_SJW;
+    hfdcan1.Init.NominalTimeSeg1 = CAN_TSEG1;
+    hfdcan1.Init.NominalTimeSeg2 = CAN_TSEG2;
+#if CAN_FD
+    hfdcan1.Init.FrameFormat = FDCAN_FRAME_FD_BRS;
+    hfdcan1.Init.DataPrescaler = HSE_VALUE / (CAN_DATA_BITRATE * CAN_DATA_TQ_PER_BIT);
+    hfdcan1.Init.DataSyncJumpWidth = CAN_DATA_SJW;
+    hfdcan1.Init.DataTimeSeg1 = CAN_DATA_TSEG1;
+    hfdcan1.Init.DataTimeSeg2 = CAN_DATA_TSEG2;
+#endif
+    hfdcan1.Init.StdFiltersNbr = nstd;
+    hfdcan1.Init.ExtFiltersNbr = next;
+    if (HAL_FDCAN_Init(&hfdcan1) != HAL_OK) { Error_Handler(); }
+#if CAN_FD
+    // Retard de boucle du transceiver > un bit de données à 1 Mbit/s: point de
+    // vérification décalé au point d’échantillonnage
+    if (HAL_FDCAN_ConfigTxDelayCompensation(&hfdcan1, hfdcan1.Init.DataPrescaler * CAN_DATA_TSEG1, 0U) != HAL_OK) { Error_Handler(); }
+    if (HAL_FDCAN_EnableTxDelayCompensation(&hfdcan1) != HAL_OK) { Error_Handler(); }
+#endif
+
+    // Un filtre classique id/masque par ligne, numéroté par type d’identifiant
+    uint32_t istd = 0U;
+    uint32_t iext = 0U;
+    for (uint32_t r = 0U; r < CAN_RX_TABLE_COUNT; r++) {
+        const CanRxDesc* d = &CAN_RX_TABLE[r];
+        FDCAN_FilterTypeDef f = {0};
+        f.IdType = d->ext ? FDCAN_EXTENDED_ID : FDCAN_STANDARD_ID;
+        f.FilterIndex = d->ext ? iext : istd;
+        f.FilterType = FDCAN_FILTER_MASK;
+        f.FilterConfig = (d->fifo != 0U) ? FDCAN_FILTER_TO_RXFIFO1 : FDCAN_FILTER_TO_RXFIFO0;
+        f.FilterID1 = d->id;
+        f.FilterID2 = d->mask;
+        if (HAL_FDCAN_ConfigFilter(&hfdcan1, &f) != HAL_OK) { Error_Handler(); }
+        if (d->ext) { g_ext_row[iext++] = (uint8_t)r; } else { g_std_row[istd++] = (uint8_t)r; }
+    }
+    if (HAL_FDCAN_ConfigGlobalFilter(&hfdcan1, FDCAN_REJECT, FDCAN_REJECT,
+                                     FDCAN_REJECT_REMOTE, FDCAN_REJECT_REMOTE) != HAL_OK) { Error_Handler(); }
+
+    // Les deux FIFO sur la ligne 0: une seule ISR, FIFO 1 servie en premier
+    if (HAL_FDCAN_ConfigInterruptLines(&hfdcan1, FDCAN_IT_GROUP_RX_FIFO0 | FDCAN_IT_GROUP_RX_FIFO1,
+                                       FDCAN_INTERRUPT_LINE0) != HAL_OK) { Error_Handler(); }
+    if (HAL_FDCAN_ActivateNotification(&hfdcan1,
+                                       FDCAN_IT_RX_FIFO0_NEW_MESSAGE | FDCAN_IT_RX_FIFO0_MESSAGE_LOST |
+                                       FDCAN_IT_RX_FIFO1_NEW_MESSAGE | FDCAN_IT_RX_FIFO1_MESSAGE_LOST,
+                                       0U) != HAL_OK) { Error_Handler(); }
+    HAL_NVIC_SetPriority(FDCAN1_IT0_IRQn, CAN_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(FDCAN1_IT0_IRQn);
+
+    if (HAL_FDCAN_Start(&hfdcan1) != HAL_OK) { Error_Handler(); }
+}
+
+bool hw_can_send(uint32_t id, bool ext, const uint8_t* data, uint8_t len, bool fd) {
+    FDCAN_TxHeaderTypeDef h = {0};
+    uint8_t pad[64];
+    if ((len > 64U) || (!fd && (len > 8U))) { return false; }
+    uint32_t dlc = (len > 8U) ? 9U : len;   // 0..8: code DLC = nombre d’octets
+    while ((dlc < 15U) && (DLC_LEN[dlc] < len)) { dlc++; }   // FD: taille DLC supérieure
+    if (DLC_LEN[dlc] != len) {
+        // Le contrôleur lit DLC_LEN[dlc] octets: complète sans lire au-delà de data
+        (void)memset(pad, 0, sizeof(pad));
+        (void)memcpy(pad, data, len);
+        data = pad;
+    }
+    h.Identifier = id;
+    h.IdType = ext ? FDCAN_EXTENDED_ID : FDCAN_STANDARD_ID;
+    h.TxFrameType = FDCAN_DATA_FRAME;
+    h.DataLength = dlc;
+    h.ErrorStateIndicator = FDCAN_ESI_ACTIVE;
+    h.BitRateSwitch = fd ? FDCAN_BRS_ON : FDCAN_BRS_OFF;
+    h.FDFormat = fd ? FDCAN_FD_CAN : FDCAN_CLASSIC_CAN;
+    h.TxEventFifoControl = FDCAN_NO_TX_EVENTS;
+    h.MessageMarker = 0U;
+    if (HAL_FDCAN_GetTxFifoFreeLevel(&hfdcan1) == 0U) { return false; }
+    return HAL_FDCAN_AddMessageToTxFifoQ(&hfdcan1, &h, data) == HAL_OK;
+}
+
+uint8_t hw_can_tx_free(void) {
+    return (uint8_t)HAL_FDCAN_GetTxFifoFreeLevel(&hfdcan1);
+}
+
+// Vide une FIFO: chaque élément est lu directement dans un message du pool.
+// Pool plein: l’élément est quand même retiré (sinon la FIFO bloque le bus pour nous).
+static void drain(FDCAN_HandleTypeDef* h, uint32_t fifo) {
+    while (HAL_FDCAN_GetRxFifoFillLevel(h, fifo) != 0U) {
+        FDCAN_RxHeaderTypeDef hdr;
+        CanMsg* m = can_rx_alloc();
+        uint8_t scratch[64];
+        if (HAL_FDCAN_GetRxMessage(h, fifo, &hdr, (m != NULL) ? m->data : scratch) != HAL_OK) {
+            if (m != NULL) { can_rx_free(m); }   // jamais publié: rendu au pool
+            break;
+        }
+        if (m == NULL) { continue; }
+
+        const uint8_t row = (hdr.IdType == FDCAN_EXTENDED_ID)
+                            ? g_ext_row[hdr.FilterIndex % HW_CAN_EXT_FILTERS]
+                            : g_std_row[hdr.FilterIndex % HW_CAN_STD_FILTERS];
+        m->id = hdr.Identifier;
+        m->ext = (hdr.IdType == FDCAN_EXTENDED_ID);
+        m->len = DLC_LEN[hdr.DataLength & 0x0FU];
+        if (m->len > CAN_MAX_DATA) { m->len = CAN_MAX_DATA; }
+        m->row = row;
+        m->at_ms = HAL_GetTick();
+        can_rx_commit(m);
+    }
+}
+
+void HAL_FDCAN_RxFifo1Callback(FDCAN_HandleTypeDef* hfdcan, uint32_t its) {
+    if ((its & FDCAN_IT_RX_FIFO1_MESSAGE_LOST) != 0U) { can_note_hw_lost(1U); }
+    drain(hfdcan, FDCAN_RX_FIFO1);
+}
+
+void HAL_FDCAN_RxFifo0Callback(FDCAN_HandleTypeDef* hfdcan, uint32_t its) {
+    if ((its & FDCAN_IT_RX_FIFO0_MESSAGE_LOST) != 0U) { can_note_hw_lost(1U); }
+    drain(hfdcan, FDCAN_RX_FIFO1);   // prioritaires d’abord (le HAL appelle FIFO 0 en premier)
+    drain(hfdcan, FDCAN_RX_FIFO0);
+}
@@ -0,0 +1,33 @@
+// hw_console_stm32.c
+#include "hw_console_stm32.h"
+#include "console.h"
+
+extern UART_HandleTypeDef huart2;
+
+static uint8_t g_chunk[CON_RX_CHUNK];
+
+static void rx_arm(void) {
+    (void)HAL_UARTEx_ReceiveToIdle_IT(&huart2, g_chunk, CON_RX_CHUNK);
+}
+
+void hw_console_init(void) {
+    rx_arm();
+}
+
+// Bloc plein ou ligne au repos: octets → anneau de la console, réarme aussitôt
+// (la FIFO matérielle absorbe ce qui arrive entre-temps)
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size) {
+    if (huart->Instance != USART2) { return; }
+    console_rx_bytes(g_chunk, Size);
+    rx_arm();
+}
+
+// Une erreur bloquante (débordement) arrête la réception côté HAL
+// (RxState = READY): relance depuis la boucle principale. Masquage bref: l’ISR
+// peut réarmer entre le test et l’appel.
+void hw_console_rx_kick(void) {
+    if (huart2.RxState != HAL_UART_STATE_READY) { return; }
+    __disable_irq();
+    if (huart2.RxState == HAL_UART_STATE_READY) { rx_arm(); }
+    __enable_irq();
+}
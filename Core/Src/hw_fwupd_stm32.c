@@ -0,0 +1,214 @@
+// hw_fwupd_stm32.c
+#include "hw_fwupd_stm32.h"
+#include "fwupd.h"
+#include "stm32h5xx_ll_crc.h"
+#include "stm32h5xx_ll_iwdg.h"
+
+#define FLASH_IE    (FLASH_CR_EOPIE | FLASH_CR_WRPERRIE | FLASH_CR_PGSERRIE | FLASH_CR_STRBERRIE | FLASH_CR_INCERRIE)
+#define FLASH_ERRS  (FLASH_SR_WRPERR | FLASH_SR_PGSERR | FLASH_SR_STRBERR | FLASH_SR_INCERR)
+
+// Repère de démarrage (TAMP->BKP0R): marque + démarrages à l’essai
+#define BKP_MARK_MASK   0xFFFF0000U
+#define BKP_TRIAL       0x5A170000U
+#define BKP_REVERTED    0x5A1E0000U
+#define IWDG_RELOAD     (FWUPD_IWDG_MS / 2U)
+
+_Static_assert((IWDG_RELOAD > 0U) && (IWDG_RELOAD <= 0xFFFU), "FWUPD_IWDG_MS: 2..8190 ms");
+
+typedef enum { OP_NONE = 0, OP_ERASE, OP_PROGRAM } FlashOp;
+
+// Opération en cours (ISR)
+static volatile FlashOp g_op;
+static uint32_t         g_sector;     // secteur suivant (effacement)
+static uint32_t         g_left;       // secteurs (effacement) ou quad-mots (programmation) restants
+static uint32_t         g_dst;
+static const uint32_t*  g_src;
+static bool             g_iwdg;       // armé à ce démarrage (ne s’arrête plus)
+
+static uint32_t staged_base(void) { return FLASH_BASE + FLASH_BANK_SIZE; }
+
+// Banque physique inactive: BKSEL désigne la banque physique, l’échange
+// (SWAP_BANK) ne change que le plan d’adresses
+static uint32_t inactive_bksel(void) {
+    return ((FLASH->OPTSR_CUR & FLASH_OPTSR_SWAP_BANK) != 0U) ? 0U : FLASH_CR_BKSEL;
+}
+
+static void erase_sector(void) {
+    MODIFY_REG(FLASH->NSCR, FLASH_CR_SNB | FLASH_CR_BKSEL | FLASH_CR_PG,
+               FLASH_CR_SER | inactive_bksel() | (g_sector << FLASH_CR_SNB_Pos) | FLASH_IE);
+    SET_BIT(FLASH->NSCR, FLASH_CR_START);
+}
+
+// Un quad-mot: 4 écritures consécutives, la programmation part à la 4e
+static void program_quad(void) {
+    volatile uint32_t* dst = (volatile uint32_t*)g_dst;
+    const uint32_t primask = __get_PRIMASK();
+    SET_BIT(FLASH->NSCR, FLASH_CR_PG | FLASH_IE);
+    __disable_irq();
+    for (uint32_t i = 0U; i < 4U; i++) { dst[i] = g_src[i]; }
+    __set_PRIMASK(primask);
+    g_dst += 16U;
+    g_src += 4;
+}
+
+static void finish(bool ok) {
+    const FlashOp op = g_op;
+    CLEAR_BIT(FLASH->NSCR, FLASH_CR_SER | FLASH_CR_PG | FLASH_IE);
+    g_op = OP_NONE;
+    if (op == OP_ERASE) { fwupd_on_erase_done(ok); } else { fwupd_on_program_done(ok); }
+}
+
+void hw_fwupd_init(void) {
+    __HAL_RCC_CRC_CLK_ENABLE();
+    HAL_NVIC_SetPriority(FLASH_IRQn, FWUPD_FLASH_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(FLASH_IRQn);
+}
+
+void hw_fwupd_flash_irq(void) {
+    const uint32_t sr = FLASH->NSSR;
+    if (g_op == OP_NONE) { FLASH->NSCCR = sr & (FLASH_ERRS | FLASH_SR_EOP); return; }
+
+    if ((sr & FLASH_ERRS) != 0U) {
+        FLASH->NSCCR = sr & (FLASH_ERRS | FLASH_SR_EOP);
+        finish(false);
+        return;
+    }
+    if ((sr & FLASH_SR_EOP) == 0U) { return; }
+    FLASH->NSCCR = FLASH_CCR_CLR_EOP;
+
+    if (--g_left == 0U) { finish(true); return; }
+    if (g_op == OP_ERASE) { g_sector++; erase_sector(); } else { program_quad(); }
+}
+
+uint32_t hw_fwupd_capacity(void) {
+    return FLASH_BANK_SIZE;
+}
+
+bool hw_fwupd_erase_start(uint32_t size) {
+    if ((g_op != OP_NONE) || ((FLASH->NSSR & FLASH_SR_BSY) != 0U)) { return false; }
+    if (HAL_FLASH_Unlock() != HAL_OK) { return false; }
+    FLASH->NSCCR = FLASH_ERRS | FLASH_SR_EOP;
+    g_sector = 0U;
+    g_left = (size + FLASH_SECTOR_SIZE - 1U) / FLASH_SECTOR_SIZE;
+    g_op = OP_ERASE;
+    erase_sector();
+    return true;
+}
+
+bool hw_fwupd_program_start(uint32_t off, const uint8_t* src, uint32_t n) {
+    if ((g_op != OP_NONE) || (n == 0U) || ((n % 16U) != 0U) || (((uintptr_t)src & 3U) != 0U)) { return false; }
+    g_dst = staged_base() + off;
+    g_src = (const uint32_t*)(const void*)src;
+    g_left = n / 16U;
+    g_op = OP_PROGRAM;
+    program_quad();
+    return true;
+}
+
+// Lecture de la banque réécrite: le cache d’instructions (bus C, qui porte
+// aussi les lectures de données en flash) peut garder l’ancien contenu
+const uint8_t* hw_fwupd_staged(void) {
+    (void)HAL_ICACHE_Invalidate();
+    return (const uint8_t*)staged_base();
+}
+
+// CRC-32 (zlib). Mots complets: inversion de bits sur 32 bits = octets pris
+// dans l’ordre mémoire, bit de poids faible d’abord
+uint32_t hw_fwupd_crc32(const uint8_t* p, uint32_t n) {
+    const bool words = ((n & 3U) == 0U) && (((uintptr_t)p & 3U) == 0U);
+    LL_CRC_SetPolynomialSize(CRC, LL_CRC_POLYLENGTH_32B);
+    LL_CRC_SetPolynomialCoef(CRC, 0x04C11DB7U);
+    LL_CRC_SetInitialData(CRC, 0xFFFFFFFFU);
+    LL_CRC_SetInputDataReverseMode(CRC, words ? LL_CRC_INDATA_REVERSE_WORD : LL_CRC_INDATA_REVERSE_BYTE);
+    LL_CRC_SetOutputDataReverseMode(CRC, LL_CRC_OUTDATA_REVERSE_BIT);
+    LL_CRC_ResetCRCCalculationUnit(CRC);
+    if (words) {
+        const uint32_t* w = (const uint32_t*)(const void*)p;
+        for (uint32_t i = 0U; i < (n / 4U); i++) { LL_CRC_FeedData32(CRC, w[i]); }
+    } else {
+        for (uint32_t i = 0U; i < n; i++) { LL_CRC_FeedData8(CRC, p[i]); }
+    }
+    return ~LL_CRC_ReadData32(CRC);
+}
+
+void hw_fwupd_lock(void) {
+    (void)HAL_FLASH_Lock();
+}
+
+// Table de vecteurs de l’image en attente, liée pour FLASH_BASE: pile
+// initiale en SRAM (alignée 8, fin de RAM comprise), reset en Thumb dans l’image
+bool hw_fwupd_vectors_ok(uint32_t size) {
+    const uint32_t* v = (const uint32_t*)(const void*)hw_fwupd_staged();
+    if ((size < 8U) || (size > FLASH_BANK_SIZE)) { return false; }
+    const uint32_t sp = v[0];
+    const uint32_t rst = v[1] & ~1U;
+    return (sp > SRAM1_BASE) && (sp <= (SRAM2_BASE + SRAM2_SIZE)) && ((sp & 7U) == 0U)
+        && ((v[1] & 1U) != 0U) && (rst >= (FLASH_BASE + 8U)) && (rst < (FLASH_BASE + size));
+}
+
+static void bkp_access(void) {
+    __HAL_RCC_RTC_CLK_ENABLE();   // horloge APB de RTC/TAMP (registres de sauvegarde)
+    HAL_PWR_EnableBkUpAccess();
+}
+
+// Inverse SWAP_BANK et redémarre; ne revient qu’en cas d’échec
+static void swap_banks(void) {
+    FLASH_OBProgramInitTypeDef ob = {0};
+    ob.OptionType = OPTIONBYTE_USER;
+    ob.USERType = OB_USER_SWAP_BANK;
+    ob.USERConfig = ((FLASH->OPTSR_CUR & FLASH_OPTSR_SWAP_BANK) != 0U) ? OB_SWAP_BANK_DISABLE : OB_SWAP_BANK_ENABLE;
+
+    __disable_irq();
+    if ((HAL_FLASH_Unlock() == HAL_OK) && (HAL_FLASH_OB_Unlock() == HAL_OK)
+        && (HAL_FLASHEx_OBProgram(&ob) == HAL_OK) && (HAL_FLASH_OB_Launch() == HAL_OK)) {
+        NVIC_SystemReset();   // l’échange prend effet au redémarrage
+    }
+    (void)HAL_FLASH_OB_Lock();
+    (void)HAL_FLASH_Lock();
+    __enable_irq();
+}
+
+void hw_fwupd_commit(void) {
+    bkp_access();
+    TAMP->BKP0R = BKP_TRIAL;      // nouvelle image à l’essai, aucun démarrage
+    swap_banks();
+    TAMP->BKP0R = 0U;             // échange refusé: l’image en service reste
+}
+
+FwupdBoot hw_fwupd_boot_check(void) {
+    bkp_access();
+    const uint32_t b = TAMP->BKP0R;
+    if ((b & BKP_MARK_MASK) == BKP_REVERTED) { TAMP->BKP0R = 0U; return FWUPD_BOOT_REVERTED; }
+    if ((b & BKP_MARK_MASK) != BKP_TRIAL) { return FWUPD_BOOT_NORMAL; }
+
+    const uint32_t boots = (b & ~BKP_MARK_MASK) + 1U;
+    if (boots > FWUPD_TRIAL_BOOTS) {
+        TAMP->BKP0R = BKP_REVERTED;
+        swap_banks();             // image précédente
+        TAMP->BKP0R = 0U;         // échange refusé: rester sur celle-ci plutôt que boucler
+        return FWUPD_BOOT_NORMAL;
+    }
+    TAMP->BKP0R = BKP_TRIAL | boots;
+
+    __HAL_DBGMCU_FREEZE_IWDG();   // pas de reset sur point d’arrêt
+    LL_IWDG_Enable(IWDG);
+    LL_IWDG_EnableWriteAccess(IWDG);
+    LL_IWDG_SetPrescaler(IWDG, LL_IWDG_PRESCALER_64);
+    LL_IWDG_SetReloadCounter(IWDG, IWDG_RELOAD);
+    while (LL_IWDG_IsReady(IWDG) == 0U) { }
+    LL_IWDG_ReloadCounter(IWDG);
+    g_iwdg = true;
+    return FWUPD_BOOT_TRIAL;
+}
+
+bool hw_fwupd_trial(void) {
+    return (TAMP->BKP0R & BKP_MARK_MASK) == BKP_TRIAL;
+}
+
+void hw_fwupd_confirm(void) {
+    TAMP->BKP0R = 0U;             // l’IWDG reste armé jusqu’au prochain reset
+}
+
+void hw_fwupd_kick(void) {
+    if (g_iwdg) { LL_IWDG_ReloadCounter(IWDG); }
+}
@@ -1,22 +1,216 @@
 // hw_inputs_stm32.c
 #include "hw_inputs_stm32.h"
+#include "hw_outdrv_stm32.h"
 #include "inputs.h"
 
-// Lis brut: 1 si le GPIO est "SET", 0 sinon.
+// Sélection de l’IDR déjà lu selon le port: résolu à la compilation
+// (les GPIOx sont des adresses constantes).
+#define HW_IDR_OF(port)   (((port) == GPIOA) ? idr_a : (((port) == GPIOC) ? idr_c : idr_b))
+
+// Extrait une broche de l’instantané vers le bit de sa voie.
+// pin == NC_Pin (non câblé) → toujours 0.
+static inline uint32_t pin_to_ch(uint32_t idr, uint16_t pin, uint32_t ch) {
+    return ((idr & (uint32_t)pin) != 0U) ? INP_BIT(ch) : 0U;
+}
+
+// IDR des ports → mot compacté (bit n = INPUT_(n+1))
+static inline uint32_t idr_to_word(uint32_t idr_a, uint32_t idr_b, uint32_t idr_c) {
+    uint32_t w = 0U;
+    w |= pin_to_ch(HW_IDR_OF(INPUT_1_GPIO_Port), INPUT_1_Pin, 0U);
+    w |= pin_to_ch(HW_IDR_OF(INPUT_2_GPIO_Port), INPUT_2_Pin, 1U);
+    w |= pin_to_ch(HW_IDR_OF(INPUT_3_GPIO_Port), INPUT_3_Pin, 2U);
+    w |= pin_to_ch(HW_IDR_OF(INPUT_4_GPIO_Port), INPUT_4_Pin, 3U);
+    w |= pin_to_ch(HW_IDR_OF(INPUT_5_GPIO_Port), INPUT_5_Pin, 4U);
+    w |= pin_to_ch(HW_IDR_OF(INPUT_6_GPIO_Port), INPUT_6_Pin, 5U);
+    w |= pin_to_ch(HW_IDR_OF(INPUT_7_GPIO_Port), INPUT_7_Pin, 6U);
+    w |= pin_to_ch(HW_IDR_OF(INPUT_8_GPIO_Port), INPUT_8_Pin, 7U);
+    return w;
+}
+
+// Instantané brut: 1 si le GPIO est "SET", 0 sinon.
 // Pas d’inversion ici. L’inversion se fait dans inputs.c (active_low).
-bool hw_read_thermostat_raw(void) {
-    return (HAL_GPIO_ReadPin(TH_GPIO_Port, TH_Pin) == GPIO_PIN_SET);
+// Un seul accès IDR par port: les fils du sélecteur sont lus au même instant.
+uint32_t hw_inputs_snapshot(void) {
+    const uint32_t idr_a = GPIOA->IDR;
+    const uint32_t idr_b = GPIOB->IDR;
+    const uint32_t idr_c = GPIOC->IDR;
+    return idr_to_word(idr_a, idr_b, idr_c);
 }
 
-bool hw_read_provider_raw(void) {
-    return (HAL_GPIO_ReadPin(PROV_GPIO_Port, PROV_Pin) == GPIO_PIN_SET);
+// Voie → broche (mode EXTI: configuration et décodage des lignes)
+typedef struct {
+    GPIO_TypeDef* port;
+    uint16_t      pin;
+    IRQn_Type     irq;
+} HwInpPin;
+
+static const HwInpPin HW_PINS[INP_CH_COUNT] = {
+    { INPUT_1_GPIO_Port, INPUT_1_Pin, EXTI14_IRQn },
+    { INPUT_2_GPIO_Port, INPUT_2_Pin, EXTI13_IRQn },
+    { INPUT_3_GPIO_Port, INPUT_3_Pin, EXTI7_IRQn },
+    { INPUT_4_GPIO_Port, INPUT_4_Pin, EXTI6_IRQn },
+    { INPUT_5_GPIO_Port, INPUT_5_Pin, EXTI5_IRQn },
+    { INPUT_6_GPIO_Port, INPUT_6_Pin, EXTI4_IRQn },
+    { INPUT_7_GPIO_Port, INPUT_7_Pin, EXTI3_IRQn },
+    { INPUT_8_GPIO_Port, INPUT_8_Pin, EXTI15_IRQn },
+};
+
+#if (INP_SRC == INP_SRC_DMA)
+
+TIM_HandleTypeDef htim2;
+DMA_HandleTypeDef hdma_inp_b;
+DMA_HandleTypeDef hdma_inp_c;
+DMA_HandleTypeDef hdma_inp_a;
+
+static DMA_QListTypeDef q_inp_b, q_inp_c, q_inp_a;
+static DMA_NodeTypeDef  n_inp_b, n_inp_c, n_inp_a;
+
+// Buffers circulaires: [0..HALF) puis [HALF..2*HALF)
+static uint16_t g_smp_b[2U * INP_DMA_HALF];
+static uint16_t g_smp_c[2U * INP_DMA_HALF];
+static uint16_t g_smp_a[2U * INP_DMA_HALF];
+static uint32_t g_block[INP_DMA_HALF];
+
+// Un canal GPDMA en liste chaînée circulaire à un seul nœud:
+// IDR (demi-mot, adresse fixe) → dst[0..2*HALF), une requête timer par échantillon.
+static HAL_StatusTypeDef dma_idr_circular(DMA_HandleTypeDef* h, DMA_Channel_TypeDef* ch,
+                                          DMA_QListTypeDef* q, DMA_NodeTypeDef* node,
+                                          uint32_t request, GPIO_TypeDef* port, uint16_t* dst)
+{
+    DMA_NodeConfTypeDef nc = {0};
+    nc.NodeType = DMA_GPDMA_LINEAR_NODE;
+    nc.Init.Request = request;
+    nc.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+    nc.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    nc.Init.SrcInc = DMA_SINC_FIXED;
+    nc.Init.DestInc = DMA_DINC_INCREMENTED;
+    nc.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_HALFWORD;
+    nc.Init.DestDataWidth = DMA_DEST_DATAWIDTH_HALFWORD;
+    nc.Init.SrcBurstLength = 1;
+    nc.Init.DestBurstLength = 1;
+    nc.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+    nc.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    nc.Init.Mode = DMA_NORMAL;
+    nc.DataHandlingConfig.DataExchange = DMA_EXCHANGE_NONE;
+    nc.DataHandlingConfig.DataAlignment = DMA_DATA_RIGHTALIGN_ZEROPADDED;
+    nc.TriggerConfig.TriggerPolarity = DMA_TRIG_POLARITY_MASKED;
+    nc.SrcAddress = (uint32_t)&port->IDR;
+    nc.DstAddress = (uint32_t)dst;
+    nc.DataSize = 2U * INP_DMA_HALF * sizeof(uint16_t);
+
+    if (HAL_DMAEx_List_BuildNode(&nc, node) != HAL_OK) { return HAL_ERROR; }
+    if (HAL_DMAEx_List_InsertNode_Tail(q, node) != HAL_OK) { return HAL_ERROR; }
+    if (HAL_DMAEx_List_SetCircularMode(q) != HAL_OK) { return HAL_ERROR; }
+
+    h->Instance = ch;
+    h->InitLinkedList.Priority = DMA_LOW_PRIORITY_HIGH_WEIGHT;
+    h->InitLinkedList.LinkStepMode = DMA_LSM_FULL_EXECUTION;
+    h->InitLinkedList.LinkAllocatedPort = DMA_LINK_ALLOCATED_PORT0;
+    h->InitLinkedList.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    h->InitLinkedList.LinkedListMode = DMA_LINKEDLIST_CIRCULAR;
+    if (HAL_DMAEx_List_Init(h) != HAL_OK) { return HAL_ERROR; }
+    return HAL_DMAEx_List_LinkQ(h, q);
 }
 
-static inline bool read_or_idle(GPIO_TypeDef* port, uint16_t pin) {
-    if (pin == NC_Pin) return false; // si non câblé: niveau bas
-    return (HAL_GPIO_ReadPin(port, pin) == GPIO_PIN_SET);
+// Convertit un demi-buffer en mots compactés: décimation et mise en file seulement,
+// le debounce tourne dans la boucle principale (inputs_process)
+static void process_half(uint32_t offset) {
+    for (uint32_t i = 0U; i < INP_DMA_HALF; i++) {
+        g_block[i] = idr_to_word(g_smp_a[offset + i], g_smp_b[offset + i], g_smp_c[offset + i]);
+    }
+    inputs_process_block(g_block, INP_DMA_HALF);
+}
+
+static void dma_half_cb(DMA_HandleTypeDef* h) { (void)h; process_half(0U); }
+static void dma_cplt_cb(DMA_HandleTypeDef* h) { (void)h; process_half(INP_DMA_HALF); }
+
+void hw_inputs_dma_start(void) {
+    __HAL_RCC_GPDMA1_CLK_ENABLE();
+    __HAL_RCC_TIM2_CLK_ENABLE();
+
+    // TIM2: horloge timer APB1 = PCLK1 (APB1CLKDivider = DIV1)
+    htim2.Instance = TIM2;
+    htim2.Init.Prescaler = 0U;
+    htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim2.Init.Period = (HAL_RCC_GetPCLK1Freq() / INP_DMA_SAMPLE_HZ) - 1U;
+    htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_OC_Init(&htim2) != HAL_OK) { Error_Handler(); }
+
+    // CH1/CH2 compare juste après l’update: requêtes DMA suivantes de la même période
+    TIM_OC_InitTypeDef oc = {0};
+    oc.OCMode = TIM_OCMODE_TIMING;
+    oc.Pulse = 1U;
+    if (HAL_TIM_OC_ConfigChannel(&htim2, &oc, TIM_CHANNEL_1) != HAL_OK) { Error_Handler(); }
+    oc.Pulse = 2U;
+    if (HAL_TIM_OC_ConfigChannel(&htim2, &oc, TIM_CHANNEL_2) != HAL_OK) { Error_Handler(); }
+
+    if (dma_idr_circular(&hdma_inp_b, GPDMA1_Channel0, &q_inp_b, &n_inp_b,
+                         GPDMA1_REQUEST_TIM2_UP, GPIOB, g_smp_b) != HAL_OK) { Error_Handler(); }
+    if (dma_idr_circular(&hdma_inp_c, GPDMA1_Channel1, &q_inp_c, &n_inp_c,
+                         GPDMA1_REQUEST_TIM2_CH1, GPIOC, g_smp_c) != HAL_OK) { Error_Handler(); }
+    if (dma_idr_circular(&hdma_inp_a, GPDMA1_Channel2, &q_inp_a, &n_inp_a,
+                         GPDMA1_REQUEST_TIM2_CH2, GPIOA, g_smp_a) != HAL_OK) { Error_Handler(); }
+
+    hdma_inp_a.XferHalfCpltCallback = dma_half_cb;
+    hdma_inp_a.XferCpltCallback = dma_cplt_cb;
+    HAL_NVIC_SetPriority(GPDMA1_Channel2_IRQn, INP_DMA_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(GPDMA1_Channel2_IRQn);
+
+    if (HAL_DMAEx_List_Start(&hdma_inp_b) != HAL_OK) { Error_Handler(); }
+    if (HAL_DMAEx_List_Start(&hdma_inp_c) != HAL_OK) { Error_Handler(); }
+    if (HAL_DMAEx_List_Start_IT(&hdma_inp_a) != HAL_OK) { Error_Handler(); }
+
+    __HAL_TIM_ENABLE_DMA(&htim2, TIM_DMA_UPDATE | TIM_DMA_CC1 | TIM_DMA_CC2);
+    __HAL_TIM_ENABLE(&htim2);
+}
+
+#endif /* INP_SRC_DMA */
+
+// ---- Mode EXTI ----
+
+void hw_inputs_on_exti(uint16_t pin) {
+    uint32_t m = 0U;
+    for (uint32_t ch = 0U; ch < INP_CH_COUNT; ch++) {
+        if (HW_PINS[ch].pin == pin) { m |= INP_BIT(ch); }
+    }
+    if (m != 0U) { inputs_on_edge(m); }
+}
+
+#if (INP_SRC == INP_SRC_EXTI)
+
+// Voies dont la ligne EXTI est prise ailleurs (protection du driver de sorties):
+// surveillées par hw_inputs_exti_poll(), même sémantique qu’un front.
+static uint32_t g_poll_mask;
+static uint32_t g_poll_prev;
+
+void hw_inputs_exti_poll(void) {
+    if (g_poll_mask == 0U) { return; }
+    const uint32_t now = hw_inputs_snapshot() & g_poll_mask;
+    const uint32_t changed = now ^ g_poll_prev;
+    g_poll_prev = now;
+    if (changed != 0U) { inputs_on_edge(changed); }
+}
+
+// Seules les voies décrites par la table passent en EXTI: les autres restent
+// en entrée simple et leurs lignes ne sont pas activées.
+void hw_inputs_exti_start(void) {
+    GPIO_InitTypeDef g = {0};
+    g.Mode = GPIO_MODE_IT_RISING_FALLING;
+    g.Pull = GPIO_NOPULL;
+
+    g_poll_mask = 0U;
+    for (uint32_t m = inputs_used_mask(); m != 0U; m &= m - 1U) {
+        const uint32_t ch = (uint32_t)__builtin_ctz(m);
+        const HwInpPin* p = &HW_PINS[ch];
+        if (p->pin == NC_Pin) { continue; }
+        if ((p->pin & HW_EXTI_LINES_OUTDRV) != 0U) { g_poll_mask |= INP_BIT(ch); continue; }
+        g.Pin = p->pin;
+        HAL_GPIO_Init(p->port, &g);
+        HAL_NVIC_SetPriority(p->irq, INP_EXTI_IRQ_PRIO, 0);
+        HAL_NVIC_EnableIRQ(p->irq);
+    }
+    g_poll_prev = hw_inputs_snapshot() & g_poll_mask;
 }
 
-bool hw_read_modeA_raw(void) { return read_or_idle(MODEA_GPIO_Port, MODEA_Pin); }
-bool hw_read_modeB_raw(void) { return read_or_idle(MODEB_GPIO_Port, MODEB_Pin); }
-bool hw_read_modeC_raw(void) { return read_or_idle(MODEC_GPIO_Port, MODEC_Pin); }
+#endif /* INP_SRC_EXTI */
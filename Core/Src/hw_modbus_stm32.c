@@ -0,0 +1,128 @@
+// hw_modbus_stm32.c
+#include "hw_modbus_stm32.h"
+#include "modbus.h"
+#include "stm32h5xx_ll_crc.h"
+
+extern UART_HandleTypeDef huart1;
+
+DMA_HandleTypeDef hdma_usart1_rx;
+DMA_HandleTypeDef hdma_usart1_tx;
+
+static uint8_t g_rx[MB_ADU_MAX];
+
+static void dma_init(DMA_HandleTypeDef* h, DMA_Channel_TypeDef* ch, uint32_t req, bool rx) {
+    h->Instance = ch;
+    h->Init.Request = req;
+    h->Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+    h->Init.Direction = rx ? DMA_PERIPH_TO_MEMORY : DMA_MEMORY_TO_PERIPH;
+    h->Init.SrcInc = rx ? DMA_SINC_FIXED : DMA_SINC_INCREMENTED;
+    h->Init.DestInc = rx ? DMA_DINC_INCREMENTED : DMA_DINC_FIXED;
+    h->Init.SrcDataWidth = DMA_SRC_DATAWIDTH_BYTE;
+    h->Init.DestDataWidth = DMA_DEST_DATAWIDTH_BYTE;
+    h->Init.Priority = rx ? DMA_HIGH_PRIORITY : DMA_LOW_PRIORITY_HIGH_WEIGHT;
+    h->Init.SrcBurstLength = 1;
+    h->Init.DestBurstLength = 1;
+    h->Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+    h->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    h->Init.Mode = DMA_NORMAL;
+    if (HAL_DMA_Init(h) != HAL_OK) { Error_Handler(); }
+}
+
+// Réception armée: FIFO vidée, drapeaux d’erreur effacés, DMA sur tout le tampon
+static void rx_arm(void) {
+    USART_TypeDef* u = huart1.Instance;
+    __HAL_UART_SEND_REQ(&huart1, UART_RXDATA_FLUSH_REQUEST);
+    __HAL_UART_CLEAR_FLAG(&huart1, UART_CLEAR_RTOF | UART_CLEAR_OREF | UART_CLEAR_FEF | UART_CLEAR_NEF | UART_CLEAR_PEF);
+    if (HAL_DMA_Start_IT(&hdma_usart1_rx, (uint32_t)&u->RDR, (uint32_t)g_rx, MB_ADU_MAX) != HAL_OK) { return; }
+    SET_BIT(u->CR3, USART_CR3_DMAR);
+    SET_BIT(u->CR1, USART_CR1_RTOIE);
+}
+
+// Fin de réception (boucle principale): le canal est encore actif sauf si
+// le tampon a été rempli (trame invalide de toute façon)
+static void rx_stop(void) {
+    if (HAL_DMA_GetState(&hdma_usart1_rx) == HAL_DMA_STATE_BUSY) { (void)HAL_DMA_Abort(&hdma_usart1_rx); }
+}
+
+void hw_modbus_init(void) {
+    __HAL_RCC_GPDMA1_CLK_ENABLE();
+    __HAL_RCC_CRC_CLK_ENABLE();
+
+    huart1.Init.BaudRate = MB_UART_BAUD;
+    huart1.Init.Parity = MB_UART_PARITY;
+    huart1.Init.WordLength = (MB_UART_PARITY == UART_PARITY_NONE) ? UART_WORDLENGTH_8B : UART_WORDLENGTH_9B;
+    huart1.Init.StopBits = (MB_UART_PARITY == UART_PARITY_NONE) ? UART_STOPBITS_2 : UART_STOPBITS_1;
+    // Octets reçus pendant la réponse: écartés sans ORE bloquant
+    huart1.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_RXOVERRUNDISABLE_INIT;
+    huart1.AdvancedInit.OverrunDisable = UART_ADVFEATURE_OVERRUN_DISABLE;
+#if MB_RS485_DE
+    if (HAL_RS485Ex_Init(&huart1, UART_DE_POLARITY_HIGH, 0U, 0U) != HAL_OK) { Error_Handler(); }
+#else
+    if (HAL_UART_Init(&huart1) != HAL_OK) { Error_Handler(); }
+#endif
+    HAL_UART_ReceiverTimeout_Config(&huart1, MB_T35_BITS);
+    if (HAL_UART_EnableReceiverTimeout(&huart1) != HAL_OK) { Error_Handler(); }
+
+    dma_init(&hdma_usart1_rx, GPDMA1_Channel6, GPDMA1_REQUEST_USART1_RX, true);
+    dma_init(&hdma_usart1_tx, GPDMA1_Channel7, GPDMA1_REQUEST_USART1_TX, false);
+
+    HAL_NVIC_SetPriority(GPDMA1_Channel6_IRQn, MB_DMA_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(GPDMA1_Channel6_IRQn);
+    HAL_NVIC_SetPriority(GPDMA1_Channel7_IRQn, MB_DMA_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(GPDMA1_Channel7_IRQn);
+    HAL_NVIC_SetPriority(USART1_IRQn, MB_UART_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+
+    rx_arm();
+}
+
+void hw_modbus_uart_irq(void) {
+    USART_TypeDef* u = huart1.Instance;
+    const uint32_t isr = u->ISR;
+    const uint32_t cr1 = u->CR1;
+
+    // Silence de 3,5 caractères: trame complète (tous ses octets sont déjà en
+    // mémoire, le DMA suit RXNE bien avant l’échéance)
+    if (((isr & USART_ISR_RTOF) != 0U) && ((cr1 & USART_CR1_RTOIE) != 0U)) {
+        __HAL_UART_CLEAR_FLAG(&huart1, UART_CLEAR_RTOF);
+        CLEAR_BIT(u->CR1, USART_CR1_RTOIE);
+        CLEAR_BIT(u->CR3, USART_CR3_DMAR);
+        modbus_on_rx_frame(g_rx, (uint16_t)(MB_ADU_MAX - __HAL_DMA_GET_COUNTER(&hdma_usart1_rx)));
+    }
+
+    // Dernier bit de la réponse sorti: retour en réception
+    if (((isr & USART_ISR_TC) != 0U) && ((cr1 & USART_CR1_TCIE) != 0U)) {
+        __HAL_UART_CLEAR_FLAG(&huart1, UART_CLEAR_TCF);
+        CLEAR_BIT(u->CR1, USART_CR1_TCIE);
+        CLEAR_BIT(u->CR3, USART_CR3_DMAT);
+        rx_arm();
+    }
+}
+
+void hw_modbus_tx_start(const uint8_t* adu, uint16_t len) {
+    USART_TypeDef* u = huart1.Instance;
+    rx_stop();
+    if (HAL_DMA_Start_IT(&hdma_usart1_tx, (uint32_t)adu, (uint32_t)&u->TDR, len) != HAL_OK) { rx_arm(); return; }
+    __HAL_UART_CLEAR_FLAG(&huart1, UART_CLEAR_TCF);
+    SET_BIT(u->CR3, USART_CR3_DMAT);
+    SET_BIT(u->CR1, USART_CR1_TCIE);
+}
+
+void hw_modbus_rx_restart(void) {
+    rx_stop();
+    rx_arm();
+}
+
+// Boucle principale uniquement (modbus_poll). L’unité CRC sert aussi au
+// CRC32 de fwupd: configuration refaite à chaque appel (5 écritures registre)
+uint16_t mb_crc16(const uint8_t* p, uint32_t n) {
+    // CRC-16/MODBUS: 0x8005, init 0xFFFF, entrée réfléchie par octet, sortie réfléchie
+    LL_CRC_SetPolynomialSize(CRC, LL_CRC_POLYLENGTH_16B);
+    LL_CRC_SetPolynomialCoef(CRC, 0x8005U);
+    LL_CRC_SetInitialData(CRC, 0xFFFFU);
+    LL_CRC_SetInputDataReverseMode(CRC, LL_CRC_INDATA_REVERSE_BYTE);
+    LL_CRC_SetOutputDataReverseMode(CRC, LL_CRC_OUTDATA_REVERSE_BIT);
+    LL_CRC_ResetCRCCalculationUnit(CRC);
+    for (uint32_t i = 0U; i < n; i++) { LL_CRC_FeedData8(CRC, p[i]); }
+    return LL_CRC_ReadData16(CRC);
+}
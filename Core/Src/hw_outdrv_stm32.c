@@ -0,0 +1,198 @@
+// hw_outdrv_stm32.c
+#include "hw_outdrv_stm32.h"
+#include "outdrv.h"
+
+extern SPI_HandleTypeDef hspi2;
+
+DMA_HandleTypeDef hdma_spi2_tx;
+DMA_HandleTypeDef hdma_spi2_rx;
+
+// Mots reçus pendant la trame de chaîne en cours (écrits par le DMA RX)
+static uint16_t g_rx[OUTDRV_CHAIN_LEN];
+
+#define CS_ACTIVE()    (OUTPUT_DRV_CS_GPIO_Port->BSRR = (uint32_t)OUTPUT_DRV_CS_Pin << 16)
+#define CS_RELEASE()   (OUTPUT_DRV_CS_GPIO_Port->BSRR = (uint32_t)OUTPUT_DRV_CS_Pin)
+#define EN_OFF()       (OUTPUT_DRV_EN_GPIO_Port->BSRR = (uint32_t)OUTPUT_DRV_EN_Pin << 16)
+#define EN_ON()        (OUTPUT_DRV_EN_GPIO_Port->BSRR = (uint32_t)OUTPUT_DRV_EN_Pin)
+
+// Relevé de coupure: écrit par l’ISR de protection (priorité 0), lu en boucle principale
+static volatile OutdrvTrip g_trip;
+static volatile bool g_tripped;
+static volatile bool g_en_on;          // EN commandé par hw_outdrv_enable()
+static volatile uint32_t g_glitches;   // ISR sans front ni broche basse
+
+// Un canal GPDMA en mode normal pour une requête SPI2
+static HAL_StatusTypeDef dma_spi(DMA_HandleTypeDef* h, DMA_Channel_TypeDef* ch,
+                                 uint32_t request, uint32_t dir)
+{
+    h->Instance = ch;
+    h->Init.Request = request;
+    h->Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+    h->Init.Direction = dir;
+    h->Init.SrcInc = (dir == DMA_MEMORY_TO_PERIPH) ? DMA_SINC_INCREMENTED : DMA_SINC_FIXED;
+    h->Init.DestInc = (dir == DMA_MEMORY_TO_PERIPH) ? DMA_DINC_FIXED : DMA_DINC_INCREMENTED;
+    h->Init.SrcDataWidth = DMA_SRC_DATAWIDTH_HALFWORD;
+    h->Init.DestDataWidth = DMA_DEST_DATAWIDTH_HALFWORD;
+    h->Init.Priority = DMA_LOW_PRIORITY_HIGH_WEIGHT;
+    h->Init.SrcBurstLength = 1;
+    h->Init.DestBurstLength = 1;
+    h->Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+    h->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    h->Init.Mode = DMA_NORMAL;
+    return HAL_DMA_Init(h);
+}
+
+void hw_outdrv_init(void) {
+    __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+    CS_RELEASE();
+
+    // Trames 16 bits, mode 1 (donnée lue sur front descendant), horloge réduite
+    if (HAL_SPI_DeInit(&hspi2) != HAL_OK) { Error_Handler(); }
+    hspi2.Init.DataSize = SPI_DATASIZE_16BIT;
+    hspi2.Init.CLKPhase = SPI_PHASE_2EDGE;
+    hspi2.Init.BaudRatePrescaler = OUTDRV_SPI_PRESCALER;
+    if (HAL_SPI_Init(&hspi2) != HAL_OK) { Error_Handler(); }
+
+    if (dma_spi(&hdma_spi2_tx, GPDMA1_Channel3, GPDMA1_REQUEST_SPI2_TX, DMA_MEMORY_TO_PERIPH) != HAL_OK) { Error_Handler(); }
+    if (dma_spi(&hdma_spi2_rx, GPDMA1_Channel4, GPDMA1_REQUEST_SPI2_RX, DMA_PERIPH_TO_MEMORY) != HAL_OK) { Error_Handler(); }
+    __HAL_LINKDMA(&hspi2, hdmatx, hdma_spi2_tx);
+    __HAL_LINKDMA(&hspi2, hdmarx, hdma_spi2_rx);
+
+    HAL_NVIC_SetPriority(GPDMA1_Channel3_IRQn, OUTDRV_DMA_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(GPDMA1_Channel3_IRQn);
+    HAL_NVIC_SetPriority(GPDMA1_Channel4_IRQn, OUTDRV_DMA_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(GPDMA1_Channel4_IRQn);
+    HAL_NVIC_SetPriority(SPI2_IRQn, OUTDRV_SPI_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(SPI2_IRQn);
+
+    // Compteur de cycles pour chronométrer l’ISR de coupure (idempotent, aussi fait par App_SchedInit)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Protection: FAULT/PGOOD en EXTI front descendant (tirages externes)
+    GPIO_InitTypeDef g = {0};
+    g.Pin = OUTPUT_DRV_FAULT_Pin | OUTPUT_DRV_PGOOG_Pin;
+    g.Mode = GPIO_MODE_IT_FALLING;
+    g.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(OUTPUT_DRV_FAULT_GPIO_Port, &g);
+    HAL_NVIC_SetPriority(EXTI4_IRQn, OUTDRV_TRIP_IRQ_PRIO, 0);
+    HAL_NVIC_SetPriority(EXTI5_IRQn, OUTDRV_TRIP_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(EXTI4_IRQn);
+    HAL_NVIC_EnableIRQ(EXTI5_IRQn);
+
+    // Défaut déjà présent au boot: pas de front à venir, on déclenche nous-mêmes
+    if (((OUTPUT_DRV_FAULT_GPIO_Port->IDR & (OUTPUT_DRV_FAULT_Pin | OUTPUT_DRV_PGOOG_Pin)) !=
+         (OUTPUT_DRV_FAULT_Pin | OUTPUT_DRV_PGOOG_Pin))) {
+        __HAL_GPIO_EXTI_GENERATE_SWIT(OUTPUT_DRV_FAULT_Pin);
+    }
+}
+
+// ---- Protection matérielle ----
+
+void hw_outdrv_trip_irq(void) {
+    // 1) Coupure d’abord: rien avant, hormis l’horodatage d’entrée (corps de
+    //    l’ISR chronométré, pas le délai front → entrée)
+    const uint32_t t0 = DWT->CYCCNT;
+    EN_OFF();
+    (void)OUTPUT_DRV_EN_GPIO_Port->ODR;        // relecture: l’écriture BSRR a atteint le port
+    const uint32_t t1 = DWT->CYCCNT;
+
+    // 2) Source(s) et acquittement des fronts
+    const uint32_t fpr = EXTI->FPR1 & HW_EXTI_LINES_OUTDRV;
+    EXTI->FPR1 = fpr;
+    EXTI->RPR1 = EXTI->RPR1 & HW_EXTI_LINES_OUTDRV;   // déclenchement logiciel (SWIER) du boot
+    const uint32_t idr = OUTPUT_DRV_FAULT_GPIO_Port->IDR;
+    uint8_t pins = 0U;
+    if ((idr & OUTPUT_DRV_FAULT_Pin) != 0U) { pins |= 0x01U; }
+    if ((idr & OUTPUT_DRV_PGOOG_Pin) != 0U) { pins |= 0x02U; }
+
+    // Front reçu (même si l’impulsion est déjà retombée) ou broche basse = défaut,
+    // latché et signalé (couvre aussi le déclenchement logiciel du boot)
+    uint8_t src = 0U;
+    if (((fpr & OUTPUT_DRV_FAULT_Pin) != 0U) || ((pins & 0x01U) == 0U)) { src |= OUTDRV_TRIP_FAULT; }
+    if (((fpr & OUTPUT_DRV_PGOOG_Pin) != 0U) || ((pins & 0x02U) == 0U)) { src |= OUTDRV_TRIP_PGOOD; }
+    if (src == 0U) {
+        // Ni front ni broche basse: pas de défaut à latcher. Compté, et EN
+        // rétabli comme commandé: jamais de sorties coupées en silence
+        g_glitches++;
+        if (g_en_on && !g_tripped) { EN_ON(); }
+        return;
+    }
+
+    // 3) Relevé latché + signalement
+    if (!g_tripped) {
+        g_trip.at_ms = HAL_GetTick();
+        g_trip.source = src;
+        g_trip.pins = pins;
+        g_trip.isr_cycles = t1 - t0;
+        g_tripped = true;
+    }
+    g_trip.count++;
+
+    outdrv_on_hw_trip(src);
+}
+
+bool hw_outdrv_get_trip(OutdrvTrip* out) {
+    if ((out == NULL) || !g_tripped) { return false; }
+    __disable_irq();
+    out->count = g_trip.count;
+    out->at_ms = g_trip.at_ms;
+    out->source = g_trip.source;
+    out->pins = g_trip.pins;
+    out->isr_cycles = g_trip.isr_cycles;
+    __enable_irq();
+    return true;
+}
+
+uint32_t hw_outdrv_trip_glitches(void) {
+    return g_glitches;
+}
+
+bool hw_outdrv_clear_trip(void) {
+    const uint32_t idr = OUTPUT_DRV_FAULT_GPIO_Port->IDR;
+    if ((idr & HW_EXTI_LINES_OUTDRV) != HW_EXTI_LINES_OUTDRV) { return false; }   // défaut toujours présent
+    __disable_irq();
+    g_trip.count = 0U;
+    g_tripped = false;
+    __enable_irq();
+    return true;
+}
+
+uint32_t hw_outdrv_cycles_to_ns(uint32_t cycles) {
+    return (uint32_t)(((uint64_t)cycles * 1000000000ULL) / SystemCoreClock);
+}
+
+// Toute la chaîne en un transfert: CS tenu du premier au dernier mot, chaque
+// circuit prend le mot resté dans son registre au relâchement.
+bool hw_outdrv_xfer_start(const uint16_t* tx, uint32_t n) {
+    if ((n == 0U) || (n > OUTDRV_CHAIN_LEN)) { return false; }
+    CS_ACTIVE();
+    if (HAL_SPI_TransmitReceive_DMA(&hspi2, (const uint8_t*)tx, (uint8_t*)g_rx, (uint16_t)n) != HAL_OK) {
+        CS_RELEASE();
+        return false;
+    }
+    return true;
+}
+
+// Réactivation refusée tant qu’une coupure est latchée (voir hw_outdrv_clear_trip)
+void hw_outdrv_enable(bool on) {
+    if (!on) { g_en_on = false; EN_OFF(); return; }
+    __disable_irq();   // pas de coupure entre le test et l’écriture
+    g_en_on = true;
+    if (!g_tripped) { EN_ON(); }
+    __enable_irq();
+}
+
+// Fin de trame (EOT SPI, après le dernier bit): CS relâché puis trame suivante
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi) {
+    if (hspi->Instance != SPI2) { return; }
+    CS_RELEASE();
+    outdrv_on_xfer_done(true, g_rx);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi) {
+    if (hspi->Instance != SPI2) { return; }
+    CS_RELEASE();
+    outdrv_on_xfer_done(false, NULL);
+}
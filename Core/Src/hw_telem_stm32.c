@@ -0,0 +1,67 @@
+// hw_telem_stm32.c
+#include "hw_telem_stm32.h"
+#include "telem.h"
+
+extern UART_HandleTypeDef huart2;
+
+DMA_HandleTypeDef hdma_usart2_tx;
+
+void hw_telem_init(void) {
+    __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+    huart2.Init.BaudRate = TELEM_UART_BAUD;
+    if (HAL_UART_Init(&huart2) != HAL_OK) { Error_Handler(); }
+    if (HAL_UARTEx_SetTxFifoThreshold(&huart2, UART_TXFIFO_THRESHOLD_1_8) != HAL_OK) { Error_Handler(); }
+    if (HAL_UARTEx_EnableFifoMode(&huart2) != HAL_OK) { Error_Handler(); }
+
+    // Octets → TDR en mode normal, un bloc par slot
+    DMA_HandleTypeDef* h = &hdma_usart2_tx;
+    h->Instance = GPDMA1_Channel5;
+    h->Init.Request = GPDMA1_REQUEST_USART2_TX;
+    h->Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+    h->Init.Direction = DMA_MEMORY_TO_PERIPH;
+    h->Init.SrcInc = DMA_SINC_INCREMENTED;
+    h->Init.DestInc = DMA_DINC_FIXED;
+    h->Init.SrcDataWidth = DMA_SRC_DATAWIDTH_BYTE;
+    h->Init.DestDataWidth = DMA_DEST_DATAWIDTH_BYTE;
+    h->Init.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT;
+    h->Init.SrcBurstLength = 1;
+    h->Init.DestBurstLength = 1;
+    h->Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+    h->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    h->Init.Mode = DMA_NORMAL;
+    if (HAL_DMA_Init(h) != HAL_OK) { Error_Handler(); }
+    __HAL_LINKDMA(&huart2, hdmatx, hdma_usart2_tx);
+
+    HAL_NVIC_SetPriority(GPDMA1_Channel5_IRQn, TELEM_DMA_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(GPDMA1_Channel5_IRQn);
+    HAL_NVIC_SetPriority(USART2_IRQn, TELEM_UART_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(USART2_IRQn);
+}
+
+bool hw_telem_tx_start(const uint8_t* buf, uint16_t len) {
+    return HAL_UART_Transmit_DMA(&huart2, buf, len) == HAL_OK;
+}
+
+// Fin d’émission (TC USART: dernier octet sorti de la FIFO), slot suivant
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+    if (huart->Instance != USART2) { return; }
+    telem_on_tx_done(true);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
+    if (huart->Instance != USART2) { return; }
+    // Seule une erreur DMA concerne l’émission (HAL: émission déjà arrêtée).
+    // Les erreurs de ligne en réception sont pour la console (hw_console_rx_kick).
+    if ((huart->ErrorCode & HAL_UART_ERROR_DMA) == 0U) { return; }
+    telem_on_tx_done(false);
+}
+
+// stdout (printf) → trames TELEM_T_TEXT: remplace le _write caractère par
+// caractère de syscalls.c, ne bloque jamais (texte perdu si l’anneau est plein).
+int _write(int file, char* ptr, int len) {
+    (void)file;
+    if (len <= 0) { return 0; }
+    (void)telem_write_text(ptr, (uint32_t)len);
+    return len;
+}
@@ -1,194 +1,510 @@
 #include "inputs.h"
+#include "vdeb.h"
+#include "timers.h"
 #include <string.h>
+#include <stdatomic.h>
 
+_Static_assert((INP_SNAP_DEPTH & (INP_SNAP_DEPTH - 1U)) == 0U, "INP_SNAP_DEPTH doit être une puissance de 2");
+
+/* Table compilée en tableaux par voie (SoA): la boucle de publication ne
+   parcourt que les bits qui ont changé, sans relire les descripteurs. */
+static uint32_t  g_used;                          /* voies décrites */
+static uint32_t  g_inv;                           /* voies actives à 0 (XOR avant debounce) */
+static uint32_t  g_sel_members;                   /* voies appartenant à un sélecteur */
+static uint8_t   g_evt_rise[INP_CH_COUNT];        /* EventType, 0 = aucun */
+static uint8_t   g_evt_fall[INP_CH_COUNT];
+static uint8_t   g_pos[INP_CH_COUNT];             /* position dans son sélecteur */
+static uint16_t  g_settle_ms[INP_CH_COUNT];       /* mode EXTI: durée de stabilité */
+static uint8_t   g_unit[INP_CH_COUNT];            /* mode EXTI: voie qui porte l’échéance */
+
+static uint8_t   g_nsel;
+static uint32_t  g_sel_mask[INP_SEL_MAX];         /* fils du sélecteur */
+static uint8_t   g_sel_evt[INP_SEL_MAX][INP_SEL_MAX_POS];
+static uint8_t   g_sel_cur[INP_SEL_MAX];          /* dernière position publiée */
+
+static VDeb      g_deb;                           /* toutes les entrées, en parallèle */
+
+/* Vote k-parmi-n avant debounce: historique à décalage par voie filtrée */
+static uint32_t  g_vote_mask;                     /* voies filtrées */
+static uint32_t  g_vote_out;                      /* dernier niveau voté */
+static uint32_t  g_vote_hist[INP_CH_COUNT];       /* bit 0 = échantillon le plus récent */
+static uint32_t  g_vote_win[INP_CH_COUNT];        /* masque des N derniers échantillons */
+static uint8_t   g_vote_hi[INP_CH_COUNT];         /* ≥ hi votes → 1 */
+static uint8_t   g_vote_lo[INP_CH_COUNT];         /* ≤ lo votes → 0, entre les deux: inchangé */
+
+/* Debounce adaptatif et statistiques de bruit */
+static uint32_t  g_adaptive;                      /* voies à fenêtre adaptative */
+static uint16_t  g_win_min[INP_CH_COUNT];
+static uint16_t  g_win_max[INP_CH_COUNT];
+static uint16_t  g_glitch_period[INP_CH_COUNT];   /* parasites de la période en cours */
+static InpStats  g_stats[INP_CH_COUNT];
+static uint32_t  g_last_change_ms[INP_CH_COUNT];
+static uint32_t  g_seen;                          /* voies ayant déjà changé une fois */
+static uint32_t  g_now_ms;                        /* temps des échantillons (ou des échéances en EXTI) */
+static uint32_t  g_adapt_t0;                      /* début de la période d’évaluation */
+
+/* File d’instantanés ISR → boucle principale (un producteur, un consommateur).
+   Une entrée = "niveau logique 'level' à partir du tick 'tick'": les ticks sans
+   changement ne coûtent rien en ISR et sont rejoués par inputs_process(). */
 typedef struct {
-    /* Debounce générique */
-    uint8_t stable;     /* 0/1 stable courant (niveau logique après inversion active_low) */
-    uint8_t last_raw;   /* dernier échantillon brut (0/1, non inversé) */
-    uint16_t acc_ms;    /* ms accumulées sur la même valeur */
-    uint16_t thresh_ms; /* ms nécessaires pour considérer stable */
-    uint8_t active_low; /* inversion du niveau si besoin */
-} DebIn;
-
-/* Sélecteur 3 positions exclusives → index 0/1/2 (ELEC/GAS/BI) */
-typedef struct {
-    uint8_t stable_idx; /* 0..2 */
-    uint8_t last_idx;   /* 0..2 */
-    uint16_t acc_ms;
-    uint16_t thresh_ms;
-    uint8_t a_active_low, b_active_low, c_active_low;
-} TriSel;
+    uint32_t tick;
+    uint32_t level;
+} InpSnap;
+
+static InpSnap  g_snap[INP_SNAP_DEPTH];
+static atomic_uint_least32_t g_snap_head;         /* écrit par l’ISR */
+static atomic_uint_least32_t g_snap_tail;         /* écrit par inputs_process() */
+static atomic_uint_least32_t g_cap_tick;          /* ticks capturés (ISR) */
+static uint32_t g_cap_level;                      /* dernier niveau mis en file (ISR) */
+static atomic_uint_least32_t g_snap_overruns;     /* incrémenté par l’ISR, remis à zéro par la console */
 
-static InputsConfig g_cfg;
-static DebIn g_th;          /* thermostat */
-static DebIn g_provider;    /* provider bi-énergie */
-static TriSel g_mode;       /* sélecteur utilisateur */
+static uint32_t g_proc_tick;                      /* dernier tick rejoué */
+static uint32_t g_proc_level;                     /* niveau courant côté rejeu */
 
-/* Helpers */
-static uint8_t apply_active_low(uint8_t raw, uint8_t active_low) { return (uint8_t)(active_low ? (uint8_t)(raw == 0U) : raw); }
+/* Mode EXTI: unités (voie ou sélecteur) ayant vu un front, posté par l’ISR et
+   armé par inputs_process(): tmr_set() n’est pas réentrant face au dispatcher */
+static atomic_uint_least32_t g_edge_units;
+
+/* Décimation des sous-échantillons (inputs_process_block) */
+static uint32_t g_os_and;    /* ET des niveaux du tick en cours */
+static uint32_t g_os_or;     /* OU des niveaux du tick en cours */
+static uint32_t g_os_level;  /* dernier niveau décimé */
+static uint32_t g_os_n;      /* sous-échantillons accumulés */
+
+/* Position d’un sélecteur depuis les niveaux logiques, 255 si ambigu
+   (aucun fil ou plusieurs fils actifs: transition mécanique) */
+static uint8_t sel_position(uint8_t s, uint32_t level)
+{
+    const uint32_t on = level & g_sel_mask[s];
+    if ((on == 0U) || ((on & (on - 1U)) != 0U)) { return 255U; }
+    return g_pos[__builtin_ctz(on)];
+}
+
+static inline uint32_t ms_to_samples(uint32_t ms)
+{
+    const uint32_t n = ms / INP_TICK_MS;
+    return (n != 0U) ? n : 1U;
+}
 
-/* Lit l’index du sélecteur (0=A, 1=B, 2=C), retourne 255 si ambigu (2 ON) */
-static uint8_t mode_read_index(void)
+static void os_reset(uint32_t level)
 {
-    uint8_t a = hw_read_modeA_raw() ? 1U : 0U;
-    uint8_t b = hw_read_modeB_raw() ? 1U : 0U;
-    uint8_t c = hw_read_modeC_raw() ? 1U : 0U;
+    atomic_store_explicit(&g_snap_head, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_snap_tail, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_cap_tick, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_edge_units, 0U, memory_order_relaxed);
+    g_cap_level = level;
+    g_proc_tick = 0U;
+    g_proc_level = level;
+
+    g_os_level = level;
+    g_os_and = UINT32_MAX;
+    g_os_or = 0U;
+    g_os_n = 0U;
+}
+
+void inputs_init(const InputsConfig* cfg)
+{
+    g_used = 0U;
+    g_inv = 0U;
+    g_sel_members = 0U;
+    g_nsel = 0U;
+    (void)memset(g_evt_rise, 0, sizeof(g_evt_rise));
+    (void)memset(g_evt_fall, 0, sizeof(g_evt_fall));
+    (void)memset(g_pos, 0, sizeof(g_pos));
+    (void)memset(g_settle_ms, 0, sizeof(g_settle_ms));
+    (void)memset(g_unit, 0, sizeof(g_unit));
+    (void)memset(g_sel_mask, 0, sizeof(g_sel_mask));
+    (void)memset(g_sel_evt, 0, sizeof(g_sel_evt));
+    (void)memset(g_sel_cur, 0, sizeof(g_sel_cur));
+    (void)memset(g_win_min, 0, sizeof(g_win_min));
+    (void)memset(g_win_max, 0, sizeof(g_win_max));
+    g_adaptive = 0U;
+    g_vote_mask = 0U;
+    g_vote_out = 0U;
+    g_now_ms = 0U;
+    g_adapt_t0 = 0U;
+    inputs_reset_stats();
+    vdeb_init(&g_deb, 0U);
+    os_reset(0U);
+
+    if ((cfg == NULL) || (cfg->desc == NULL)) { return; }
+
+    /* Sélecteurs */
+    if (cfg->sel != NULL) {
+        g_nsel = (cfg->n_sel < INP_SEL_MAX) ? cfg->n_sel : (uint8_t)INP_SEL_MAX;
+        for (uint8_t s = 0U; s < g_nsel; s++) {
+            for (uint8_t p = 0U; (p < cfg->sel[s].npos) && (p < INP_SEL_MAX_POS); p++) {
+                g_sel_evt[s][p] = (uint8_t)cfg->sel[s].evt[p];
+            }
+        }
+    }
+
+    /* Entrées */
+    for (uint8_t i = 0U; i < cfg->n_desc; i++) {
+        const InpDesc* d = &cfg->desc[i];
+        const uint32_t samples = ms_to_samples(d->debounce_ms);
+        if ((d->ch >= INP_CH_COUNT) || (samples > VDEB_MAX_SAMPLES)) { continue; }
+
+        const uint32_t bit = INP_BIT(d->ch);
+        g_used |= bit;
+        if (d->active_low != 0U) { g_inv |= bit; }
+        (void)vdeb_set_threshold(&g_deb, bit, samples);
+        g_settle_ms[d->ch] = d->debounce_ms;
+        g_unit[d->ch] = d->ch;
+
+        if ((d->sel < g_nsel) && (d->pos < INP_SEL_MAX_POS)) {
+            g_sel_members |= bit;
+            g_sel_mask[d->sel] |= bit;
+            g_pos[d->ch] = d->pos;
+        } else {
+            g_evt_rise[d->ch] = (uint8_t)d->evt_rise;
+            g_evt_fall[d->ch] = (uint8_t)d->evt_fall;
 
-    a = apply_active_low(a, g_mode.a_active_low);
-    b = apply_active_low(b, g_mode.b_active_low);
-    c = apply_active_low(c, g_mode.c_active_low);
+            /* Fenêtre adaptative: bornes valides qui encadrent la valeur initiale */
+            if ((d->debounce_min_ms != 0U) && (d->debounce_min_ms <= d->debounce_ms) &&
+                (d->debounce_ms <= d->debounce_max_ms) &&
+                (ms_to_samples(d->debounce_max_ms) <= VDEB_MAX_SAMPLES)) {
+                g_adaptive |= bit;
+                g_win_min[d->ch] = d->debounce_min_ms;
+                g_win_max[d->ch] = d->debounce_max_ms;
+            }
+        }
+
+        if ((d->vote_n != 0U) && (d->vote_n <= 32U) &&
+            ((2U * d->vote_k) > d->vote_n) && (d->vote_k <= d->vote_n)) {
+            g_vote_mask |= bit;
+            g_vote_win[d->ch] = (d->vote_n == 32U) ? UINT32_MAX : ((1UL << d->vote_n) - 1UL);
+            g_vote_hi[d->ch] = d->vote_k;
+            g_vote_lo[d->ch] = (uint8_t)(d->vote_n - d->vote_k);
+        }
+    }
+
+    /* Le debounce ne compte que les voies décrites */
+    g_deb.mask = g_used;
 
-    /* Exclusif idéalement: un seul à 1 */
-    if ((a + b + c) != 1U) {
-        return 255U; /* état invalide/transition mécanique */
+    /* Mode EXTI: un sélecteur partage une seule échéance, portée par son premier fil */
+    for (uint8_t s = 0U; s < g_nsel; s++) {
+        if (g_sel_mask[s] == 0U) { continue; }
+        const uint8_t first = (uint8_t)__builtin_ctz(g_sel_mask[s]);
+        uint16_t longest = 0U;
+        for (uint32_t m = g_sel_mask[s]; m != 0U; m &= m - 1U) {
+            const uint8_t ch = (uint8_t)__builtin_ctz(m);
+            g_unit[ch] = first;
+            if (g_settle_ms[ch] > longest) { longest = g_settle_ms[ch]; }
+        }
+        g_settle_ms[first] = longest;
     }
-    if (a == 1U) return 0U;
-    if (b == 1U) return 1U;
-    return 2U; /* c == 1 */
 }
 
-static void deb_init(DebIn* d, uint8_t active_low, uint16_t thresh_ms)
+/* Historiques pleins au niveau 'level' */
+static void vote_seed(uint32_t level)
 {
-    d->stable = 0U;
-    d->last_raw = 0U;
-    d->acc_ms = 0U;
-    d->thresh_ms = thresh_ms;
-    d->active_low = active_low;
+    for (uint32_t m = g_vote_mask; m != 0U; m &= m - 1U) {
+        const uint32_t ch = (uint32_t)__builtin_ctz(m);
+        g_vote_hist[ch] = ((level & INP_BIT(ch)) != 0U) ? g_vote_win[ch] : 0U;
+    }
+    g_vote_out = level & g_vote_mask;
 }
 
-static void tris_init(TriSel* t, uint16_t thresh_ms, uint8_t a_low, uint8_t b_low, uint8_t c_low)
+/* Un échantillon dans les historiques; les voies non filtrées passent telles quelles */
+static uint32_t vote_filter(uint32_t level)
 {
-    t->stable_idx = 0U;
-    t->last_idx = 0U;
-    t->acc_ms = 0U;
-    t->thresh_ms = thresh_ms;
-    t->a_active_low = a_low;
-    t->b_active_low = b_low;
-    t->c_active_low = c_low;
+    uint32_t out = g_vote_out;
+    for (uint32_t m = g_vote_mask; m != 0U; m &= m - 1U) {
+        const uint32_t ch = (uint32_t)__builtin_ctz(m);
+        const uint32_t h = ((g_vote_hist[ch] << 1) | ((level >> ch) & 1U)) & g_vote_win[ch];
+        const uint32_t votes = (uint32_t)__builtin_popcount(h);
+        g_vote_hist[ch] = h;
+        if (votes >= g_vote_hi[ch])      { out |= INP_BIT(ch); }
+        else if (votes <= g_vote_lo[ch]) { out &= ~INP_BIT(ch); }
+        else                             { /* zone morte: niveau précédent */ }
+    }
+    g_vote_out = out;
+    return (level & ~g_vote_mask) | out;
 }
 
-void inputs_init(const InputsConfig* cfg)
+/* Vrai si les historiques ne contiennent que 'level': d’autres échantillons
+   identiques ne changeraient plus rien au vote */
+static bool vote_settled(uint32_t level)
 {
-    if (cfg != NULL) { g_cfg = *cfg; }
-    deb_init(&g_th,       g_cfg.thermostat_active_low, INP_DEBOUNCE_MS);
-    deb_init(&g_provider, g_cfg.provider_active_low,   INP_PROVIDER_STABLE_MS);
-    tris_init(&g_mode,    INP_MODE_STABLE_MS, g_cfg.modeA_active_low, g_cfg.modeB_active_low, g_cfg.modeC_active_low);
+    for (uint32_t m = g_vote_mask; m != 0U; m &= m - 1U) {
+        const uint32_t ch = (uint32_t)__builtin_ctz(m);
+        if (g_vote_hist[ch] != (((level & INP_BIT(ch)) != 0U) ? g_vote_win[ch] : 0U)) { return false; }
+    }
+    return true;
 }
 
 void inputs_seed_from_hw(void)
 {
-    /* Seed thermostat */
-    uint8_t raw = hw_read_thermostat_raw() ? 1U : 0U;
-    uint8_t lvl = apply_active_low(raw, g_th.active_low);
-    g_th.stable = lvl;
-    g_th.last_raw = raw;
-    g_th.acc_ms = g_th.thresh_ms;
-
-    /* Seed provider */
-    raw = hw_read_provider_raw() ? 1U : 0U;
-    lvl = apply_active_low(raw, g_provider.active_low);
-    g_provider.stable = lvl;
-    g_provider.last_raw = raw;
-    g_provider.acc_ms = g_provider.thresh_ms;
-
-    /* Seed mode */
-    uint8_t idx = mode_read_index();
-    if (idx != 255U) {
-        g_mode.stable_idx = idx;
-        g_mode.last_idx = idx;
-        g_mode.acc_ms = g_mode.thresh_ms;
-    } else {
-        g_mode.stable_idx = 0U;
-        g_mode.last_idx = 0U;
-        g_mode.acc_ms = 0U;
+    const uint32_t level = hw_inputs_snapshot() ^ g_inv;
+    vdeb_seed(&g_deb, level);
+    vote_seed(level);
+
+    for (uint8_t s = 0U; s < g_nsel; s++) {
+        const uint8_t pos = sel_position(s, level);
+        g_sel_cur[s] = (pos != 255U) ? pos : 0U;
     }
+    os_reset(level);
 }
 
-/* Debounce binaire 0/1 → retourne 1 si changement de 'stable' détecté, et place la nouvelle valeur dans *new_stable */
-static uint8_t deb_tick(DebIn* d, uint8_t raw_now, uint8_t* new_stable)
+uint32_t inputs_used_mask(void) { return g_used; }
+uint32_t inputs_stable(void)    { return g_deb.stable; }
+
+bool inputs_get_stats(uint8_t ch, InpStats* out)
 {
-    uint8_t changed = 0U;
-    if (raw_now == d->last_raw) {
-        if (d->acc_ms < 0xFFFFU) {
-            d->acc_ms = (uint16_t)(d->acc_ms + INP_TICK_MS);
-        }
-        if ((d->acc_ms >= d->thresh_ms) != 0U) {
-            uint8_t lvl = apply_active_low(raw_now, d->active_low);
-            if (lvl != d->stable) {
-                d->stable = lvl;
-                changed = 1U;
-                *new_stable = lvl;
-            }
-            /* On garde acc_ms saturé; pas besoin de la remettre à zéro tant que la valeur brute ne change pas */
+    if ((out == NULL) || (ch >= INP_CH_COUNT) || ((g_used & INP_BIT(ch)) == 0U)) { return false; }
+    *out = g_stats[ch];
+    out->debounce_ms = g_settle_ms[g_unit[ch]];
+    return true;
+}
+
+void inputs_reset_stats(void)
+{
+    for (uint32_t ch = 0U; ch < INP_CH_COUNT; ch++) {
+        g_stats[ch].glitches = 0U;
+        g_stats[ch].pulse_min_ms = UINT32_MAX;
+        g_stats[ch].pulse_max_ms = 0U;
+        g_glitch_period[ch] = 0U;
+    }
+    g_seen = 0U;
+    (void)atomic_exchange_explicit(&g_snap_overruns, 0U, memory_order_relaxed);
+}
+
+/* Durées entre changements stables (la première mesure part du premier changement) */
+static void note_changes(uint32_t changed)
+{
+    for (uint32_t m = changed; m != 0U; m &= m - 1U) {
+        const uint32_t ch = (uint32_t)__builtin_ctz(m);
+        if ((g_seen & INP_BIT(ch)) != 0U) {
+            const uint32_t w = g_now_ms - g_last_change_ms[ch];
+            if (w < g_stats[ch].pulse_min_ms) { g_stats[ch].pulse_min_ms = w; }
+            if (w > g_stats[ch].pulse_max_ms) { g_stats[ch].pulse_max_ms = w; }
         }
-    } else {
-        d->last_raw = raw_now;
-        d->acc_ms = INP_TICK_MS; /* on recommence l’accumulation */
+        g_seen |= INP_BIT(ch);
+        g_last_change_ms[ch] = g_now_ms;
     }
-    return changed;
 }
 
-/* Debounce 3 positions exclusives → retourne 1 si index stable change et place la nouvelle valeur dans *new_idx */
-static uint8_t tris_tick(TriSel* t, uint8_t* new_idx)
+static void note_glitches(uint32_t aborted)
 {
-    uint8_t idx = mode_read_index();
-    if (idx == 255U) {
-        /* position mécaniquement ambiguë: on remet le compteur, ne change pas stable */
-        t->acc_ms = 0U;
-        t->last_idx = 255U;
-        return 0U;
+    for (uint32_t m = aborted & g_used; m != 0U; m &= m - 1U) {
+        const uint32_t ch = (uint32_t)__builtin_ctz(m);
+        g_stats[ch].glitches++;
+        if (g_glitch_period[ch] < UINT16_MAX) { g_glitch_period[ch]++; }
     }
+}
 
-    if (idx == t->last_idx) {
-        if (t->acc_ms < 0xFFFFU) {
-            t->acc_ms = (uint16_t)(t->acc_ms + INP_TICK_MS);
+/* Une fois par INP_ADAPT_PERIOD_MS: fenêtre doublée si l’entrée a parasité au
+   moins INP_ADAPT_NOISY fois, réduite d’un quart si elle n’a pas parasité du tout.
+   Un thermostat bruité ne perd plus ses fronts; un contact propre réagit plus vite. */
+static void adapt_poll(void)
+{
+    if ((g_now_ms - g_adapt_t0) < INP_ADAPT_PERIOD_MS) { return; }
+    g_adapt_t0 = g_now_ms;
+
+    for (uint32_t m = g_adaptive; m != 0U; m &= m - 1U) {
+        const uint32_t ch = (uint32_t)__builtin_ctz(m);
+        const uint32_t n = g_glitch_period[ch];
+        uint32_t w = g_settle_ms[ch];
+        g_glitch_period[ch] = 0U;
+
+        if (n >= INP_ADAPT_NOISY) {
+            w = ((2U * w) < g_win_max[ch]) ? (2U * w) : g_win_max[ch];
+        } else if (n == 0U) {
+            const uint32_t dec = ((w / 4U) > INP_TICK_MS) ? (w / 4U) : INP_TICK_MS;
+            w = ((w - g_win_min[ch]) > dec) ? (w - dec) : g_win_min[ch];
+        } else {
+            continue;
         }
-        if ((t->acc_ms >= t->thresh_ms) != 0U) {
-            if (idx != t->stable_idx) {
-                t->stable_idx = idx;
-                *new_idx = idx;
-                return 1U;
-            }
+
+        if (w != g_settle_ms[ch]) {
+            g_settle_ms[ch] = (uint16_t)w;
+            (void)vdeb_set_threshold(&g_deb, INP_BIT(ch), ms_to_samples(w));
         }
-    } else {
-        t->last_idx = idx;
-        t->acc_ms = INP_TICK_MS;
     }
-    return 0U;
 }
 
-void inputs_tick(void)
+/* Traduit les bascules d’états stables en événements */
+static void publish_changes(uint32_t changed)
 {
-    /* 1) Thermostat -> EVT_TH_ON/OFF */
-    uint8_t newlvl = 0U;
-    uint8_t raw = hw_read_thermostat_raw() ? 1U : 0U;
-    if (deb_tick(&g_th, raw, &newlvl) != 0U) {
-        if (newlvl != 0U) {
-            (void)evq_push(EVQ_NORMAL, EVT_TH_ON, EVARG_NONE());
-        } else {
-            (void)evq_push(EVQ_NORMAL, EVT_TH_OFF, EVARG_NONE());
+    const uint32_t st = g_deb.stable;
+
+    /* 1) Entrées simples: événement de front montant/descendant de la table */
+    for (uint32_t m = changed & ~g_sel_members; m != 0U; m &= m - 1U) {
+        const uint32_t ch = (uint32_t)__builtin_ctz(m);
+        const uint8_t evt = ((st & INP_BIT(ch)) != 0U) ? g_evt_rise[ch] : g_evt_fall[ch];
+        if (evt != 0U) { (void)evq_push(EVQ_NORMAL, (EventType)evt, EVARG_NONE()); }
+    }
+
+    /* 2) Sélecteurs (fils débouncés individuellement): on ne publie qu’une
+          position valide (un seul fil actif) et différente de la précédente. */
+    if ((changed & g_sel_members) == 0U) { return; }
+    for (uint8_t s = 0U; s < g_nsel; s++) {
+        if ((changed & g_sel_mask[s]) == 0U) { continue; }
+        const uint8_t pos = sel_position(s, st);
+        if ((pos != 255U) && (pos != g_sel_cur[s])) {
+            g_sel_cur[s] = pos;
+            if (g_sel_evt[s][pos] != 0U) {
+                (void)evq_push(EVQ_NORMAL, (EventType)g_sel_evt[s][pos], EVARG_NONE());
+            }
         }
     }
+}
 
-    /* 2) Provider (stabilité longue) -> EVT_PROVIDER_TO_* */
-    raw = hw_read_provider_raw() ? 1U : 0U;
-    if (deb_tick(&g_provider, raw, &newlvl) != 0U) {
-        /* Ici 'stable' représente “ELEC=1 / GAS=0” après inversion éventuelle */
-        if (newlvl != 0U) {
-            (void)evq_push(EVQ_NORMAL, EVT_PROVIDER_TO_ELEC, EVARG_NONE());
+/* Un échantillon de debounce (niveaux logiques) */
+static void deb_step(uint32_t level)
+{
+    g_now_ms += INP_TICK_MS;
+    const uint32_t changed = vdeb_step(&g_deb, vote_filter(level));
+    if (g_deb.aborted != 0U) { note_glitches(g_deb.aborted); }
+    if (changed != 0U) {
+        note_changes(changed);
+        publish_changes(changed);
+    }
+    adapt_poll();
+}
+
+/* ---- Côté ISR: capture seulement ---- */
+
+static void snap_capture(uint32_t level)
+{
+    const uint32_t tick = atomic_load_explicit(&g_cap_tick, memory_order_relaxed) + 1U;
+
+    if (level != g_cap_level) {
+        const uint32_t head = atomic_load_explicit(&g_snap_head, memory_order_relaxed);
+        const uint32_t tail = atomic_load_explicit(&g_snap_tail, memory_order_acquire);
+        if ((head - tail) < INP_SNAP_DEPTH) {
+            g_snap[head & (INP_SNAP_DEPTH - 1U)] = (InpSnap){ tick, level };
+            atomic_store_explicit(&g_snap_head, head + 1U, memory_order_release);
+            g_cap_level = level;
         } else {
-            (void)evq_push(EVQ_NORMAL, EVT_PROVIDER_TO_GAS, EVARG_NONE());
+            /* g_cap_level inchangé: retenté au tick suivant */
+            (void)atomic_fetch_add_explicit(&g_snap_overruns, 1U, memory_order_relaxed);
         }
     }
 
-    /* 3) Sélecteur utilisateur (3 positions) -> EVT_USER_MODE_* */
-    uint8_t newidx = 0U;
-    if (tris_tick(&g_mode, &newidx) != 0U) {
-        switch (newidx) {
-            case 0U: (void)evq_push(EVQ_NORMAL, EVT_USER_MODE_ELEC, EVARG_NONE()); break;
-            case 1U: (void)evq_push(EVQ_NORMAL, EVT_USER_MODE_GAS,  EVARG_NONE()); break;
-            case 2U: (void)evq_push(EVQ_NORMAL, EVT_USER_MODE_BI,   EVARG_NONE()); break;
-            default: /* impossible */ break;
+    /* Publié après l’entrée: un tick visible côté rejeu a toujours son entrée en file */
+    atomic_store_explicit(&g_cap_tick, tick, memory_order_release);
+}
+
+void inputs_capture(void)
+{
+    snap_capture(hw_inputs_snapshot() ^ g_inv);
+}
+
+void inputs_process_block(const uint32_t* raw, uint32_t n)
+{
+    if (raw == NULL) { return; }
+
+    for (uint32_t i = 0U; i < n; i++) {
+        const uint32_t lvl = raw[i] ^ g_inv;
+        g_os_and &= lvl;
+        g_os_or  |= lvl;
+        if (++g_os_n < INP_OVERSAMPLE) { continue; }
+
+        /* Unanimes à 1 → 1, unanimes à 0 → 0, sinon on garde le niveau précédent */
+        g_os_level = g_os_and | (g_os_level & g_os_or);
+        g_os_and = UINT32_MAX;
+        g_os_or = 0U;
+        g_os_n = 0U;
+
+        snap_capture(g_os_level);
+    }
+}
+
+/* ---- Boucle principale: rejeu des ticks capturés ---- */
+
+/* Rejoue g_proc_level jusqu’au tick 'upto' inclus. Dès qu’un tick laisse toutes
+   les voies à leur état stable (votes compris), les compteurs sont à zéro et les
+   ticks suivants au même niveau ne changeraient rien: on avance le temps d’un coup. */
+static void replay_until(uint32_t upto)
+{
+    while (g_proc_tick != upto) {
+        g_proc_tick++;
+        deb_step(g_proc_level);
+        if ((((g_proc_level ^ g_deb.stable) & g_deb.mask) == 0U) && vote_settled(g_proc_level)) {
+            g_now_ms += (upto - g_proc_tick) * INP_TICK_MS;
+            g_proc_tick = upto;
+            adapt_poll();
         }
     }
 }
+
+static void edges_arm(void);
+
+void inputs_process(void)
+{
+    edges_arm();
+
+    const uint32_t now  = atomic_load_explicit(&g_cap_tick, memory_order_acquire);
+    const uint32_t head = atomic_load_explicit(&g_snap_head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&g_snap_tail, memory_order_relaxed);
+
+    while (tail != head) {
+        const InpSnap s = g_snap[tail & (INP_SNAP_DEPTH - 1U)];
+        if ((int32_t)(s.tick - now) > 0) { break; }   /* capturé après 'now': prochain passage */
+
+        replay_until(s.tick - 1U);
+        g_proc_level = s.level;
+        replay_until(s.tick);
+
+        tail++;
+        atomic_store_explicit(&g_snap_tail, tail, memory_order_release);
+    }
+    replay_until(now);
+}
+
+uint32_t inputs_snap_overruns(void) { return atomic_load_explicit(&g_snap_overruns, memory_order_relaxed); }
+
+/* ---- Mode EXTI: confirmation par échéance du service timers ----
+   Chaque front réarme l’échéance de sa voie (ou de son sélecteur): à l’expiration,
+   l’entrée n’a pas bougé depuis au moins la durée de stabilité → même sémantique
+   que le debounce par échantillonnage, sans aucun travail tant que rien ne bouge.
+   L’ISR ne fait que poster ses unités; l’échéance est armée au passage suivant de
+   inputs_process(), donc toujours après le dernier front: la stabilité tient.
+   +TMR_TICK_MS: le premier tick d’un timer peut tomber juste après l’armement. */
+void inputs_on_edge(uint32_t ch_mask)
+{
+    uint32_t units = 0U;
+    for (uint32_t m = ch_mask & g_used; m != 0U; m &= m - 1U) {
+        units |= INP_BIT(g_unit[__builtin_ctz(m)]);
+    }
+    if (units != 0U) {
+        (void)atomic_fetch_or_explicit(&g_edge_units, units, memory_order_release);
+    }
+}
+
+static void edges_arm(void)
+{
+    uint32_t units = atomic_exchange_explicit(&g_edge_units, 0U, memory_order_acquire);
+    for (; units != 0U; units &= units - 1U) {
+        const uint8_t u = (uint8_t)__builtin_ctz(units);
+        (void)tmr_set((TimerId)(TMR_INP_0 + u), (uint32_t)g_settle_ms[u] + TMR_TICK_MS,
+                      EVT_INP_SETTLE, EVARG_U8(u));
+    }
+}
+
+void inputs_on_settle(uint8_t unit, uint32_t now_ms)
+{
+    if (unit >= INP_CH_COUNT) { return; }
+    g_now_ms = now_ms;
+
+    /* Voies portées par cette échéance: la voie seule, ou tout son sélecteur */
+    uint32_t mask = 0U;
+    for (uint32_t m = g_used; m != 0U; m &= m - 1U) {
+        const uint8_t ch = (uint8_t)__builtin_ctz(m);
+        if (g_unit[ch] == unit) { mask |= INP_BIT(ch); }
+    }
+
+    const uint32_t level = hw_inputs_snapshot() ^ g_inv;
+    const uint32_t changed = (level ^ g_deb.stable) & mask;
+    if (changed != 0U) {
+        g_deb.stable ^= changed;
+        note_changes(changed);
+        publish_changes(changed);
+    } else {
+        /* Des fronts, mais retour au niveau stable: parasite */
+        note_glitches(INP_BIT(unit));
+    }
+    adapt_poll();   /* en EXTI, l’évaluation attend la prochaine échéance */
+}
@@ -0,0 +1,25 @@
+#include "inputs.h"
+#include "hw_inputs_stm32.h"   /* polarités de câblage (*_ACTIVE_LOW) */
+
+/* Sélecteurs exclusifs */
+#define SEL_USER_MODE  0U      /* sélecteur utilisateur ELEC/GAS/BI */
+
+const InpSelector INP_SELECTORS[] = {
+    [SEL_USER_MODE] = { .evt = { EVT_USER_MODE_ELEC, EVT_USER_MODE_GAS, EVT_USER_MODE_BI }, .npos = 3U },
+};
+const uint8_t INP_SELECTORS_COUNT = (uint8_t)(sizeof(INP_SELECTORS) / sizeof(INP_SELECTORS[0]));
+
+/* Une ligne par voie câblée. Ajouter une entrée = ajouter une ligne. */
+const InpDesc INP_TABLE[] = {
+    /* voie           polarité          stabilité (ms)           front montant          front descendant     sélecteur      pos  adaptatif min/max (ms)                     vote n/k */
+    { INP_CH_TH,    TH_ACTIVE_LOW,    INP_DEBOUNCE_MS,        EVT_TH_ON,             EVT_TH_OFF,          INP_SEL_NONE,  0U, INP_DEBOUNCE_MIN_MS,    INP_DEBOUNCE_MAX_MS, INP_TH_VOTE_N, INP_TH_VOTE_K },
+    { INP_CH_PROV,  PROV_ACTIVE_LOW,  INP_PROVIDER_STABLE_MS, EVT_PROVIDER_TO_ELEC,  EVT_PROVIDER_TO_GAS, INP_SEL_NONE,  0U, 0U,                     0U, 0U,            0U },
+    { INP_CH_MODEA, MODEA_ACTIVE_LOW, INP_MODE_STABLE_MS,     0,                     0,                   SEL_USER_MODE, 0U, 0U,                     0U, 0U,            0U },
+    { INP_CH_MODEB, MODEB_ACTIVE_LOW, INP_MODE_STABLE_MS,     0,                     0,                   SEL_USER_MODE, 1U, 0U,                     0U, 0U,            0U },
+    { INP_CH_MODEC, MODEC_ACTIVE_LOW, INP_MODE_STABLE_MS,     0,                     0,                   SEL_USER_MODE, 2U, 0U,                     0U, 0U,            0U },
+    /* INPUT_6..INPUT_8: débouncées et lisibles (inputs_stable), pas encore d’événement associé */
+    { INP_CH_IN6,   0U,               INP_DEBOUNCE_MS,        0,                     0,                   INP_SEL_NONE,  0U, INP_DEBOUNCE_MIN_MS,    INP_DEBOUNCE_MAX_MS, 0U,            0U },
+    { INP_CH_IN7,   0U,               INP_DEBOUNCE_MS,        0,                     0,                   INP_SEL_NONE,  0U, INP_DEBOUNCE_MIN_MS,    INP_DEBOUNCE_MAX_MS, 0U,            0U },
+    { INP_CH_IN8,   0U,               INP_DEBOUNCE_MS,        0,                     0,                   INP_SEL_NONE,  0U, INP_DEBOUNCE_MIN_MS,    INP_DEBOUNCE_MAX_MS, 0U,            0U },
+};
+const uint8_t INP_TABLE_COUNT = (uint8_t)(sizeof(INP_TABLE) / sizeof(INP_TABLE[0]));
@@ -0,0 +1,108 @@
+#include "log.h"
+#include "telem.h"
+#include <string.h>
+#include <stdatomic.h>
+
+_Static_assert((LOG_RING >= 2U) && ((LOG_RING & (LOG_RING - 1U)) == 0U),
+               "LOG_RING doit être une puissance de 2");
+_Static_assert(LOG_MAX_ARGS <= 15U, "LOG_MAX_ARGS > 15: ne tient pas dans 4 bits");
+
+/* Entrée sur la ligne: id, horodatage, niveau/nargs, args */
+#define WIRE_HDR   9U
+#define WIRE_MAX   (WIRE_HDR + (4U * LOG_MAX_ARGS))
+_Static_assert(WIRE_MAX <= TELEM_MAX_PAYLOAD, "une entrée de log doit tenir dans une trame");
+
+typedef struct {
+    uint32_t    id;
+    uint32_t    ts;
+    uint8_t     lvl;
+    uint8_t     nargs;
+    uint32_t    args[LOG_MAX_ARGS];
+    atomic_bool ready;
+} LogRec;
+
+static LogRec g_ring[LOG_RING];
+
+/* Même schéma que la télémétrie: numéros libres, réservation par CAS (producteurs),
+   g_rd avancé par log_flush() seul. */
+static atomic_uint_least32_t g_wr;
+static atomic_uint_least32_t g_rd;
+static atomic_uint_least32_t g_dropped;
+
+static void put_u32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+void log_init(void)
+{
+    for (uint32_t i = 0U; i < LOG_RING; i++) {
+        atomic_store_explicit(&g_ring[i].ready, false, memory_order_relaxed);
+    }
+    atomic_store_explicit(&g_wr, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_rd, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_dropped, 0U, memory_order_relaxed);
+}
+
+void log_write(uint8_t lvl, uint32_t id, const uint32_t* args, uint8_t nargs)
+{
+    uint32_t wr = atomic_load_explicit(&g_wr, memory_order_relaxed);
+    do {
+        if ((wr - atomic_load_explicit(&g_rd, memory_order_acquire)) >= LOG_RING) {
+            (void)atomic_fetch_add_explicit(&g_dropped, 1U, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&g_wr, &wr, wr + 1U,
+                                                    memory_order_acq_rel, memory_order_relaxed));
+
+    LogRec* r = &g_ring[wr & (LOG_RING - 1U)];
+    r->id = id;
+    r->ts = log_timestamp();
+    r->lvl = lvl;
+    r->nargs = (nargs > LOG_MAX_ARGS) ? (uint8_t)LOG_MAX_ARGS : nargs;
+    for (uint32_t i = 0U; i < r->nargs; i++) { r->args[i] = args[i]; }
+    atomic_store_explicit(&r->ready, true, memory_order_release);
+}
+
+void log_flush(void)
+{
+    uint8_t  buf[TELEM_MAX_PAYLOAD];
+    uint32_t rd = atomic_load_explicit(&g_rd, memory_order_relaxed);
+
+    for (;;) {
+        /* Entrées prêtes consécutives, autant qu’il en tient dans une trame */
+        uint32_t n = 0U;
+        uint32_t end = rd;
+        for (;;) {
+            const LogRec* r = &g_ring[end & (LOG_RING - 1U)];
+            if ((end == atomic_load_explicit(&g_wr, memory_order_acquire)) ||
+                !atomic_load_explicit(&r->ready, memory_order_acquire)) { break; }
+            const uint32_t sz = WIRE_HDR + (4U * r->nargs);
+            if ((n + sz) > TELEM_MAX_PAYLOAD) { break; }
+
+            put_u32(&buf[n], r->id);
+            put_u32(&buf[n + 4U], r->ts);
+            buf[n + 8U] = (uint8_t)((r->lvl << 4) | r->nargs);
+            for (uint32_t i = 0U; i < r->nargs; i++) { put_u32(&buf[n + WIRE_HDR + (4U * i)], r->args[i]); }
+            n += sz;
+            end++;
+        }
+        if (n == 0U) { return; }
+        if (telem_pending() >= TELEM_SLOTS) { return; }                    /* ligne saturée: on garde */
+        if (!telem_send(TELEM_T_LOG, buf, (uint16_t)n)) { return; }   /* réessayé au prochain appel */
+
+        /* Entrées rendues aux producteurs */
+        for (; rd != end; rd++) {
+            atomic_store_explicit(&g_ring[rd & (LOG_RING - 1U)].ready, false, memory_order_relaxed);
+        }
+        atomic_store_explicit(&g_rd, rd, memory_order_release);
+    }
+}
+
+uint32_t log_dropped(void)
+{
+    return atomic_load_explicit(&g_dropped, memory_order_relaxed);
+}
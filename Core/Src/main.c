@@ -31,7 +31,8 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+/* Envoi initial des registres du driver de sorties, avant EN (quelques dizaines de µs) */
+#define OUTDRV_INIT_TIMEOUT_MS  50U
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -51,7 +52,7 @@ UART_HandleTypeDef huart1;
 UART_HandleTypeDef huart2;
 
 /* USER CODE BEGIN PV */
-
+static FwupdBoot g_boot;   /* démarrage normal, à l’essai ou après retour d’image */
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -65,6 +66,10 @@ static void MX_ICACHE_Init(void);
 static void MX_TIM6_Init(void);
 /* USER CODE BEGIN PFP */
 static void App_InputsInit(void);
+static void App_OutputsInit(void);
+static void App_SchedInit(void);
+static bool App_NextEvent(EventMsg* ev);
+static void App_Dispatch(void);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -89,7 +94,7 @@ int main(void)
   HAL_Init();
 
   /* USER CODE BEGIN Init */
-
+  g_boot = hw_fwupd_boot_check();   // avant toute sortie: peut revenir à l’image précédente
   /* USER CODE END Init */
 
   /* Configure the system clock */
@@ -112,19 +117,46 @@ int main(void)
   // 1. Init des couches de service
   evq_init();              // file d’événements
   tmr_init();              // timers logiciels
+  telem_init();            // télémétrie (USART2 + DMA), stdout compris
+  hw_telem_init();
+  log_init();              // journal tokenisé (au-dessus de la télémétrie)
+  console_init();          // console de service (USART2 RX, réponses en télémétrie)
+  hw_console_init();
+  hil_init();              // banc de test: requêtes binaires sur la ligne console
 
   // 2. Init des entrées
   App_InputsInit();
  
 
 
-  // 3. Init de la FSM
-  fsm_init(ST_IDLE);       // état initial de la table FSM 
+  // 3. Init des sorties (SPI2 → circuit driver)
+  App_OutputsInit();
 
+  // 4. Réception CAN (FDCAN1: filtres matériels depuis CAN_RX_TABLE)
+  can_init();
+  hw_can_init();
+  coord_init();            // coordination des montées d’étage entre unités
+  canbulk_init();          // vidages de diagnostic en CAN FD
+  fwupd_init();            // mise à jour firmware en flux (banque inactive)
+  hw_fwupd_init();
+  modbus_init();           // esclave Modbus RTU (USART1, GTB)
+  hw_modbus_init();
 
+  // 5. Init de la FSM
+  fsm_init(ST_IDLE);       // état initial de la table FSM 
+
+  // 6. Jobs périodiques cadencés par TIM6
+  App_SchedInit();
 
   HAL_TIM_Base_Start_IT(&htim6); // démarrage du timer périodique
 
+  LOG_INF("demarrage: %u circuit(s) de sortie, RCC_RSR=%08x", OUTDRV_CHAIN_LEN, RCC->RSR);
+  if (g_boot == FWUPD_BOOT_TRIAL) {
+    LOG_WRN("image a l'essai: confirmee dans %u ms", FWUPD_CONFIRM_MS);
+  } else if (g_boot == FWUPD_BOOT_REVERTED) {
+    LOG_WRN("mise a jour non confirmee: retour a l'image precedente");
+  }
+
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -134,6 +166,7 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
+    App_Dispatch();
   }
   /* USER CODE END 3 */
 }
@@ -514,21 +547,187 @@ static void MX_GPIO_Init(void)
 /* USER CODE BEGIN 4 */
 static void App_InputsInit(void)
 {
+    /* Rôle, polarité et stabilité de chaque voie: voir inputs_table.c */
     InputsConfig cfg = {
-        .thermostat_active_low = TH_ACTIVE_LOW,
-        .provider_active_low   = PROV_ACTIVE_LOW,
-        .modeA_active_low      = MODEA_ACTIVE_LOW,
-        .modeB_active_low      = MODEB_ACTIVE_LOW,
-        .modeC_active_low      = MODEC_ACTIVE_LOW,
+        .desc  = INP_TABLE,
+        .n_desc = INP_TABLE_COUNT,
+        .sel   = INP_SELECTORS,
+        .n_sel = INP_SELECTORS_COUNT,
     };
 
     inputs_init(&cfg);
     inputs_seed_from_hw();// pour ne pas envoyer d’événements parasites au boot
+#if (INP_SRC == INP_SRC_DMA)
+    hw_inputs_dma_start(); // échantillonnage TIM2 → GPDMA, traité par demi-buffer
+#elif (INP_SRC == INP_SRC_EXTI)
+    hw_inputs_exti_start(); // fronts EXTI → échéances de stabilité (service timers)
+#endif
+}
+
+/* Driver de sorties: SPI2 reconfiguré, puis premier envoi de tous les registres
+   (valeurs à 0 = sorties coupées), terminé avant d’activer le circuit: attente
+   bornée, les trames en erreur sont relancées par outdrv_flush(). */
+static void App_OutputsInit(void)
+{
+    hw_outdrv_init();
+    outdrv_init();
+    const uint32_t t0 = HAL_GetTick();
+    while (!outdrv_idle()) {
+        if ((HAL_GetTick() - t0) >= OUTDRV_INIT_TIMEOUT_MS) { Error_Handler(); }   // bus ou circuit muet: EN jamais activé
+        outdrv_flush();
+    }
+    hw_outdrv_enable(true);
+
+    tpo_init();   // éléments à 0 %: démarrée par tpo_start() quand la chauffe le demande
+}
+
+/* Éléments modulés = sorties 0..TPO_CH_COUNT-1 du registre de commande */
+void tpo_apply(uint32_t on_mask)
+{
+    (void)outdrv_modify(OUTDRV_REG_OUT, (uint8_t)((1UL << TPO_CH_COUNT) - 1UL), (uint8_t)on_mask);
+}
+
+/* TIM6 = base de temps unique (SCHED_TICK_MS). Chaque service y est un job
+   à période entière; les phases auto évitent d’empiler les jobs lents sur le
+   même tick que les autres. */
+static void App_SchedInit(void)
+{
+    /* Compteur de cycles pour les stats de durée par slot */
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+
+    sched_init();
+#if (INP_SRC == INP_SRC_POLL)
+    (void)sched_add(inputs_capture, (uint16_t)(INP_TICK_MS / SCHED_TICK_MS), 0U);
+#elif (INP_SRC == INP_SRC_EXTI)
+    (void)sched_add(hw_inputs_exti_poll, (uint16_t)(INP_TICK_MS / SCHED_TICK_MS), 0U);
+#endif
+    (void)sched_add(tmr_tick,    (uint16_t)(TMR_TICK_MS / SCHED_TICK_MS), SCHED_PHASE_AUTO);
+    (void)sched_add(outdrv_request_diag, (uint16_t)(OUTDRV_DIAG_PERIOD_MS / SCHED_TICK_MS), SCHED_PHASE_AUTO);
+}
+
+uint32_t hw_cycle_counter(void)
+{
+    return DWT->CYCCNT;
+}
+
+uint32_t log_timestamp(void)
+{
+    return HAL_GetTick();
+}
+
+uint32_t coord_now_ms(void)
+{
+    return HAL_GetTick();
+}
+
+uint32_t canbulk_now_ms(void)
+{
+    return HAL_GetTick();
+}
+
+uint32_t fwupd_now_ms(void)
+{
+    return HAL_GetTick();
+}
+
+#if HIL_ENABLE
+uint32_t hil_now_ms(void)
+{
+    return HAL_GetTick();
+}
+#endif
+
+/* État diffusé aux autres unités: éléments visés = les 3 en chauffe électrique */
+void coord_local(uint8_t* state, uint8_t* stages, uint8_t* demand)
+{
+    const FsmState st = fsm_state();
+    *state  = (uint8_t)st;
+    *stages = fsm_stages();
+    *demand = ((st == ST_STARTING) || (st == ST_HEAT_ELEC)) ? 3U : 0U;
+}
+
+/* Ordre de service: FAULTS, défauts relus du driver de sorties, puis expirations
+   de timers (bitmap), trames CAN reçues, puis NORMAL. Les deux premières
+   sources ne sont jamais retenues par le banc de test. */
+static bool App_NextFault(EventMsg* ev)
+{
+    if (evq_pop(EVQ_FAULTS, ev)) { return true; }
+    return outdrv_pop_fault(ev);
+}
+
+static bool App_NextEvent(EventMsg* ev)
+{
+    if (tmr_pop_expired(ev))     { return true; }
+    if (can_pop_rx(ev))          { return true; }
+    return evq_pop(EVQ_NORMAL, ev);
+}
+
+static void App_Serve(const EventMsg* ev)
+{
+    /* Événements internes aux services: pas pour la FSM */
+    if (ev->type == EVT_INP_SETTLE) { inputs_on_settle(ev->arg.u8, ev->tick * TMR_TICK_MS); return; }
+    if (ev->type == EVT_TPO_EDGE)   { tpo_on_edge(); return; }
+    if (ev->type == EVT_COORD_RX)   { coord_on_rx(can_msg(ev->arg.u8)); return; }
+    if (ev->type == EVT_COORD_TICK) { coord_on_tick(); return; }
+    if (ev->type == EVT_CANBULK_RX) { canbulk_on_rx(can_msg(ev->arg.u8)); return; }
+    if (ev->type == EVT_FWUPD_RX)   { fwupd_on_rx(can_msg(ev->arg.u8)); return; }
+
+    if (!fsm_handle_event(ev)) { evq_note_ignored(ev->type); }
+}
+
+static void App_Dispatch(void)
+{
+    EventMsg ev;
+
+    /* Debounce et événements d’entrées: hors ISR, sur les instantanés en file */
+    inputs_process();
+
+    /* Sorties: relance des trames en attente (après une erreur de transfert) */
+    outdrv_flush();
+
+    /* Modbus: requête servie avant les événements (délai de réponse) */
+    modbus_poll();
+
+    /* Défauts d’abord, toujours servis; le reste passe par le banc de test
+       (gel / pas-à-pas, hil.h), sinon toujours ouvert */
+    for (;;) {
+        if (App_NextFault(&ev)) { App_Serve(&ev); continue; }
+        if (!hil_gate() || !App_NextEvent(&ev)) { break; }
+        hil_on_dispatch(&ev);
+        App_Serve(&ev);
+    }
+
+    /* Transfert de masse: remplit la fenêtre, après le trafic de commande */
+    canbulk_poll();
+
+    /* Mise à jour: enchaîne effacement / programmation / vérification */
+    fwupd_poll();
+
+    /* Banc de test: réponse du pas-à-pas, une fois les événements servis */
+    hil_poll();
+
+    /* Console: lignes reçues, budget borné (une injection est servie au passage suivant) */
+    console_poll();
+
+    /* Journal: mise en trames une fois les événements servis */
+    log_flush();
+}
+
+void HAL_GPIO_EXTI_Rising_Callback(uint16_t GPIO_Pin)
+{
+    hw_inputs_on_exti(GPIO_Pin);
+}
+
+void HAL_GPIO_EXTI_Falling_Callback(uint16_t GPIO_Pin)
+{
+    hw_inputs_on_exti(GPIO_Pin);
 }
 
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
-    if (htim->Instance == TIM6) { inputs_tick(); }   // tick des timers logiciels
+    if (htim->Instance == TIM6) { sched_tick(); }   // capture des entrées, timers logiciels, ...
 }
 
 /* USER CODE END 4 */
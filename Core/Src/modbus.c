@@ -0,0 +1,175 @@
+#include "modbus.h"
+#include <string.h>
+#include <stdatomic.h>
+
+/* Trame reçue, publiée par l’ISR */
+static const uint8_t* volatile g_rx;
+static volatile uint16_t g_rx_len;
+static atomic_bool g_rx_ready;
+
+/* Réponse: reste valide jusqu’à la fin de l’émission (réception coupée entre-temps) */
+static uint8_t g_tx[MB_ADU_MAX];
+
+static MbStats g_stats;
+
+void modbus_init(void)
+{
+    g_rx = NULL;
+    g_rx_len = 0U;
+    atomic_store_explicit(&g_rx_ready, false, memory_order_relaxed);
+    (void)memset(&g_stats, 0, sizeof(g_stats));
+}
+
+void modbus_on_rx_frame(const uint8_t* adu, uint16_t len)
+{
+    if (atomic_load_explicit(&g_rx_ready, memory_order_relaxed)) { g_stats.rx_overrun++; return; }
+    g_rx = adu;
+    g_rx_len = len;
+    atomic_store_explicit(&g_rx_ready, true, memory_order_release);
+}
+
+static uint16_t get16(const uint8_t* p) { return (uint16_t)(((uint16_t)p[0] << 8) | p[1]); }
+static void     put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v; }
+
+/* Ligne contenant l’adresse a, ou NULL */
+static const MbReg* find_reg(const MbReg* t, uint8_t n, uint16_t a)
+{
+    for (uint8_t i = 0U; i < n; i++) {
+        if (a < t[i].addr) { break; }   /* table triée */
+        if ((uint32_t)a < ((uint32_t)t[i].addr + t[i].words)) { return &t[i]; }
+    }
+    return NULL;
+}
+
+/* Plage [start, start + qty) au-delà de 0xFFFF: refusée, jamais repliée sur 0 */
+static bool range_ok(uint16_t start, uint16_t qty)
+{
+    return ((uint32_t)start + qty) <= 0x10000UL;
+}
+
+/* Lecture de qty registres depuis start dans out. Une paire 32 bits est lue
+   une seule fois: ses deux mots sont cohérents. */
+static uint8_t read_regs(const MbReg* t, uint8_t n, uint16_t start, uint16_t qty, uint8_t* out)
+{
+    const MbReg* r = NULL;
+    uint32_t v = 0U;
+    if (!range_ok(start, qty)) { return MB_EX_ILLEGAL_ADDRESS; }
+    for (uint32_t a = start; a < ((uint32_t)start + qty); a++) {
+        if ((r == NULL) || (a >= ((uint32_t)r->addr + r->words))) {
+            r = find_reg(t, n, (uint16_t)a);
+            if (r == NULL) { return MB_EX_ILLEGAL_ADDRESS; }
+            v = r->rd();
+        }
+        const uint32_t shift = 16U * ((uint32_t)r->addr + r->words - 1U - a);
+        put16(out, (uint16_t)(v >> shift));
+        out += 2;
+    }
+    return 0U;
+}
+
+/* Registre inscriptible: un mot, fonction d’écriture présente */
+static const MbReg* writable(uint16_t a)
+{
+    const MbReg* r = find_reg(MB_HOLDING_REGS, MB_HOLDING_REGS_COUNT, a);
+    return ((r != NULL) && (r->words == 1U) && (r->wr != NULL)) ? r : NULL;
+}
+
+/* Sert la PDU req (n octets, code fonction compris), écrit la PDU de réponse
+   dans rsp. Retourne sa longueur, code d’exception dans *ex. */
+static uint16_t serve(const uint8_t* req, uint16_t n, uint8_t* rsp, uint8_t* ex)
+{
+    const uint8_t fc = req[0];
+    *ex = 0U;
+    rsp[0] = fc;
+
+    switch (fc) {
+    case MB_FC_READ_HOLDING:
+    case MB_FC_READ_INPUT: {
+        if (n != 5U) { *ex = MB_EX_ILLEGAL_VALUE; return 0U; }
+        const uint16_t start = get16(&req[1]);
+        const uint16_t qty = get16(&req[3]);
+        if ((qty == 0U) || (qty > 125U)) { *ex = MB_EX_ILLEGAL_VALUE; return 0U; }
+        *ex = (fc == MB_FC_READ_INPUT)
+            ? read_regs(MB_INPUT_REGS, MB_INPUT_REGS_COUNT, start, qty, &rsp[2])
+            : read_regs(MB_HOLDING_REGS, MB_HOLDING_REGS_COUNT, start, qty, &rsp[2]);
+        rsp[1] = (uint8_t)(2U * qty);
+        return (uint16_t)(2U + (2U * qty));
+    }
+    case MB_FC_WRITE_SINGLE: {
+        if (n != 5U) { *ex = MB_EX_ILLEGAL_VALUE; return 0U; }
+        const MbReg* r = writable(get16(&req[1]));
+        if (r == NULL) { *ex = MB_EX_ILLEGAL_ADDRESS; return 0U; }
+        *ex = r->wr(get16(&req[3]));
+        if (*ex != 0U) { return 0U; }
+        (void)memcpy(&rsp[1], &req[1], 4U);   /* écho */
+        return 5U;
+    }
+    case MB_FC_WRITE_MULTIPLE: {
+        if (n < 6U) { *ex = MB_EX_ILLEGAL_VALUE; return 0U; }
+        const uint16_t start = get16(&req[1]);
+        const uint16_t qty = get16(&req[3]);
+        if ((qty == 0U) || (qty > 123U) || (req[5] != (2U * qty)) || (n != (6U + (2U * qty)))) {
+            *ex = MB_EX_ILLEGAL_VALUE; return 0U;
+        }
+        /* Toutes les adresses d’abord: pas d’écriture partielle sur adresse invalide.
+           Une valeur refusée arrête la requête, les registres précédents restent écrits. */
+        if (!range_ok(start, qty)) { *ex = MB_EX_ILLEGAL_ADDRESS; return 0U; }
+        for (uint32_t i = 0U; i < qty; i++) {
+            if (writable((uint16_t)(start + i)) == NULL) { *ex = MB_EX_ILLEGAL_ADDRESS; return 0U; }
+        }
+        for (uint32_t i = 0U; i < qty; i++) {
+            *ex = writable((uint16_t)(start + i))->wr(get16(&req[6U + (2U * i)]));
+            if (*ex != 0U) { return 0U; }
+        }
+        (void)memcpy(&rsp[1], &req[1], 4U);
+        return 5U;
+    }
+    default:
+        *ex = MB_EX_ILLEGAL_FUNCTION;
+        return 0U;
+    }
+}
+
+void modbus_poll(void)
+{
+    if (!atomic_load_explicit(&g_rx_ready, memory_order_acquire)) { return; }
+    const uint8_t* adu = g_rx;
+    const uint16_t len = g_rx_len;
+    bool reply = false;
+    uint16_t n = 0U;
+
+    if (len < 4U) {
+        g_stats.short_frames++;
+    } else if ((adu[0] != MB_SLAVE_ADDR) && (adu[0] != 0U)) {
+        g_stats.other_addr++;   /* CRC non calculé: la trame ne nous concerne pas */
+    } else if (mb_crc16(adu, len - 2U) != (uint16_t)(adu[len - 2U] | ((uint16_t)adu[len - 1U] << 8))) {
+        g_stats.crc_errors++;
+    } else {
+        uint8_t ex;
+        g_stats.frames++;
+        n = serve(&adu[1], (uint16_t)(len - 3U), &g_tx[1], &ex);
+        if (ex != 0U) {
+            g_stats.exceptions++;
+            g_tx[1] = (uint8_t)(adu[1] | 0x80U);
+            g_tx[2] = ex;
+            n = 2U;
+        }
+        reply = (adu[0] != 0U);   /* diffusion: servie, sans réponse */
+    }
+
+    atomic_store_explicit(&g_rx_ready, false, memory_order_release);
+    if (!reply) { hw_modbus_rx_restart(); return; }
+
+    g_tx[0] = MB_SLAVE_ADDR;
+    n++;
+    const uint16_t crc = mb_crc16(g_tx, n);
+    g_tx[n++] = (uint8_t)crc;          /* CRC: poids faible en premier */
+    g_tx[n++] = (uint8_t)(crc >> 8);
+    hw_modbus_tx_start(g_tx, n);
+}
+
+void modbus_get_stats(MbStats* out)
+{
+    if (out == NULL) { return; }
+    *out = g_stats;
+}
@@ -0,0 +1,81 @@
+#include "modbus.h"
+#include "events.h"
+#include "fsm.h"
+#include "inputs.h"
+#include "tpo.h"
+#include "outdrv.h"
+#include "telem.h"
+#include "can_svc.h"
+
+/* Carte des registres GTB. Ajouter un registre = une fonction de lecture + une
+   ligne (adresses croissantes). Valeurs 32 bits: deux registres, poids fort
+   en premier. Les écritures passent par la file d’événements, comme un
+   producteur réel: la FSM reste seule maître de son état. */
+
+static uint32_t rd_state(void)   { return (uint32_t)fsm_state(); }
+static uint32_t rd_stages(void)  { return fsm_stages(); }
+static uint32_t rd_inputs(void)  { return inputs_stable(); }
+static uint32_t rd_tpo(void)     { return tpo_outputs(); }
+static uint32_t rd_outdrv(void)  { return outdrv_dev_status(0U); }
+
+static uint32_t rd_evq_drop(void)    { EvQueueStats s; evq_get_stats(EVQ_NORMAL, &s); return s.dropped; }
+static uint32_t rd_evq_fdrop(void)   { EvQueueStats s; evq_get_stats(EVQ_FAULTS, &s); return s.dropped; }
+static uint32_t rd_snap_ovr(void)    { return inputs_snap_overruns(); }
+static uint32_t rd_can_rx(void)      { CanStats s; can_get_stats(&s); return s.received; }
+static uint32_t rd_can_lost(void)    { CanStats s; can_get_stats(&s); return s.hw_lost + s.pool_empty; }
+static uint32_t rd_telem_drop(void)  { TelemStats s; telem_get_stats(&s); return s.dropped; }
+static uint32_t rd_mb_frames(void)   { MbStats s; modbus_get_stats(&s); return s.frames; }
+static uint32_t rd_mb_crc(void)      { MbStats s; modbus_get_stats(&s); return s.crc_errors; }
+
+/* Mode demandé par la GTB: 1 = électrique, 2 = gaz, 3 = bi-énergie (0 = aucun) */
+static uint16_t g_mode_req;
+
+static uint32_t rd_mode(void) { return g_mode_req; }
+
+/* Puissance par élément demandée (pour-mille, TPO_DUTY_MAX = pleine puissance) */
+static uint16_t g_power_req = TPO_DUTY_MAX;
+
+static uint32_t rd_power(void) { return g_power_req; }
+
+/* File pleine: occupé (06), la GTB refait l’écriture; rien n’est retenu */
+static uint8_t wr_mode(uint16_t v)
+{
+    static const EventType EVT[] = { EVT_USER_MODE_ELEC, EVT_USER_MODE_GAS, EVT_USER_MODE_BI };
+    if ((v == 0U) || (v > 3U)) { return MB_EX_ILLEGAL_VALUE; }
+    const EventArg a = { 0U, 0U };
+    if (!evq_push(EVQ_NORMAL, EVT[v - 1U], a)) { return MB_EX_DEVICE_BUSY; }
+    g_mode_req = v;
+    return 0U;
+}
+
+static uint8_t wr_power(uint16_t v)
+{
+    if (v > TPO_DUTY_MAX) { return MB_EX_ILLEGAL_VALUE; }
+    if (!evq_push(EVQ_NORMAL, EVT_POWER_SET, EVARG_U16(v))) { return MB_EX_DEVICE_BUSY; }
+    g_power_req = v;
+    return 0U;
+}
+
+const MbReg MB_INPUT_REGS[] = {
+    /* adresse  mots  lecture         écriture */
+    { 0x0000U,  1U,   rd_state,       NULL },   /* état FSM (FsmState) */
+    { 0x0001U,  1U,   rd_stages,      NULL },   /* éléments commandés */
+    { 0x0002U,  2U,   rd_inputs,      NULL },   /* entrées stables (bit n = voie n) */
+    { 0x0004U,  1U,   rd_tpo,         NULL },   /* sorties de modulation */
+    { 0x0005U,  1U,   rd_outdrv,      NULL },   /* état du driver de sorties (circuit 0) */
+    { 0x0100U,  2U,   rd_evq_drop,    NULL },   /* compteurs de pertes / trafic */
+    { 0x0102U,  2U,   rd_evq_fdrop,   NULL },
+    { 0x0104U,  2U,   rd_snap_ovr,    NULL },
+    { 0x0106U,  2U,   rd_can_rx,      NULL },
+    { 0x0108U,  2U,   rd_can_lost,    NULL },
+    { 0x010AU,  2U,   rd_telem_drop,  NULL },
+    { 0x010CU,  2U,   rd_mb_frames,   NULL },
+    { 0x010EU,  2U,   rd_mb_crc,      NULL },
+};
+const uint8_t MB_INPUT_REGS_COUNT = (uint8_t)(sizeof(MB_INPUT_REGS) / sizeof(MB_INPUT_REGS[0]));
+
+const MbReg MB_HOLDING_REGS[] = {
+    { 0x0000U,  1U,   rd_mode,        wr_mode },   /* mode demandé */
+    { 0x0001U,  1U,   rd_power,       wr_power },  /* puissance par élément (‰) */
+};
+const uint8_t MB_HOLDING_REGS_COUNT = (uint8_t)(sizeof(MB_HOLDING_REGS) / sizeof(MB_HOLDING_REGS[0]));
@@ -0,0 +1,282 @@
+#include "outdrv.h"
+#include <string.h>
+#include <stdatomic.h>
+
+_Static_assert(OUTDRV_REG_COUNT <= 32U, "OUTDRV_REG_COUNT > 32: masque dirty trop petit");
+_Static_assert((OUTDRV_CHAIN_LEN >= 1U) && (OUTDRV_CHAIN_LEN <= 255U), "OUTDRV_CHAIN_LEN hors bornes");
+
+static uint8_t  g_want[OUTDRV_CHAIN_LEN][OUTDRV_REG_COUNT];     /* valeurs voulues (applicatif) */
+static uint8_t  g_shadow[OUTDRV_CHAIN_LEN][OUTDRV_REG_COUNT];   /* dernières valeurs transmises avec succès */
+static volatile uint32_t g_known;             /* adresses dont g_shadow reflète toute la chaîne */
+
+/* Adresses à transmettre: bit i = registre i, pour toute la chaîne (une trame
+   de chaîne réécrit la même adresse dans chaque circuit, modifié ou non).
+   Posé par outdrv_dev_write() (boucle principale), retiré au lancement de la trame (ISR ou main). */
+static atomic_uint_least32_t g_dirty;
+
+/* Bus occupé: pris par celui qui lance une trame, rendu en fin de transfert */
+static atomic_bool g_busy;
+
+/* Lecture de diagnostic demandée (posée par outdrv_request_diag) */
+static atomic_bool g_diag_req;
+
+/* Relecture: octet d’état courant et défauts à livrer au dispatcher, par circuit.
+   Bit i de g_fault_pending[dev] = FAULT_KINDS[i]. */
+static volatile uint8_t g_status[OUTDRV_CHAIN_LEN];
+static atomic_uint_least32_t g_fault_pending[OUTDRV_CHAIN_LEN];
+
+static const struct {
+    uint8_t   bit;
+    EventType evt;
+} FAULT_KINDS[] = {
+    { OUTDRV_ST_OVERCURRENT, EVT_FAULT_OUT_OVERCURRENT },
+    { OUTDRV_ST_OPEN_LOAD,   EVT_FAULT_OUT_OPEN_LOAD },
+    { OUTDRV_ST_THERMAL,     EVT_FAULT_OUT_THERMAL },
+    { 0U,                    EVT_FAULT_OUT_DRIVER },   /* broches: outdrv_on_hw_trip() */
+    { 0U,                    EVT_FAULT_OUT_POWER },
+};
+#define FAULT_IDX_DRIVER  3U
+#define FAULT_IDX_POWER   4U
+#define FAULT_KIND_COUNT  (sizeof(FAULT_KINDS) / sizeof(FAULT_KINDS[0]))
+
+#define TX_REG_READ  0xFFU                    /* g_tx_reg: trame de lecture, pas d’écriture */
+
+static uint8_t  g_tx_reg;                     /* trame en cours */
+static uint8_t  g_tx_val[OUTDRV_CHAIN_LEN];
+static uint16_t g_tx_frame[OUTDRV_CHAIN_LEN];  /* mots de la trame, ordre du bus (lus par le DMA) */
+static OutdrvStats g_stats;
+
+#define ALL_REGS  ((OUTDRV_REG_COUNT == 32U) ? UINT32_MAX : ((1UL << OUTDRV_REG_COUNT) - 1UL))
+
+/* Vrai si l’adresse reg est déjà en place dans toute la chaîne */
+static bool chain_in_place(uint32_t reg)
+{
+    if ((g_known & (1UL << reg)) == 0U) { return false; }
+    for (uint32_t dev = 0U; dev < OUTDRV_CHAIN_LEN; dev++) {
+        if (g_want[dev][reg] != g_shadow[dev][reg]) { return false; }
+    }
+    return true;
+}
+
+/* Lance la trame de chaîne de l’adresse en attente la plus basse.
+   Appelable depuis la boucle principale et depuis l’ISR de fin de transfert:
+   le premier qui prend g_busy a le bus, l’autre repart sans rien faire. */
+static void start_next(void)
+{
+    for (;;) {
+        if (atomic_exchange_explicit(&g_busy, true, memory_order_acquire)) { return; }
+
+        const uint32_t dirty = atomic_load_explicit(&g_dirty, memory_order_acquire);
+        if (dirty != 0U) {
+            const uint32_t reg = (uint32_t)__builtin_ctz(dirty);
+            (void)atomic_fetch_and_explicit(&g_dirty, ~(1UL << reg), memory_order_acq_rel);
+            if (chain_in_place(reg)) {
+                /* Revenu à la valeur en place avant d’être envoyé */
+                atomic_store_explicit(&g_busy, false, memory_order_release);
+                continue;
+            }
+            g_tx_reg = (uint8_t)reg;
+            for (uint32_t dev = 0U; dev < OUTDRV_CHAIN_LEN; dev++) {
+                g_tx_val[dev] = g_want[dev][reg];
+                g_tx_frame[OUTDRV_CHAIN_SLOT(dev)] = OUTDRV_FRAME_WR(reg, g_tx_val[dev]);
+            }
+            if (hw_outdrv_xfer_start(g_tx_frame, OUTDRV_CHAIN_LEN)) { return; }
+
+            /* Refus du backend: on remet le bit, le prochain flush réessaiera */
+            (void)atomic_fetch_or_explicit(&g_dirty, 1UL << reg, memory_order_acq_rel);
+            g_stats.errors++;
+            atomic_store_explicit(&g_busy, false, memory_order_release);
+            return;
+        }
+
+        /* Rien à écrire: lecture de diagnostic si demandée */
+        if (atomic_exchange_explicit(&g_diag_req, false, memory_order_acq_rel)) {
+            g_tx_reg = TX_REG_READ;
+            for (uint32_t i = 0U; i < OUTDRV_CHAIN_LEN; i++) { g_tx_frame[i] = OUTDRV_FRAME_RD(OUTDRV_REG_DIAG); }
+            if (hw_outdrv_xfer_start(g_tx_frame, OUTDRV_CHAIN_LEN)) { return; }
+            g_stats.errors++;
+        }
+
+        atomic_store_explicit(&g_busy, false, memory_order_release);
+        /* Un bit a pu être posé entre la lecture et la libération: on repasse */
+        if (atomic_load_explicit(&g_dirty, memory_order_acquire) == 0U) { return; }
+    }
+}
+
+void outdrv_init(void)
+{
+    (void)memset(g_want, 0, sizeof(g_want));
+    (void)memset(g_shadow, 0, sizeof(g_shadow));
+    (void)memset(&g_stats, 0, sizeof(g_stats));
+    g_known = 0U;
+    atomic_store_explicit(&g_busy, false, memory_order_relaxed);
+    atomic_store_explicit(&g_diag_req, false, memory_order_relaxed);
+    for (uint32_t dev = 0U; dev < OUTDRV_CHAIN_LEN; dev++) {
+        atomic_store_explicit(&g_fault_pending[dev], 0U, memory_order_relaxed);
+        g_status[dev] = 0U;
+    }
+    atomic_store_explicit(&g_dirty, ALL_REGS, memory_order_relaxed);
+}
+
+bool outdrv_dev_write(uint8_t dev, uint8_t reg, uint8_t val)
+{
+    if ((dev >= OUTDRV_CHAIN_LEN) || (reg >= OUTDRV_REG_COUNT)) { return false; }
+
+    const uint32_t bit = 1UL << reg;
+    g_want[dev][reg] = val;
+
+    /* Référence = valeur en vol si cette adresse est sur le bus, sinon valeur en place.
+       Si la trame se termine entre-temps, la fin de transfert revérifie: au pire une
+       trame redondante, jamais une valeur perdue. */
+    const bool in_flight = atomic_load_explicit(&g_busy, memory_order_acquire) && (g_tx_reg == reg);
+
+    bool changed = ((g_known & bit) == 0U);
+    for (uint32_t d = 0U; (d < OUTDRV_CHAIN_LEN) && !changed; d++) {
+        const uint8_t ref = in_flight ? g_tx_val[d] : g_shadow[d][reg];
+        changed = (g_want[d][reg] != ref);
+    }
+
+    if (changed) {
+        const uint32_t prev = atomic_fetch_or_explicit(&g_dirty, bit, memory_order_acq_rel);
+        if ((prev & bit) != 0U) { g_stats.skipped++; }   /* déjà en file: une seule trame */
+    } else {
+        /* Retour à la valeur en place: une écriture en file devient inutile.
+           Si une trame de cette adresse est en vol, la fin de transfert revérifie. */
+        (void)atomic_fetch_and_explicit(&g_dirty, ~bit, memory_order_acq_rel);
+        g_stats.skipped++;
+    }
+
+    outdrv_flush();
+    return true;
+}
+
+bool outdrv_dev_modify(uint8_t dev, uint8_t reg, uint8_t clr, uint8_t set)
+{
+    if ((dev >= OUTDRV_CHAIN_LEN) || (reg >= OUTDRV_REG_COUNT)) { return false; }
+    return outdrv_dev_write(dev, reg, (uint8_t)((g_want[dev][reg] & (uint8_t)~clr) | set));
+}
+
+uint8_t outdrv_dev_get(uint8_t dev, uint8_t reg)
+{
+    return ((dev < OUTDRV_CHAIN_LEN) && (reg < OUTDRV_REG_COUNT)) ? g_want[dev][reg] : 0U;
+}
+
+void outdrv_flush(void)
+{
+    if (atomic_load_explicit(&g_dirty, memory_order_acquire) != 0U) { start_next(); }
+}
+
+bool outdrv_idle(void)
+{
+    return (atomic_load_explicit(&g_dirty, memory_order_acquire) == 0U) &&
+           !atomic_load_explicit(&g_busy, memory_order_acquire);
+}
+
+void outdrv_get_stats(OutdrvStats* out)
+{
+    if (out != NULL) { *out = g_stats; }
+}
+
+void outdrv_request_diag(void)
+{
+    atomic_store_explicit(&g_diag_req, true, memory_order_release);
+    start_next();
+}
+
+uint8_t outdrv_dev_status(uint8_t dev)
+{
+    return (dev < OUTDRV_CHAIN_LEN) ? g_status[dev] : 0U;
+}
+
+bool outdrv_pop_fault(EventMsg* out)
+{
+    if (out == NULL) { return false; }
+
+    for (uint32_t dev = 0U; dev < OUTDRV_CHAIN_LEN; dev++) {
+        uint32_t pending = atomic_load_explicit(&g_fault_pending[dev], memory_order_acquire);
+        while (pending != 0U) {
+            const uint32_t i = (uint32_t)__builtin_ctz(pending);
+            const uint32_t bit = 1UL << i;
+            const uint32_t prev = atomic_fetch_and_explicit(&g_fault_pending[dev], ~bit, memory_order_acq_rel);
+            if ((prev & bit) != 0U) {
+                out->type = FAULT_KINDS[i].evt;
+                out->arg.u8  = g_status[dev];
+                out->arg.u16 = (uint16_t)dev;
+                out->tick = 0U;
+                return true;
+            }
+            pending = prev & ~bit;
+        }
+    }
+    return false;
+}
+
+void outdrv_on_hw_trip(uint8_t src)
+{
+    uint32_t kinds = 0U;
+    if ((src & OUTDRV_TRIP_FAULT) != 0U) { kinds |= 1UL << FAULT_IDX_DRIVER; }
+    if ((src & OUTDRV_TRIP_PGOOD) != 0U) {
+        kinds |= 1UL << FAULT_IDX_POWER;
+        /* Registres des circuits inconnus: tout sera renvoyé */
+        g_known = 0U;
+        (void)atomic_fetch_or_explicit(&g_dirty, ALL_REGS, memory_order_acq_rel);
+    }
+    /* Broches communes à la chaîne: rapportées sur le circuit 0 */
+    (void)atomic_fetch_or_explicit(&g_fault_pending[0], kinds, memory_order_acq_rel);
+}
+
+/* Octet d’état reçu: seuls les défauts qui apparaissent sont livrés
+   (un défaut maintenu ne produit pas un événement par trame). */
+static void decode_status(uint32_t dev, uint8_t st)
+{
+    const uint8_t raised = (uint8_t)(st & (uint8_t)~g_status[dev]);
+    g_status[dev] = st;
+    if (raised == 0U) { return; }
+
+    uint32_t kinds = 0U;
+    for (uint32_t i = 0U; i < FAULT_KIND_COUNT; i++) {
+        if ((raised & FAULT_KINDS[i].bit) != 0U) { kinds |= 1UL << i; }
+    }
+    if (kinds != 0U) {
+        (void)atomic_fetch_or_explicit(&g_fault_pending[dev], kinds, memory_order_acq_rel);
+    }
+}
+
+void outdrv_on_xfer_done(bool ok, const uint16_t* rx)
+{
+    const uint32_t reg = g_tx_reg;
+
+    if (ok && (rx != NULL)) {
+        for (uint32_t dev = 0U; dev < OUTDRV_CHAIN_LEN; dev++) {
+            decode_status(dev, OUTDRV_RX_STATUS(rx[OUTDRV_CHAIN_SLOT(dev)]));
+        }
+    }
+
+    if (reg == TX_REG_READ) {
+        if (!ok) { g_stats.errors++; } else { g_stats.frames++; }
+        atomic_store_explicit(&g_busy, false, memory_order_release);
+        outdrv_flush();
+        return;
+    }
+
+    if (!ok) {
+        /* Trame perdue: renvoyée au prochain outdrv_flush() de la boucle principale,
+           pas d’ici (un bus en panne ne doit pas monopoliser l’ISR) */
+        g_stats.errors++;
+        (void)atomic_fetch_or_explicit(&g_dirty, 1UL << reg, memory_order_acq_rel);
+        atomic_store_explicit(&g_busy, false, memory_order_release);
+        return;
+    }
+
+    for (uint32_t dev = 0U; dev < OUTDRV_CHAIN_LEN; dev++) { g_shadow[dev][reg] = g_tx_val[dev]; }
+    g_known |= 1UL << reg;
+    g_stats.frames++;
+
+    /* Valeur voulue changée pendant le vol: à renvoyer */
+    if (!chain_in_place(reg)) {
+        (void)atomic_fetch_or_explicit(&g_dirty, 1UL << reg, memory_order_acq_rel);
+    }
+
+    atomic_store_explicit(&g_busy, false, memory_order_release);
+    outdrv_flush();   /* adresse suivante, directement depuis l’ISR */
+}
@@ -0,0 +1,133 @@
+#include "sched.h"
+#include <string.h>
+
+/* Job périodique enregistré */
+typedef struct {
+    SchedJobFn fn;
+    uint16_t   period;   /* en ticks, >= 1 */
+    uint16_t   phase;    /* 0..period-1 */
+    uint16_t   count;    /* décompte jusqu’au prochain run (évite un modulo par tick) */
+} SchedJob;
+
+static SchedJob      g_jobs[SCHED_MAX_JOBS];
+static SchedJobStats g_job_stats[SCHED_MAX_JOBS];
+static uint8_t       g_job_count;
+
+static uint32_t g_slot_max[SCHED_FRAME_TICKS];
+static uint16_t g_slot;       /* tick courant % SCHED_FRAME_TICKS */
+static uint32_t g_tick;       /* ticks depuis sched_init */
+
+/* Helpers */
+static uint16_t gcd_u16(uint16_t a, uint16_t b)
+{
+    while (b != 0U) { uint16_t r = (uint16_t)(a % b); a = b; b = r; }
+    return a;
+}
+
+/* Deux jobs (p1,φ1) et (p2,φ2) tombent un jour sur le même tick
+   ssi φ1 ≡ φ2 (mod pgcd(p1,p2)); la collision concerne alors une exécution
+   sur p2/pgcd du nouveau job. On cumule ce taux pour chaque phase candidate
+   et on garde la moins chargée. */
+static uint16_t pick_phase(uint16_t period)
+{
+    uint16_t best = 0U;
+    uint32_t best_hits = UINT32_MAX;
+    for (uint16_t ph = 0U; ph < period; ph++) {
+        uint32_t hits = 0U;
+        for (uint8_t j = 0U; j < g_job_count; j++) {
+            const uint16_t g = gcd_u16(period, g_jobs[j].period);
+            if ((ph % g) == (g_jobs[j].phase % g)) {
+                hits += ((uint32_t)g * 1024U) / g_jobs[j].period;
+            }
+        }
+        if (hits < best_hits) { best_hits = hits; best = ph; }
+    }
+    return best;
+}
+
+void sched_init(void)
+{
+    (void)memset(g_jobs, 0, sizeof(g_jobs));
+    g_job_count = 0U;
+    g_slot = 0U;
+    g_tick = 0U;
+    sched_reset_stats();
+}
+
+int8_t sched_add(SchedJobFn fn, uint16_t period_ticks, uint16_t phase)
+{
+    if ((fn == NULL) || (period_ticks == 0U)) { return -1; }
+    if (g_job_count >= SCHED_MAX_JOBS) { return -1; }
+
+    if (phase == SCHED_PHASE_AUTO) { phase = pick_phase(period_ticks); }
+    else if (phase >= period_ticks) { return -1; }
+
+    SchedJob* j = &g_jobs[g_job_count];
+    j->fn     = fn;
+    j->period = period_ticks;
+    j->phase  = phase;
+    /* premier run au prochain tick t (= g_tick) tel que t % period == phase */
+    const uint16_t now = (uint16_t)(g_tick % period_ticks);
+    j->count = (uint16_t)((phase + period_ticks - now) % period_ticks);
+
+    /* Publié en dernier: l’ISR ne voit le job qu’une fois complet */
+    g_job_count++;
+    return (int8_t)(g_job_count - 1U);
+}
+
+void sched_tick(void)
+{
+    const uint32_t t0 = hw_cycle_counter();
+    uint32_t t_prev = t0;
+
+    for (uint8_t i = 0U; i < g_job_count; i++) {
+        SchedJob* j = &g_jobs[i];
+        if (j->count != 0U) { j->count--; continue; }
+        j->count = (uint16_t)(j->period - 1U);
+
+        j->fn();
+
+        const uint32_t t_now = hw_cycle_counter();
+        const uint32_t dt = t_now - t_prev;
+        t_prev = t_now;
+
+        SchedJobStats* s = &g_job_stats[i];
+        s->runs++;
+        s->last_cycles = dt;
+        if (dt > s->max_cycles) { s->max_cycles = dt; }
+    }
+
+    const uint32_t total = t_prev - t0;
+    if (total > g_slot_max[g_slot]) { g_slot_max[g_slot] = total; }
+
+    g_tick++;
+    g_slot = (uint16_t)((g_slot + 1U) % SCHED_FRAME_TICKS);
+}
+
+bool sched_get_job_stats(uint8_t job, SchedJobStats* out)
+{
+    if ((out == NULL) || (job >= g_job_count)) { return false; }
+    *out = g_job_stats[job];
+    return true;
+}
+
+uint32_t sched_slot_max_cycles(uint8_t slot)
+{
+    if (slot >= SCHED_FRAME_TICKS) { return 0U; }
+    return g_slot_max[slot];
+}
+
+uint32_t sched_worst_cycles(void)
+{
+    uint32_t worst = 0U;
+    for (uint32_t i = 0U; i < SCHED_FRAME_TICKS; i++) {
+        if (g_slot_max[i] > worst) { worst = g_slot_max[i]; }
+    }
+    return worst;
+}
+
+void sched_reset_stats(void)
+{
+    (void)memset(g_job_stats, 0, sizeof(g_job_stats));
+    (void)memset(g_slot_max, 0, sizeof(g_slot_max));
+}
@@ -57,6 +57,15 @@
 /* External variables --------------------------------------------------------*/
 extern TIM_HandleTypeDef htim6;
 /* USER CODE BEGIN EV */
+extern DMA_HandleTypeDef hdma_inp_a;
+extern DMA_HandleTypeDef hdma_spi2_tx;
+extern DMA_HandleTypeDef hdma_spi2_rx;
+extern SPI_HandleTypeDef hspi2;
+extern DMA_HandleTypeDef hdma_usart2_tx;
+extern UART_HandleTypeDef huart2;
+extern FDCAN_HandleTypeDef hfdcan1;
+extern DMA_HandleTypeDef hdma_usart1_rx;
+extern DMA_HandleTypeDef hdma_usart1_tx;
 
 /* USER CODE END EV */
 
@@ -213,5 +222,111 @@ void TIM6_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+#if (INP_SRC == INP_SRC_DMA)
+/**
+  * @brief This function handles GPDMA1 Channel 2 global interrupt (échantillons GPIOA).
+  */
+void GPDMA1_Channel2_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_inp_a);
+}
+#endif
+
+/**
+  * @brief This function handles GPDMA1 Channel 3 global interrupt (SPI2 TX, outdrv).
+  */
+void GPDMA1_Channel3_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_spi2_tx);
+}
+
+/**
+  * @brief This function handles GPDMA1 Channel 4 global interrupt (SPI2 RX, outdrv).
+  */
+void GPDMA1_Channel4_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_spi2_rx);
+}
+
+/**
+  * @brief This function handles SPI2 global interrupt (fin de trame outdrv).
+  */
+void SPI2_IRQHandler(void)
+{
+  HAL_SPI_IRQHandler(&hspi2);
+}
+
+/**
+  * @brief This function handles GPDMA1 Channel 5 global interrupt (USART2 TX, télémétrie).
+  */
+void GPDMA1_Channel5_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart2_tx);
+}
+
+/**
+  * @brief This function handles USART2 global interrupt (fin d’émission télémétrie).
+  */
+void USART2_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&huart2);
+}
+
+/**
+  * @brief This function handles FDCAN1 interrupt 0 (FIFO RX 0 et 1).
+  */
+void FDCAN1_IT0_IRQHandler(void)
+{
+  HAL_FDCAN_IRQHandler(&hfdcan1);
+}
+
+/**
+  * @brief This function handles GPDMA1 Channel 6 global interrupt (USART1 RX, Modbus).
+  */
+void GPDMA1_Channel6_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_rx);
+}
+
+/**
+  * @brief This function handles GPDMA1 Channel 7 global interrupt (USART1 TX, Modbus).
+  */
+void GPDMA1_Channel7_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_tx);
+}
+
+/**
+  * @brief This function handles USART1 global interrupt (fin de trame / fin de réponse Modbus).
+  */
+void USART1_IRQHandler(void)
+{
+  hw_modbus_uart_irq();
+}
+
+/**
+  * @brief Protection du driver de sorties: FAULT (ligne 4) et PGOOD (ligne 5),
+  *        priorité 0, coupure de OUTPUT_DRV_EN dans l’ISR.
+  */
+void EXTI4_IRQHandler(void)  { hw_outdrv_trip_irq(); }
+void EXTI5_IRQHandler(void)  { hw_outdrv_trip_irq(); }
+
+/**
+  * @brief This function handles FLASH global interrupt (mise à jour: fin
+  *        d’effacement de secteur / de quad-mot, enchaînement dans l’ISR).
+  */
+void FLASH_IRQHandler(void) { hw_fwupd_flash_irq(); }
+
+#if (INP_SRC == INP_SRC_EXTI)
+/**
+  * @brief EXTI des entrées: une IRQ par ligne (voir hw_inputs_exti_start).
+  */
+void EXTI3_IRQHandler(void)  { HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_3); }
+void EXTI6_IRQHandler(void)  { HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_6); }
+void EXTI7_IRQHandler(void)  { HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_7); }
+void EXTI13_IRQHandler(void) { HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_13); }
+void EXTI14_IRQHandler(void) { HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_14); }
+void EXTI15_IRQHandler(void) { HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_15); }
+#endif
 
 /* USER CODE END 1 */
@@ -0,0 +1,184 @@
+#include "telem.h"
+#include <string.h>
+#include <stdatomic.h>
+
+_Static_assert((TELEM_SLOTS >= 2U) && ((TELEM_SLOTS & (TELEM_SLOTS - 1U)) == 0U),
+               "TELEM_SLOTS doit être une puissance de 2");
+_Static_assert(TELEM_MAX_PAYLOAD <= 250U, "TELEM_MAX_PAYLOAD > 250: trame COBS à plus d’un bloc");
+
+/* Trame brute: type, seq, données, CRC */
+#define RAW_MAX   (2U + TELEM_MAX_PAYLOAD + 2U)
+/* COBS (un octet de tête par bloc de 254, un seul bloc ici) + délimiteur */
+#define SLOT_MAX  (RAW_MAX + 2U)
+
+typedef struct {
+    uint8_t     buf[SLOT_MAX];
+    uint16_t    len;
+    atomic_bool ready;      /* posé par le producteur une fois la trame encodée */
+} TelemSlot;
+
+static TelemSlot g_slots[TELEM_SLOTS];
+
+/* Numéros de séquence libres (pas d’indices): slot = seq % TELEM_SLOTS.
+   g_wr = prochaine réservation (producteurs, CAS), g_rd = slot en tête (consommateur). */
+static atomic_uint_least32_t g_wr;
+static atomic_uint_least32_t g_rd;
+
+/* Ligne occupée: pris par celui qui lance une émission, rendu en fin d’émission */
+static atomic_bool g_busy;
+
+static atomic_uint_least32_t g_dropped;
+static TelemStats g_stats;   /* frames/bytes/errors: côté consommateur uniquement */
+
+/* CRC16-CCITT par quartets: 32 octets de table, 2 pas par octet */
+static const uint16_t CRC_NIB[16] = {
+    0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+    0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU,
+};
+
+uint16_t telem_crc16(const uint8_t* p, uint32_t n)
+{
+    uint16_t crc = 0xFFFFU;
+    while (n-- != 0U) {
+        crc = (uint16_t)((crc << 4) ^ CRC_NIB[(crc >> 12) ^ (*p >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ CRC_NIB[(crc >> 12) ^ (*p & 0x0FU)]);
+        p++;
+    }
+    return crc;
+}
+
+/* COBS: aucun 0x00 dans la sortie, délimiteur 0x00 ajouté. n < 254. */
+static uint16_t cobs_encode(const uint8_t* in, uint32_t n, uint8_t* out)
+{
+    uint32_t code_at = 0U;
+    uint32_t o = 1U;
+    uint8_t code = 1U;
+
+    for (uint32_t i = 0U; i < n; i++) {
+        if (in[i] == 0U) {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1U;
+        } else {
+            out[o++] = in[i];
+            code++;
+        }
+    }
+    out[code_at] = code;
+    out[o++] = 0U;
+    return (uint16_t)o;
+}
+
+/* Lance l’émission du slot en tête s’il est prêt et que la ligne est libre.
+   Appelable depuis tout contexte: le premier qui prend g_busy a la ligne. */
+static void start_next(void)
+{
+    for (;;) {
+        if (atomic_exchange_explicit(&g_busy, true, memory_order_acquire)) { return; }
+
+        const uint32_t rd = atomic_load_explicit(&g_rd, memory_order_relaxed);
+        TelemSlot* s = &g_slots[rd & (TELEM_SLOTS - 1U)];
+        if ((rd != atomic_load_explicit(&g_wr, memory_order_acquire)) &&
+            atomic_load_explicit(&s->ready, memory_order_acquire)) {
+            if (hw_telem_tx_start(s->buf, s->len)) { return; }
+            g_stats.errors++;
+            atomic_store_explicit(&g_busy, false, memory_order_release);
+            return;
+        }
+
+        atomic_store_explicit(&g_busy, false, memory_order_release);
+        /* Slot publié entre le test et la libération: on repasse */
+        if (!atomic_load_explicit(&s->ready, memory_order_acquire)) { return; }
+    }
+}
+
+void telem_init(void)
+{
+    for (uint32_t i = 0U; i < TELEM_SLOTS; i++) {
+        g_slots[i].len = 0U;
+        atomic_store_explicit(&g_slots[i].ready, false, memory_order_relaxed);
+    }
+    atomic_store_explicit(&g_wr, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_rd, 0U, memory_order_relaxed);
+    atomic_store_explicit(&g_busy, false, memory_order_relaxed);
+    atomic_store_explicit(&g_dropped, 0U, memory_order_relaxed);
+    (void)memset(&g_stats, 0, sizeof(g_stats));
+}
+
+bool telem_send(uint8_t type, const void* data, uint16_t len)
+{
+    if ((len > TELEM_MAX_PAYLOAD) || ((data == NULL) && (len != 0U))) {
+        (void)atomic_fetch_add_explicit(&g_dropped, 1U, memory_order_relaxed);
+        return false;
+    }
+
+    /* Réservation d’un slot */
+    uint32_t wr = atomic_load_explicit(&g_wr, memory_order_relaxed);
+    do {
+        if ((wr - atomic_load_explicit(&g_rd, memory_order_acquire)) >= TELEM_SLOTS) {
+            (void)atomic_fetch_add_explicit(&g_dropped, 1U, memory_order_relaxed);
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&g_wr, &wr, wr + 1U,
+                                                    memory_order_acq_rel, memory_order_relaxed));
+
+    /* Encodage hors de toute section critique: le slot est à nous */
+    uint8_t raw[RAW_MAX];
+    raw[0] = type;
+    raw[1] = (uint8_t)wr;
+    if (len != 0U) { (void)memcpy(&raw[2], data, len); }
+    const uint16_t crc = telem_crc16(raw, 2U + (uint32_t)len);
+    raw[2U + len] = (uint8_t)(crc >> 8);
+    raw[3U + len] = (uint8_t)crc;
+
+    TelemSlot* s = &g_slots[wr & (TELEM_SLOTS - 1U)];
+    s->len = cobs_encode(raw, 4U + (uint32_t)len, s->buf);
+    atomic_store_explicit(&s->ready, true, memory_order_release);
+
+    start_next();
+    return true;
+}
+
+uint32_t telem_write_text(const char* s, uint32_t len)
+{
+    uint32_t done = 0U;
+    while (done < len) {
+        const uint32_t n = ((len - done) > TELEM_MAX_PAYLOAD) ? TELEM_MAX_PAYLOAD : (len - done);
+        if (!telem_send(TELEM_T_TEXT, &s[done], (uint16_t)n)) { break; }
+        done += n;
+    }
+    return done;
+}
+
+uint32_t telem_pending(void)
+{
+    return atomic_load_explicit(&g_wr, memory_order_acquire) -
+           atomic_load_explicit(&g_rd, memory_order_acquire);
+}
+
+void telem_get_stats(TelemStats* out)
+{
+    if (out == NULL) { return; }
+    *out = g_stats;
+    out->dropped = atomic_load_explicit(&g_dropped, memory_order_relaxed);
+}
+
+void telem_on_tx_done(bool ok)
+{
+    const uint32_t rd = atomic_load_explicit(&g_rd, memory_order_relaxed);
+    TelemSlot* s = &g_slots[rd & (TELEM_SLOTS - 1U)];
+
+    if (ok) {
+        g_stats.frames++;
+        g_stats.bytes += s->len;
+    } else {
+        g_stats.errors++;   /* trame perdue: la suivante porte un seq qui le montre */
+    }
+
+    /* Slot rendu aux producteurs */
+    atomic_store_explicit(&s->ready, false, memory_order_relaxed);
+    atomic_store_explicit(&g_rd, rd + 1U, memory_order_release);
+
+    atomic_store_explicit(&g_busy, false, memory_order_release);
+    start_next();   /* trame suivante, directement depuis l’ISR */
+}
@@ -1,5 +1,9 @@
 #include "timers.h"
 #include <string.h>
+#include <stdatomic.h>
+
+/* Le bitmap d’expirations tient dans un mot */
+_Static_assert(TMR_COUNT <= 32U, "TMR_COUNT > 32: bitmap d'expirations trop petit");
 
 /* Représentation interne d’un timer one-shot. */
 typedef struct {
@@ -12,6 +16,11 @@ typedef struct {
 /* Tableau statique: zéro alloc dynamique, MISRA-friendly. */
 static sw_timer_t g_timers[TMR_COUNT];
 
+/* Expirations en attente de livraison: bit i = timer i.
+   Posé par tmr_tick() (ISR), retiré par tmr_pop_expired() (dispatcher).
+   Atomique: fetch_or/fetch_and sans section critique (LDREX/STREX sur M33). */
+static atomic_uint_least32_t g_tmr_pending;
+
 /* Compteur système optionnel (ticks de TMR_TICK_MS) si tu veux time-stamper.
    Si tu t’en fiches, ignore-le. */
 static uint32_t g_tmr_uptime_ticks;
@@ -26,19 +35,59 @@ static inline uint32_t ms_to_ticks(uint32_t ms)
     return q;
 }
 
+/* Choisit le nombre de ticks effectif dans [ticks, ticks + slack]:
+   1) le tick d’expiration d’un autre timer actif le plus proche (même réveil),
+   2) sinon l’échéance absolue arrondie à une frontière 2^n ≤ slack, pour que
+      des timers armés indépendamment finissent aussi par tomber ensemble. */
+static uint32_t coalesce_ticks(uint32_t id, uint32_t ticks, uint32_t slack)
+{
+    uint32_t best = UINT32_MAX;
+    for (uint32_t i = 0U; i < (uint32_t)TMR_COUNT; i++) {
+        const sw_timer_t* t = &g_timers[i];
+        if ((i == id) || (t->active == 0U)) { continue; }
+        if ((t->ticks >= ticks) && ((t->ticks - ticks) <= slack) && (t->ticks < best)) {
+            best = t->ticks;
+        }
+    }
+    if (best != UINT32_MAX) { return best; }
+
+    const uint32_t gran = 1UL << (31U - (uint32_t)__builtin_clz(slack));
+    const uint32_t due  = g_tmr_uptime_ticks + ticks;   /* expire quand uptime == due */
+    const uint32_t aligned = (due + gran - 1U) & ~(gran - 1U);
+    return ticks + (aligned - due);
+}
+
+static inline void pending_clear(uint32_t id)
+{
+    (void)atomic_fetch_and_explicit(&g_tmr_pending, ~(1UL << id), memory_order_acq_rel);
+}
+
 void tmr_init(void)
 {
     (void)memset(g_timers, 0, sizeof(g_timers));
+    atomic_store_explicit(&g_tmr_pending, 0U, memory_order_relaxed);
     g_tmr_uptime_ticks = 0U;
 }
 
 bool tmr_set(TimerId id, uint32_t delay_ms, EventType evt, EventArg arg)
+{
+    return tmr_set_slack(id, delay_ms, 0U, evt, arg);
+}
+
+bool tmr_set_slack(TimerId id, uint32_t delay_ms, uint32_t slack_ms, EventType evt, EventArg arg)
 {
     if ((uint32_t)id >= TMR_COUNT) { return false; }
     if ((evt <= 0) || (evt >= EVT_MAX_ENUM)) { return false; }
 
     sw_timer_t* t = &g_timers[id];
-    t->ticks = ms_to_ticks(delay_ms);
+    t->active = 0U;              /* gèle le tick pendant la mise à jour */
+    pending_clear((uint32_t)id); /* un réarmement remplace l’expiration non livrée */
+
+    uint32_t ticks = ms_to_ticks(delay_ms);
+    const uint32_t slack = slack_ms / TMR_TICK_MS;  /* arrondi bas: ne jamais dépasser la tolérance */
+    if (slack != 0U) { ticks = coalesce_ticks((uint32_t)id, ticks, slack); }
+
+    t->ticks = ticks;
     t->evt   = evt;
     t->arg   = arg;
     t->active = 1U;
@@ -50,12 +99,14 @@ void tmr_cancel(TimerId id)
     if ((uint32_t)id >= TMR_COUNT) { return; }
     g_timers[id].active = 0U;
     g_timers[id].ticks  = 0U;
+    pending_clear((uint32_t)id);
 }
 
 bool tmr_is_active(TimerId id)
 {
     if ((uint32_t)id >= TMR_COUNT) { return false; }
-    return (g_timers[id].active != 0U);
+    if (g_timers[id].active != 0U) { return true; }
+    return ((atomic_load_explicit(&g_tmr_pending, memory_order_acquire) & (1UL << (uint32_t)id)) != 0U);
 }
 
 uint32_t tmr_remaining_ms(TimerId id)
@@ -65,15 +116,27 @@ uint32_t tmr_remaining_ms(TimerId id)
     return ticks * (uint32_t)TMR_TICK_MS;
 }
 
+uint32_t tmr_next_expiry_ms(void)
+{
+    uint32_t best = UINT32_MAX;
+    for (uint32_t i = 0U; i < (uint32_t)TMR_COUNT; i++) {
+        const sw_timer_t* t = &g_timers[i];
+        if ((t->active != 0U) && (t->ticks < best)) { best = t->ticks; }
+    }
+    return (best == UINT32_MAX) ? UINT32_MAX : best * (uint32_t)TMR_TICK_MS;
+}
+
 /* Politique d’émission:
-   - Chaque timer expiré pousse 1 event sur EVQ_NORMAL.
-   - En cas d’échec de push (queue pleine), on retente au tick suivant
-     en NE remettant pas ticks à 0 tant que l’event n’a pas été accepté.
-     → On garantit de ne pas perdre l’expiration (au prix d’un retard si la file déborde). */
+   - Chaque timer expiré est désarmé et son bit posé dans g_tmr_pending.
+   - Aucune écriture dans les files ici: coût O(1) par timer, même quand
+     EVQ_NORMAL déborde (pas de push raté retenté à chaque tick).
+   - Le dispatcher draine le bitmap via tmr_pop_expired() → jamais de perte,
+     chaque timer a de fait sa propre "place réservée". */
 void tmr_tick(void)
 {
     g_tmr_uptime_ticks++;
 
+    uint32_t expired = 0U;
     for (uint32_t i = 0U; i < (uint32_t)TMR_COUNT; i++) {
         sw_timer_t* t = &g_timers[i];
         if (t->active == 0U) { continue; }
@@ -82,17 +145,36 @@ void tmr_tick(void)
             t->ticks--;
         }
 
-        if ((t->ticks == 0U) && (t->active != 0U)) {
-            /* Tente d’émettre l’événement d’expiration */
-            EventArg a = t->arg;
-            const bool ok = evq_push(EVQ_NORMAL, t->evt, a);
-            if (ok) {
-                /* Désarme seulement si l’événement a été accepté */
-                t->active = 0U;
-            } else {
-                /* File NORMAL pleine: on réessaie au prochain tick.
-                   Laisse ticks à 0 pour retenter sans re-décompter. */
-            }
+        if (t->ticks == 0U) {
+            t->active = 0U;
+            expired |= (1UL << i);
+        }
+    }
+
+    if (expired != 0U) {
+        (void)atomic_fetch_or_explicit(&g_tmr_pending, expired, memory_order_acq_rel);
+    }
+}
+
+bool tmr_pop_expired(EventMsg* out)
+{
+    if (out == NULL) { return false; }
+
+    uint32_t pending = atomic_load_explicit(&g_tmr_pending, memory_order_acquire);
+    while (pending != 0U) {
+        /* Plus petit id d’abord: TMR_SEQ passe avant les timers utilisateur */
+        const uint32_t id  = (uint32_t)__builtin_ctz(pending);
+        const uint32_t bit = 1UL << id;
+
+        /* Retire le bit; si un tmr_set/tmr_cancel l’a retiré entre-temps, on passe au suivant */
+        const uint32_t prev = atomic_fetch_and_explicit(&g_tmr_pending, ~bit, memory_order_acq_rel);
+        if ((prev & bit) != 0U) {
+            out->type = g_timers[id].evt;
+            out->arg  = g_timers[id].arg;
+            out->tick = g_tmr_uptime_ticks;
+            return true;
         }
+        pending = prev & ~bit;
     }
+    return false;
 }
@@ -0,0 +1,177 @@
+#include "tpo.h"
+#include "timers.h"
+#include <string.h>
+
+_Static_assert(TPO_CH_COUNT <= 32U, "TPO_CH_COUNT > 32: masque de sorties trop petit");
+_Static_assert((TPO_PERIOD_MS % TMR_TICK_MS) == 0U, "TPO_PERIOD_MS doit être un multiple de TMR_TICK_MS");
+
+/* Planning d’une période: instants (ms depuis le début) et masque à appliquer.
+   Au plus un allumage et une coupure par élément, plus la fin de période. */
+#define TPO_MAX_STEPS  (2U * TPO_CH_COUNT + 1U)
+
+typedef struct {
+    uint32_t t_ms;
+    uint32_t mask;
+} TpoStep;
+
+static uint16_t g_duty[TPO_CH_COUNT];
+static TpoStep  g_steps[TPO_MAX_STEPS];
+static uint8_t  g_nsteps;
+static uint8_t  g_next;       /* prochain pas à appliquer */
+static uint32_t g_now_ms;     /* instant du dernier pas appliqué */
+static uint32_t g_out;
+static bool     g_running;
+
+static void apply(uint32_t mask)
+{
+    if (mask != g_out) {
+        g_out = mask;
+        tpo_apply(mask);
+    }
+}
+
+/* Arrondi au tick du service timers */
+static uint32_t snap_ms(uint32_t ms)
+{
+    return ((ms + (TMR_TICK_MS / 2U)) / TMR_TICK_MS) * TMR_TICK_MS;
+}
+
+static void add_time(uint32_t t)
+{
+    for (uint8_t i = 0U; i < g_nsteps; i++) {
+        if (g_steps[i].t_ms == t) { return; }
+    }
+    /* Insertion triée (quelques éléments: coût négligeable, une fois par période) */
+    uint8_t i = g_nsteps++;
+    while ((i > 0U) && (g_steps[i - 1U].t_ms > t)) {
+        g_steps[i] = g_steps[i - 1U];
+        i--;
+    }
+    g_steps[i].t_ms = t;
+    g_steps[i].mask = 0U;
+}
+
+/* Vrai si un élément déjà placé s’allume à l’instant s */
+static bool start_taken(const uint32_t* start, const uint32_t* on, uint32_t n, uint32_t s)
+{
+    for (uint32_t c = 0U; c < n; c++) {
+        if ((on[c] != 0U) && (start[c] == s)) { return true; }
+    }
+    return false;
+}
+
+/* Calcule le planning de la période à partir des rapports courants.
+   Placement en file circulaire: chaque élément s’allume quand le précédent se
+   coupe, modulo la période. Si la somme dépasse la période, l’élément qui
+   déborde continue sur le début de la période suivante (queue) au lieu d’être
+   recalé: les allumages restent répartis et jamais simultanés (un instant déjà
+   pris est décalé d’un tick). Une queue n’existe que pour un élément déjà
+   allumé en fin de période précédente: au démarrage, pas d’allumage groupé à 0. */
+static void plan_period(void)
+{
+    uint32_t start[TPO_CH_COUNT];
+    uint32_t on[TPO_CH_COUNT];
+    uint32_t cursor = 0U;
+    const uint32_t was_on = g_out;
+
+    g_nsteps = 0U;
+    add_time(0U);
+    add_time(TPO_PERIOD_MS);
+
+    for (uint32_t ch = 0U; ch < TPO_CH_COUNT; ch++) {
+        uint32_t d = snap_ms(((uint32_t)g_duty[ch] * TPO_PERIOD_MS) / TPO_DUTY_MAX);
+        if (d < TPO_MIN_PULSE_MS) { d = 0U; }
+        if ((TPO_PERIOD_MS - d) < TPO_MIN_PULSE_MS) { d = TPO_PERIOD_MS; }
+        on[ch] = d;
+        start[ch] = 0U;
+        if (d == 0U) { continue; }
+
+        uint32_t s = cursor % TPO_PERIOD_MS;
+        while (start_taken(start, on, ch, s)) { s = (s + TMR_TICK_MS) % TPO_PERIOD_MS; }
+        start[ch] = s;
+        if (d < TPO_PERIOD_MS) { cursor = s + d; }   /* allumé en continu: ne consomme pas de place */
+
+        add_time(s);
+        if ((s + d) <= TPO_PERIOD_MS)              { add_time(s + d); }
+        else if ((was_on & (1UL << ch)) != 0U)     { add_time(s + d - TPO_PERIOD_MS); }
+        else                                       { /* pas de queue */ }
+    }
+
+    /* Masque de chaque pas: [start, start+on[ dans la période, plus la queue
+       [0, start+on-période[ si l’élément était déjà allumé */
+    for (uint8_t i = 0U; i < g_nsteps; i++) {
+        const uint32_t t = g_steps[i].t_ms;
+        uint32_t m = 0U;
+        for (uint32_t ch = 0U; ch < TPO_CH_COUNT; ch++) {
+            if (on[ch] == 0U) { continue; }
+            const bool head = (t >= start[ch]) && ((t - start[ch]) < on[ch]);
+            const bool tail = (t < start[ch]) && ((was_on & (1UL << ch)) != 0U)
+                              && ((t + TPO_PERIOD_MS - start[ch]) < on[ch]);
+            if (head || tail) { m |= 1UL << ch; }
+        }
+        g_steps[i].mask = m;
+    }
+}
+
+/* Applique le pas courant et arme l’échéance du suivant */
+static void run_step(void)
+{
+    if (g_next >= g_nsteps) { return; }
+
+    /* Dernier pas = fin de période: on enchaîne directement sur la suivante */
+    if (g_steps[g_next].t_ms >= TPO_PERIOD_MS) {
+        plan_period();
+        g_next = 0U;
+    }
+
+    const TpoStep* s = &g_steps[g_next];
+    apply(s->mask);
+    g_now_ms = s->t_ms;
+    g_next++;
+
+    if (g_next < g_nsteps) {
+        (void)tmr_set(TMR_TPO, g_steps[g_next].t_ms - g_now_ms, EVT_TPO_EDGE, EVARG_NONE());
+    }
+}
+
+void tpo_init(void)
+{
+    (void)memset(g_duty, 0, sizeof(g_duty));
+    g_nsteps = 0U;
+    g_next = 0U;
+    g_now_ms = 0U;
+    g_out = 0U;
+    g_running = false;
+}
+
+bool tpo_set_duty(uint8_t ch, uint16_t duty)
+{
+    if ((ch >= TPO_CH_COUNT) || (duty > TPO_DUTY_MAX)) { return false; }
+    g_duty[ch] = duty;
+    return true;
+}
+
+void tpo_start(void)
+{
+    g_running = true;
+    plan_period();
+    g_next = 0U;
+    run_step();
+}
+
+void tpo_stop(void)
+{
+    g_running = false;
+    tmr_cancel(TMR_TPO);
+    apply(0U);
+}
+
+void tpo_on_edge(void)
+{
+    if (g_running) { run_step(); }
+}
+
+uint32_t tpo_outputs(void)
+{
+    return g_out;
+}
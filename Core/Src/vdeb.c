@@ -0,0 +1,54 @@
+#include "vdeb.h"
+#include <string.h>
+
+void vdeb_init(VDeb* d, uint32_t mask)
+{
+    (void)memset(d, 0, sizeof(*d));
+    d->mask = mask;
+    (void)vdeb_set_threshold(d, mask, 1U);
+}
+
+bool vdeb_set_threshold(VDeb* d, uint32_t group_mask, uint32_t samples)
+{
+    if ((samples == 0U) || (samples > VDEB_MAX_SAMPLES)) { return false; }
+    for (uint32_t k = 0U; k < VDEB_BITS; k++) {
+        if (((samples >> k) & 1U) != 0U) { d->tgt[k] |= group_mask; }
+        else                             { d->tgt[k] &= ~group_mask; }
+        d->cnt[k] &= ~group_mask;
+    }
+    return true;
+}
+
+void vdeb_seed(VDeb* d, uint32_t level)
+{
+    d->stable = level & d->mask;
+    for (uint32_t k = 0U; k < VDEB_BITS; k++) { d->cnt[k] = 0U; }
+    d->aborted = 0U;
+}
+
+uint32_t vdeb_step(VDeb* d, uint32_t level)
+{
+    /* Entrées qui diffèrent de leur état stable: elles comptent, les autres repartent à 0 */
+    const uint32_t diff = (level ^ d->stable) & d->mask;
+
+    /* Incrément ripple-carry sur les plans + test d’égalité au seuil, en une passe */
+    uint32_t carry = diff;
+    uint32_t eq = diff;
+    uint32_t busy = 0U;
+    for (uint32_t k = 0U; k < VDEB_BITS; k++) {
+        const uint32_t c = d->cnt[k];
+        busy |= c;
+        const uint32_t n = (c ^ carry) & diff;
+        carry &= c;
+        eq &= ~(n ^ d->tgt[k]);
+        d->cnt[k] = n;
+    }
+    d->aborted = busy & ~diff;
+
+    /* Seuil atteint: bascule l’état stable et remet ces compteurs à zéro */
+    if (eq != 0U) {
+        d->stable ^= eq;
+        for (uint32_t k = 0U; k < VDEB_BITS; k++) { d->cnt[k] &= ~eq; }
+    }
+    return eq;
+}
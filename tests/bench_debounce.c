@@ -0,0 +1,147 @@
+/* Banc hôte: debounce bit-parallèle (vdeb) contre l’ancien debounce par entrée
+   (DebIn/deb_tick d’avant vdeb, une structure et un accumulateur par entrée).
+   Mêmes échantillons pour les deux: les états stables doivent rester identiques
+   à chaque tick, puis on mesure le coût d’un tick pour 8 entrées.
+   Le temps hôte ne donne qu’un ordre de grandeur pour le Cortex-M33. */
+#define _POSIX_C_SOURCE 199309L
+#include "vdeb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define N_IN      8U
+#define N_SAMPLES (1U << 20)
+#define ROUNDS    20U
+
+static int g_fail;
+#define CHECK(c) do { if (!(c)) { printf("ECHEC %s:%d: %s\n", __FILE__, __LINE__, #c); g_fail++; } } while (0)
+
+/* ---- Référence: l’ancien deb_tick (INP_TICK_MS = 1, niveaux déjà inversés) ---- */
+typedef struct {
+    uint8_t stable;
+    uint8_t last_raw;
+    uint16_t acc_ms;
+    uint16_t thresh_ms;
+} DebIn;
+
+static uint8_t deb_tick(DebIn* d, uint8_t raw_now)
+{
+    uint8_t changed = 0U;
+    if (raw_now == d->last_raw) {
+        if (d->acc_ms < 0xFFFFU) { d->acc_ms = (uint16_t)(d->acc_ms + 1U); }
+        if ((d->acc_ms >= d->thresh_ms) && (raw_now != d->stable)) {
+            d->stable = raw_now;
+            changed = 1U;
+        }
+    } else {
+        d->last_raw = raw_now;
+        d->acc_ms = 1U;
+    }
+    return changed;
+}
+
+static uint32_t ref_step(DebIn* d, uint32_t level)
+{
+    uint32_t changed = 0U;
+    for (uint32_t i = 0U; i < N_IN; i++) {
+        if (deb_tick(&d[i], (uint8_t)((level >> i) & 1U)) != 0U) { changed |= 1UL << i; }
+    }
+    return changed;
+}
+
+static uint32_t ref_stable(const DebIn* d)
+{
+    uint32_t w = 0U;
+    for (uint32_t i = 0U; i < N_IN; i++) { w |= (uint32_t)d[i].stable << i; }
+    return w;
+}
+
+/* Seuils en échantillons: thermostat, fournisseur, 3 fils du sélecteur, 3 voies libres */
+static const uint16_t k_thresh[N_IN] = { 30U, 2000U, 200U, 200U, 200U, 30U, 30U, 30U };
+
+static void setup(VDeb* v, DebIn* r)
+{
+    vdeb_init(v, (1UL << N_IN) - 1UL);
+    for (uint32_t i = 0U; i < N_IN; i++) {
+        CHECK(vdeb_set_threshold(v, 1UL << i, k_thresh[i]));
+        r[i] = (DebIn){ .stable = 0U, .last_raw = 0U, .acc_ms = k_thresh[i], .thresh_ms = k_thresh[i] };
+    }
+    vdeb_seed(v, 0U);
+}
+
+/* Niveaux qui changent rarement, avec des rafales de rebonds autour des fronts */
+static uint32_t* make_samples(void)
+{
+    uint32_t* s = malloc(N_SAMPLES * sizeof(*s));
+    if (s == NULL) { return NULL; }
+    uint32_t level = 0U;
+    uint32_t bounce[N_IN] = {0};
+    srand(29);
+    for (uint32_t t = 0U; t < N_SAMPLES; t++) {
+        uint32_t w = level;
+        for (uint32_t i = 0U; i < N_IN; i++) {
+            if ((rand() % 3000) == 0) { level ^= 1UL << i; bounce[i] = 5U + (uint32_t)rand() % 60U; }
+            if ((bounce[i] > 0U) && ((rand() & 1) != 0)) { w ^= 1UL << i; }
+            if (bounce[i] > 0U) { bounce[i]--; }
+            if ((rand() % 5000) == 0) { w ^= 1UL << i; }   /* parasite isolé */
+        }
+        s[t] = w;
+    }
+    return s;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+int main(void)
+{
+    uint32_t* s = make_samples();
+    if (s == NULL) { printf("ECHEC allocation\n"); return 1; }
+
+    VDeb v;
+    DebIn r[N_IN];
+
+    /* 1) Équivalence tick par tick */
+    setup(&v, r);
+    uint32_t flips = 0U;
+    for (uint32_t t = 0U; t < N_SAMPLES; t++) {
+        const uint32_t cv = vdeb_step(&v, s[t]);
+        const uint32_t cr = ref_step(r, s[t]);
+        if ((cv != cr) || (v.stable != ref_stable(r))) {
+            printf("divergence au tick %u: vdeb %02x/%02x, réf %02x/%02x\n",
+                   t, (unsigned)cv, (unsigned)v.stable, (unsigned)cr, (unsigned)ref_stable(r));
+            g_fail++;
+            break;
+        }
+        flips += (uint32_t)__builtin_popcount(cv);
+    }
+    CHECK(flips > 100U);
+
+    /* 2) Coût par tick */
+    volatile uint32_t sink = 0U;
+    double best_v = 1e9, best_r = 1e9;
+    for (uint32_t k = 0U; k < ROUNDS; k++) {
+        setup(&v, r);
+        double t0 = now_s();
+        for (uint32_t t = 0U; t < N_SAMPLES; t++) { sink ^= vdeb_step(&v, s[t]); }
+        double t1 = now_s();
+        for (uint32_t t = 0U; t < N_SAMPLES; t++) { sink ^= ref_step(r, s[t]); }
+        double t2 = now_s();
+        if ((t1 - t0) < best_v) { best_v = t1 - t0; }
+        if ((t2 - t1) < best_r) { best_r = t2 - t1; }
+    }
+    (void)sink;
+    free(s);
+
+    printf("debounce %u entrées, %u ticks, %u bascules\n", N_IN, N_SAMPLES, flips);
+    printf("  vdeb (VDEB_BITS=%u) : %6.2f ns/tick\n", (unsigned)VDEB_BITS, best_v * 1e9 / N_SAMPLES);
+    printf("  par entrée (DebIn)  : %6.2f ns/tick\n", best_r * 1e9 / N_SAMPLES);
+
+    if (g_fail != 0) { printf("%d échec(s)\n", g_fail); return 1; }
+    printf("ok\n");
+    return 0;
+}
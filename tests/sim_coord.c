@@ -0,0 +1,163 @@
+/* Simulation hôte de plusieurs unités sur un bus CAN virtuel (coord.h).
+   Chaque nœud est le vrai code (coord, fsm, timers, files, tpo) compilé avec
+   son COORD_NODE_ID; le banc fournit le temps (pas de 1 ms), un bus diffusant
+   chaque trame aux autres nœuds après BUS_LATENCY_MS, des pertes de trames,
+   et des ticks de timers déphasés d’un nœud à l’autre.
+   Vérifie que les montées d’étage de l’installation restent espacées de
+   COORD_GAP_MS quand toutes les unités démarrent ensemble, et que chacune
+   finit par chauffer (pertes, bus coupé, pair figé). */
+#include "sim_node.h"
+#include "coord.h"
+#include "timers.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_NODES         3U
+#define BUS_LATENCY_MS  1U
+#define BUS_DEPTH       256U
+#define RUN_MS          180000U
+
+static int g_fail;
+#define CHECK(c) do { if (!(c)) { printf("ECHEC %s:%d: %s\n", __FILE__, __LINE__, #c); g_fail++; } } while (0)
+
+static const SimNode* const NODES[N_NODES] = { &sim_node_1, &sim_node_2, &sim_node_3 };
+
+typedef struct {
+    uint32_t due_ms;
+    uint8_t  from;
+    CanMsg   m;
+} BusFrame;
+
+static uint32_t g_now;
+static BusFrame g_bus[BUS_DEPTH];
+static uint32_t g_bus_n;
+static uint32_t g_loss_pm;            /* pertes par récepteur, pour-mille */
+static bool     g_frozen[N_NODES];    /* nœud figé: plus de tick, plus de réception */
+
+uint32_t sim_now_ms(void) { return g_now; }
+
+bool sim_bus_send(uint8_t node, uint32_t id, const uint8_t* data, uint8_t len)
+{
+    if ((g_bus_n >= BUS_DEPTH) || (len > CAN_MAX_DATA)) { return false; }
+    BusFrame* f = &g_bus[g_bus_n++];
+    (void)memset(f, 0, sizeof(*f));
+    f->due_ms = g_now + BUS_LATENCY_MS;
+    f->from = node;
+    f->m.id = id;
+    f->m.len = len;
+    (void)memcpy(f->m.data, data, len);
+    return true;
+}
+
+static void bus_deliver(void)
+{
+    uint32_t keep = 0U;
+    for (uint32_t i = 0U; i < g_bus_n; i++) {
+        BusFrame* f = &g_bus[i];
+        if ((int32_t)(f->due_ms - g_now) > 0) { g_bus[keep++] = *f; continue; }
+        f->m.at_ms = g_now;
+        for (uint32_t n = 0U; n < N_NODES; n++) {
+            if ((NODES[n]->id == f->from) || g_frozen[n]) { continue; }
+            if ((uint32_t)(rand() % 1000) < g_loss_pm) { continue; }
+            NODES[n]->rx(&f->m);
+            NODES[n]->dispatch();
+        }
+    }
+    g_bus_n = keep;
+}
+
+/* Journal des montées d’étage de l’installation */
+typedef struct {
+    uint32_t ups;
+    uint32_t min_gap_ms;
+    uint32_t last_up_ms;
+    uint32_t all_heating_ms;          /* 0: jamais */
+} SimResult;
+
+static SimResult run(uint32_t loss_pm, int frozen_node, uint32_t freeze_at_ms)
+{
+    SimResult r = { 0U, UINT32_MAX, 0U, 0U };
+    uint8_t prev[N_NODES];
+
+    g_now = 0U;
+    g_bus_n = 0U;
+    g_loss_pm = loss_pm;
+    for (uint32_t n = 0U; n < N_NODES; n++) {
+        g_frozen[n] = false;
+        NODES[n]->init();
+        NODES[n]->push(EVT_USER_MODE_ELEC);
+        NODES[n]->push(EVT_TH_ON);               /* même instant pour toutes: le pire cas */
+        NODES[n]->dispatch();
+        prev[n] = NODES[n]->stages();
+    }
+
+    for (g_now = 1U; g_now <= RUN_MS; g_now++) {
+        if ((frozen_node >= 0) && (g_now == freeze_at_ms)) { g_frozen[frozen_node] = true; }
+        bus_deliver();
+        bool all = true;
+        for (uint32_t n = 0U; n < N_NODES; n++) {
+            if (!g_frozen[n]) {
+                /* Ticks déphasés: les unités n’ont pas démarré au même instant */
+                if (((g_now + (n * 3U)) % TMR_TICK_MS) == 0U) { NODES[n]->tick(); }
+                NODES[n]->dispatch();
+            }
+            const uint8_t st = NODES[n]->stages();
+            if (st > prev[n]) {
+                if (r.ups != 0U) {
+                    const uint32_t gap = g_now - r.last_up_ms;
+                    if (gap < r.min_gap_ms) { r.min_gap_ms = gap; }
+                }
+                r.ups++;
+                r.last_up_ms = g_now;
+            }
+            prev[n] = st;
+            if (!g_frozen[n] && (NODES[n]->state() != ST_HEAT_ELEC)) { all = false; }
+        }
+        if (all && (r.all_heating_ms == 0U)) { r.all_heating_ms = g_now; }
+    }
+    return r;
+}
+
+static void report(const char* name, const SimResult* r)
+{
+    printf("%-22s montées %2u, écart min %5u ms, toutes en chauffe à %6u ms\n",
+           name, r->ups, (r->min_gap_ms == UINT32_MAX) ? 0U : r->min_gap_ms, r->all_heating_ms);
+}
+
+int main(void)
+{
+    srand(45);
+
+    /* Bus sain: 9 montées, jamais deux à moins de COORD_GAP_MS */
+    SimResult r = run(0U, -1, 0U);
+    report("bus sain", &r);
+    CHECK(r.ups == (N_NODES * 3U));
+    CHECK(r.min_gap_ms >= COORD_GAP_MS);
+    CHECK(r.all_heating_ms != 0U);
+
+    /* 10 % de pertes par récepteur: l’âge diffusé de la dernière montée rattrape
+       les trames perdues, l’écart est tenu */
+    r = run(100U, -1, 0U);
+    report("pertes 10 %", &r);
+    CHECK(r.ups == (N_NODES * 3U));
+    CHECK(r.min_gap_ms >= COORD_GAP_MS);
+    CHECK(r.all_heating_ms != 0U);
+
+    /* Bus coupé: chaque unité seule, elle chauffe quand même */
+    r = run(1000U, -1, 0U);
+    report("bus coupé", &r);
+    CHECK(r.ups == (N_NODES * 3U));
+    CHECK(r.all_heating_ms != 0U);
+
+    /* Nœud 1 figé alors que sa demande est en cours (avant sa première montée):
+       oublié après COORD_PEER_TIMEOUT_MS, les autres chauffent */
+    r = run(0U, 0, 100U);
+    report("pair figé", &r);
+    CHECK(r.all_heating_ms != 0U);
+    CHECK(r.min_gap_ms >= COORD_GAP_MS);
+
+    if (g_fail != 0) { printf("%d échec(s)\n", g_fail); return 1; }
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,60 @@
+/* Une unité de l’installation simulée (voir sim_node.h). Même aiguillage que
+   App_Dispatch() pour les événements qui concernent la coordination. */
+#include "sim_node.h"
+#include "coord.h"
+#include "timers.h"
+#include "tpo.h"
+
+/* ---- Hooks ---- */
+bool can_send(uint32_t id, bool ext, const uint8_t* data, uint8_t len)
+{
+    if (ext) { return false; }
+    return sim_bus_send((uint8_t)COORD_NODE_ID, id, data, len);
+}
+
+uint32_t coord_now_ms(void) { return sim_now_ms(); }
+
+/* Comme main.c */
+void coord_local(uint8_t* state, uint8_t* stages, uint8_t* demand)
+{
+    const FsmState st = fsm_state();
+    *state  = (uint8_t)st;
+    *stages = fsm_stages();
+    *demand = ((st == ST_STARTING) || (st == ST_HEAT_ELEC)) ? 3U : 0U;
+}
+
+void tpo_apply(uint32_t on_mask) { (void)on_mask; }
+
+/* ---- Entrée du nœud ---- */
+static void node_init(void)
+{
+    evq_init();
+    tmr_init();
+    tpo_init();
+    fsm_init(ST_IDLE);
+    coord_init();
+}
+
+static void node_dispatch(void)
+{
+    EventMsg ev;
+    for (;;) {
+        if (!tmr_pop_expired(&ev) && !evq_pop_next(&ev)) { break; }
+        if (ev.type == EVT_COORD_TICK) { coord_on_tick(); continue; }
+        if (ev.type == EVT_TPO_EDGE)   { tpo_on_edge(); continue; }
+        if (!fsm_handle_event(&ev)) { evq_note_ignored(ev.type); }
+    }
+}
+
+static void node_push(EventType type) { (void)evq_push(EVQ_NORMAL, type, EVARG_NONE()); }
+
+const SimNode sim_node = {
+    .id       = (uint8_t)COORD_NODE_ID,
+    .init     = node_init,
+    .tick     = tmr_tick,
+    .dispatch = node_dispatch,
+    .push     = node_push,
+    .rx       = coord_on_rx,
+    .state    = fsm_state,
+    .stages   = fsm_stages,
+};
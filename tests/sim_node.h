@@ -0,0 +1,26 @@
+/* Nœud simulé: coord, fsm, timers, files et tpo d’une unité, compilés une fois
+   par identifiant (COORD_NODE_ID) avec sim_rename.h. Le banc (sim_coord.c)
+   fournit l’horloge et le bus CAN virtuel. */
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "events.h"
+#include "fsm.h"
+#include "can_svc.h"
+
+typedef struct {
+    uint8_t  id;
+    void     (*init)(void);
+    void     (*tick)(void);                 /* un tick du service timers (TMR_TICK_MS) */
+    void     (*dispatch)(void);             /* sert expirations puis file normale */
+    void     (*push)(EventType type);       /* producteur normal (entrées) */
+    void     (*rx)(const CanMsg* m);        /* trame reçue du bus virtuel */
+    FsmState (*state)(void);
+    uint8_t  (*stages)(void);
+} SimNode;
+
+/* Fournis par le banc (non renommés) */
+uint32_t sim_now_ms(void);
+bool     sim_bus_send(uint8_t node, uint32_t id, const uint8_t* data, uint8_t len);
+
+extern const SimNode sim_node_1, sim_node_2, sim_node_3;
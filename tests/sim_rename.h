@@ -0,0 +1,70 @@
+/* Inclus en tête (-include) de chaque source d’un nœud simulé: les symboles
+   globaux des modules prennent le suffixe du nœud (coord_init → coord_init_2),
+   pour lier plusieurs unités dans un même exécutable de simulation. */
+#pragma once
+
+#define SIM_CAT2(a, b) a##_##b
+#define SIM_CAT(a, b)  SIM_CAT2(a, b)
+#define SIM_NS(x)      SIM_CAT(x, COORD_NODE_ID)
+
+/* Entrée du nœud (sim_node.c) */
+#define sim_node               SIM_NS(sim_node)
+
+/* coord.c */
+#define coord_cancel_request   SIM_NS(coord_cancel_request)
+#define coord_decode           SIM_NS(coord_decode)
+#define coord_encode           SIM_NS(coord_encode)
+#define coord_get_peer         SIM_NS(coord_get_peer)
+#define coord_init             SIM_NS(coord_init)
+#define coord_on_rx            SIM_NS(coord_on_rx)
+#define coord_on_tick          SIM_NS(coord_on_tick)
+#define coord_request_stage    SIM_NS(coord_request_stage)
+
+/* events.c */
+#define evq_get_stats          SIM_NS(evq_get_stats)
+#define evq_init               SIM_NS(evq_init)
+#define evq_note_ignored       SIM_NS(evq_note_ignored)
+#define evq_pop                SIM_NS(evq_pop)
+#define evq_pop_next           SIM_NS(evq_pop_next)
+#define evq_push               SIM_NS(evq_push)
+#define evq_set_coalesce       SIM_NS(evq_set_coalesce)
+
+/* fsm.c, fsm_guards.c */
+#define fsm_guards_init        SIM_NS(fsm_guards_init)
+#define fsm_guards_observe     SIM_NS(fsm_guards_observe)
+#define fsm_handle_event       SIM_NS(fsm_handle_event)
+#define fsm_init               SIM_NS(fsm_init)
+#define fsm_is_critical        SIM_NS(fsm_is_critical)
+#define fsm_stages             SIM_NS(fsm_stages)
+#define fsm_state              SIM_NS(fsm_state)
+#define guard_cooldown_done    SIM_NS(guard_cooldown_done)
+#define guard_lockout_clear    SIM_NS(guard_lockout_clear)
+#define guard_no_fault         SIM_NS(guard_no_fault)
+#define guard_target_is_elec   SIM_NS(guard_target_is_elec)
+#define guard_target_is_gas    SIM_NS(guard_target_is_gas)
+#define guard_temp_is_safe     SIM_NS(guard_temp_is_safe)
+
+/* timers.c */
+#define tmr_cancel             SIM_NS(tmr_cancel)
+#define tmr_init               SIM_NS(tmr_init)
+#define tmr_is_active          SIM_NS(tmr_is_active)
+#define tmr_next_expiry_ms     SIM_NS(tmr_next_expiry_ms)
+#define tmr_pop_expired        SIM_NS(tmr_pop_expired)
+#define tmr_remaining_ms       SIM_NS(tmr_remaining_ms)
+#define tmr_set                SIM_NS(tmr_set)
+#define tmr_set_slack          SIM_NS(tmr_set_slack)
+#define tmr_tick               SIM_NS(tmr_tick)
+
+/* tpo.c */
+#define tpo_init               SIM_NS(tpo_init)
+#define tpo_on_edge            SIM_NS(tpo_on_edge)
+#define tpo_outputs            SIM_NS(tpo_outputs)
+#define tpo_set_duty           SIM_NS(tpo_set_duty)
+#define tpo_start              SIM_NS(tpo_start)
+#define tpo_stop               SIM_NS(tpo_stop)
+
+/* Hooks fournis par sim_node.c */
+#define can_send               SIM_NS(can_send)
+#define coord_local            SIM_NS(coord_local)
+#define coord_now_ms           SIM_NS(coord_now_ms)
+#define tpo_apply              SIM_NS(tpo_apply)
@@ -0,0 +1,125 @@
+/* Anti-flap et ventilation minimale: timers armés avec tolérance (tmr_set_slack)
+   en fin de chauffe, demande mémorisée pendant le lockout puis servie, y compris
+   quand le COOLDOWN dure plus que le lockout. Deux timers tolérants proches
+   expirent sur un seul réveil. */
+#include "fsm.h"
+#include "coord.h"
+#include <stdio.h>
+
+static int g_fail;
+#define CHECK(c) do { if (!(c)) { printf("ECHEC %s:%d: %s\n", __FILE__, __LINE__, #c); g_fail++; } } while (0)
+
+/* Coordination: jeton toujours accordé */
+bool coord_request_stage(void) { return true; }
+void coord_cancel_request(void) {}
+void tpo_apply(uint32_t on_mask) { (void)on_mask; }
+
+static unsigned g_wakeups;   /* ticks où au moins un timer a expiré */
+
+static void push(EventType t)
+{
+    const EventMsg ev = { .type = t, .arg = EVARG_NONE(), .tick = 0U };
+    (void)fsm_handle_event(&ev);
+}
+
+/* Dispatcher minimal: timers expirés puis file normale */
+static void drain(void)
+{
+    EventMsg ev;
+    bool any = false;
+    for (;;) {
+        if (tmr_pop_expired(&ev)) { any = true; }
+        else if (!evq_pop_next(&ev)) { break; }
+        (void)fsm_handle_event(&ev);
+    }
+    if (any) { g_wakeups++; }
+}
+
+static void run_ms(uint32_t ms)
+{
+    for (uint32_t t = 0U; t < ms / TMR_TICK_MS; t++) { tmr_tick(); drain(); }
+}
+
+int main(void)
+{
+    evq_init();
+    tmr_init();
+    fsm_init(ST_IDLE);
+
+    /* Gaz: chauffe directe, puis arrêt → COOLDOWN avec les deux timers armés */
+    push(EVT_USER_MODE_GAS);
+    push(EVT_TH_ON);
+    CHECK(fsm_state() == ST_HEAT_GAS);
+    run_ms(1230U);                                   /* phase quelconque du tick */
+    push(EVT_TH_OFF);
+    CHECK(fsm_state() == ST_COOLDOWN);
+    CHECK(tmr_is_active(TMR_MIN_OFF) && tmr_is_active(TMR_COOLDOWN_MIN));
+
+    /* Tolérance appliquée: jamais avant l’échéance, au plus slack après */
+    const uint32_t off = tmr_remaining_ms(TMR_MIN_OFF);
+    const uint32_t cool = tmr_remaining_ms(TMR_COOLDOWN_MIN);
+    CHECK((off >= 120000U) && (off <= 125000U));
+    CHECK((cool >= 60000U) && (cool <= 65000U));
+
+    /* Demande pendant COOLDOWN: pas de redémarrage */
+    push(EVT_TH_ON);
+    CHECK(fsm_state() == ST_COOLDOWN);
+
+    run_ms(cool);
+    CHECK(fsm_state() == ST_IDLE);                   /* ventilation minimale écoulée, température sûre */
+
+    /* Demande toujours présente: servie à la fin du lockout, pas avant */
+    push(EVT_TH_ON);
+    CHECK(fsm_state() == ST_IDLE);
+    run_ms(off - cool);
+    CHECK(fsm_state() == ST_HEAT_GAS);
+
+    /* Nouvel arrêt: un réveil par timer, jamais un par tick */
+    push(EVT_TH_OFF);
+    g_wakeups = 0U;
+    run_ms(130000U);
+    CHECK(fsm_state() == ST_IDLE);
+    CHECK(g_wakeups == 2U);                          /* COOLDOWN_MIN, MIN_OFF: un réveil chacun */
+
+    /* COOLDOWN prolongé (température pas sûre) au-delà du lockout: demande servie à la sortie */
+    push(EVT_TH_ON);
+    CHECK(fsm_state() == ST_HEAT_GAS);
+    push(EVT_OVERTEMP_WARN);
+    push(EVT_TH_OFF);
+    push(EVT_TH_ON);
+    run_ms(130000U);
+    CHECK(fsm_state() == ST_COOLDOWN);
+    CHECK(!tmr_is_active(TMR_MIN_OFF));              /* EVT_MIN_OFF_DONE reçu en COOLDOWN */
+    push(EVT_TEMP_SAFE);
+    CHECK(fsm_state() == ST_IDLE);
+    drain();
+    CHECK(fsm_state() == ST_HEAT_GAS);
+
+    /* Sans demande: retour en IDLE et on y reste */
+    push(EVT_OVERTEMP_WARN);
+    push(EVT_TH_OFF);
+    run_ms(130000U);
+    push(EVT_TEMP_SAFE);
+    drain();
+    CHECK(fsm_state() == ST_IDLE);
+
+    /* Fusion: le second timer tolérant tombe sur le tick du premier, un seul réveil */
+    CHECK(tmr_set(TMR_USER_0, 10000U, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE()));
+    CHECK(tmr_set_slack(TMR_USER_1, 8000U, 5000U, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE()));
+    CHECK(tmr_remaining_ms(TMR_USER_1) == tmr_remaining_ms(TMR_USER_0));
+    g_wakeups = 0U;
+    run_ms(10000U);
+    CHECK(!tmr_is_active(TMR_USER_0) && !tmr_is_active(TMR_USER_1));
+    CHECK(g_wakeups == 1U);
+
+    /* Témoin sans tolérance: deux réveils */
+    CHECK(tmr_set(TMR_USER_0, 10000U, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE()));
+    CHECK(tmr_set(TMR_USER_1, 8000U, EVT_SEQ_STEP_TIMEOUT, EVARG_NONE()));
+    g_wakeups = 0U;
+    run_ms(10000U);
+    CHECK(g_wakeups == 2U);
+
+    if (g_fail != 0) { printf("%d échec(s)\n", g_fail); return 1; }
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,198 @@
+/* Mise à jour firmware (fwupd.c) par son protocole CAN, flash en mémoire:
+   trames perdues (NAK), image complète relue, table de vecteurs contrôlée
+   avant l’échange de banques, démarrage à l’essai confirmé après
+   FWUPD_CONFIRM_MS (pas de session tant qu’il ne l’est pas). */
+#include "fwupd.h"
+#include <stdio.h>
+#include <string.h>
+
+static int g_fail;
+#define CHECK(c) do { if (!(c)) { printf("ECHEC %s:%d: %s\n", __FILE__, __LINE__, #c); g_fail++; } } while (0)
+
+#define IMG_SIZE  ((3U * FWUPD_BLOCK) + 48U)   /* dernier bloc court */
+
+/* Banque inactive simulée: opérations terminées aussitôt, fin signalée à fwupd */
+static uint8_t  g_flash[64U * 1024U] __attribute__((aligned(16)));
+static uint8_t  g_rsp[8];
+static bool     g_rsp_new;
+static uint32_t g_now;
+static bool     g_trial;
+static uint32_t g_commits, g_confirms, g_kicks;
+
+bool can_send(uint32_t id, bool ext, const uint8_t* data, uint8_t len)
+{
+    (void)ext;
+    CHECK(id == (FWUPD_ID_RSP + COORD_NODE_ID));
+    (void)memcpy(g_rsp, data, (len < 8U) ? len : 8U);
+    g_rsp_new = true;
+    return true;
+}
+
+uint32_t fwupd_now_ms(void) { return g_now; }
+
+uint32_t hw_fwupd_capacity(void) { return sizeof(g_flash); }
+
+bool hw_fwupd_erase_start(uint32_t size)
+{
+    (void)memset(g_flash, 0xFF, size);
+    fwupd_on_erase_done(true);
+    return true;
+}
+
+bool hw_fwupd_program_start(uint32_t off, const uint8_t* src, uint32_t n)
+{
+    CHECK((n % 16U) == 0U);
+    (void)memcpy(&g_flash[off], src, n);
+    fwupd_on_program_done(true);
+    return true;
+}
+
+const uint8_t* hw_fwupd_staged(void) { return g_flash; }
+
+uint32_t hw_fwupd_crc32(const uint8_t* p, uint32_t n)
+{
+    uint32_t c = 0xFFFFFFFFU;
+    for (uint32_t i = 0U; i < n; i++) {
+        c ^= p[i];
+        for (uint32_t k = 0U; k < 8U; k++) { c = (c >> 1) ^ (0xEDB88320U & (0U - (c & 1U))); }
+    }
+    return ~c;
+}
+
+/* Même règle que hw_fwupd_stm32.c (H503: 32 Ko de SRAM, image liée en 0x08000000) */
+bool hw_fwupd_vectors_ok(uint32_t size)
+{
+    uint32_t v[2];
+    (void)memcpy(v, g_flash, sizeof(v));
+    const uint32_t rst = v[1] & ~1U;
+    return (size >= 8U) && (v[0] > 0x20000000U) && (v[0] <= 0x20008000U) && ((v[0] & 7U) == 0U)
+        && ((v[1] & 1U) != 0U) && (rst >= 0x08000008U) && (rst < (0x08000000U + size));
+}
+
+void hw_fwupd_lock(void) {}
+void hw_fwupd_commit(void) { g_commits++; }
+bool hw_fwupd_trial(void) { return g_trial; }
+void hw_fwupd_confirm(void) { g_confirms++; }
+void hw_fwupd_kick(void) { g_kicks++; }
+
+static void put16(uint8_t* p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(&p[2], v >> 16); }
+
+/* Trame de l’outil, puis quelques tours de boucle principale */
+static void cmd(const uint8_t* d, uint8_t len)
+{
+    CanMsg m = { .id = FWUPD_ID_CMD + COORD_NODE_ID, .len = len };
+    (void)memcpy(m.data, d, len);
+    g_rsp_new = false;
+    fwupd_on_rx(&m);
+    for (uint32_t i = 0U; i < 4U; i++) { fwupd_poll(); }
+}
+
+static bool rsp(uint8_t op) { return g_rsp_new && (g_rsp[0] == op); }
+
+static void send_block(const uint8_t* img, uint16_t b, uint32_t skip_mask)
+{
+    const uint32_t off = (uint32_t)b * FWUPD_BLOCK;
+    const uint32_t n = ((IMG_SIZE - off) < FWUPD_BLOCK) ? (IMG_SIZE - off) : FWUPD_BLOCK;
+    uint8_t f[CAN_MAX_DATA];
+    for (uint32_t i = 0U; (i * FWUPD_FRAME_DATA) < n; i++) {
+        if ((skip_mask & (1UL << i)) != 0U) { continue; }
+        const uint32_t k = ((n - (i * FWUPD_FRAME_DATA)) < FWUPD_FRAME_DATA) ? (n - (i * FWUPD_FRAME_DATA)) : FWUPD_FRAME_DATA;
+        f[0] = FWUPD_OP_DATA;
+        put16(&f[1], b);
+        f[3] = (uint8_t)i;
+        (void)memcpy(&f[4], &img[off + (i * FWUPD_FRAME_DATA)], k);
+        cmd(f, (uint8_t)(4U + k));
+    }
+    f[0] = FWUPD_OP_BLKEND;
+    put16(&f[1], b);
+    put32(&f[3], hw_fwupd_crc32(&img[off], n));
+    cmd(f, 7U);
+}
+
+/* Session complète; retourne la réponse à FINISH (DONE ou ERR) */
+static uint8_t transfer(const uint8_t* img)
+{
+    uint8_t f[8] = { FWUPD_OP_START };
+    put32(&f[1], IMG_SIZE);
+    cmd(f, 5U);
+    CHECK(rsp(FWUPD_OP_READY));
+
+    const uint16_t nblk = (uint16_t)((IMG_SIZE + FWUPD_BLOCK - 1U) / FWUPD_BLOCK);
+    for (uint16_t b = 0U; b < nblk; b++) {
+        send_block(img, b, (b == 1U) ? 0x5U : 0U);   /* bloc 1: trames 0 et 2 perdues */
+        if (b == 1U) {
+            CHECK(rsp(FWUPD_OP_NAK) && (g_rsp[3] == 0x5U) && (g_rsp[4] == 0U));
+            send_block(img, b, ~0x5U);
+        }
+        CHECK(rsp(FWUPD_OP_ACK) && (g_rsp[1] == (uint8_t)b));
+    }
+    f[0] = FWUPD_OP_FINISH;
+    put32(&f[1], hw_fwupd_crc32(img, IMG_SIZE));
+    cmd(f, 5U);
+    CHECK(g_rsp_new);
+    return g_rsp[0];
+}
+
+static void commit(void)
+{
+    const uint8_t f[1] = { FWUPD_OP_COMMIT };
+    cmd(f, 1U);
+}
+
+static void make_image(uint8_t* img, uint32_t sp, uint32_t reset)
+{
+    for (uint32_t i = 0U; i < IMG_SIZE; i++) { img[i] = (uint8_t)((i * 7U) ^ (i >> 8)); }
+    put32(&img[0], sp);
+    put32(&img[4], reset);
+}
+
+int main(void)
+{
+    static uint8_t img[IMG_SIZE];
+
+    /* Image amorçable: relue conforme, COMMIT échange les banques */
+    fwupd_init();
+    make_image(img, 0x20008000U, 0x08000201U);
+    CHECK(transfer(img) == FWUPD_OP_DONE);
+    CHECK((g_rsp[1] == 1U) && (fwupd_state() == FWUPD_VERIFIED));
+    CHECK(memcmp(g_flash, img, IMG_SIZE) == 0);
+    commit();
+    CHECK(g_commits == 1U);
+
+    /* Pile initiale hors SRAM, puis reset hors image ou sans bit Thumb: refusées */
+    const uint32_t bad[3][2] = { { 0x08001000U, 0x08000201U }, { 0x20008000U, 0x08010001U }, { 0x20008000U, 0x08000200U } };
+    for (uint32_t i = 0U; i < 3U; i++) {
+        fwupd_init();
+        make_image(img, bad[i][0], bad[i][1]);
+        CHECK(transfer(img) == FWUPD_OP_ERR);
+        CHECK((g_rsp[1] == FWUPD_ERR_IMAGE) && (fwupd_state() == FWUPD_FAILED));
+        commit();
+        CHECK(rsp(FWUPD_OP_ERR));
+    }
+    CHECK(g_commits == 1U);
+
+    /* À l’essai: START refusé (banque inactive = repli), confirmation au délai */
+    g_trial = true;
+    g_now = 1000U;
+    fwupd_init();
+    CHECK(fwupd_on_trial());
+    uint8_t f[8] = { FWUPD_OP_START };
+    put32(&f[1], IMG_SIZE);
+    cmd(f, 5U);
+    CHECK(rsp(FWUPD_OP_ERR) && (g_rsp[1] == FWUPD_ERR_STATE));
+    g_kicks = 0U;
+    g_now += FWUPD_CONFIRM_MS - 1U;
+    fwupd_poll();
+    CHECK((g_confirms == 0U) && (g_kicks == 1U));
+    g_now++;
+    fwupd_poll();
+    CHECK((g_confirms == 1U) && !fwupd_on_trial());
+    fwupd_poll();
+    CHECK(g_confirms == 1U);
+    make_image(img, 0x20008000U, 0x08000201U);
+    CHECK(transfer(img) == FWUPD_OP_DONE);
+
+    if (g_fail == 0) { printf("ok\n"); }
+    return (g_fail == 0) ? 0 : 1;
+}
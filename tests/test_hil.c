@@ -0,0 +1,97 @@
+/* Banc de test (hil.c, HIL_ENABLE=1): le gel retient le dispatcher tant que
+   l’hôte envoie des requêtes, et se relâche seul après HIL_FREEZE_MAX_MS
+   sans requête (STEP en attente répondu). */
+#include "hil.h"
+#include "telem.h"
+#include "fsm.h"
+#include "timers.h"
+#include <stdio.h>
+#include <string.h>
+
+static int g_fail;
+#define CHECK(c) do { if (!(c)) { printf("ECHEC %s:%d: %s\n", __FILE__, __LINE__, #c); g_fail++; } } while (0)
+
+static uint32_t g_now;
+static uint8_t  g_rsp[TELEM_MAX_PAYLOAD];
+static bool     g_rsp_new;
+
+uint32_t hil_now_ms(void) { return g_now; }
+
+bool telem_send(uint8_t type, const void* p, uint16_t n)
+{
+    CHECK(type == TELEM_T_HIL);
+    (void)memcpy(g_rsp, p, n);
+    g_rsp_new = true;
+    return true;
+}
+
+uint16_t telem_crc16(const uint8_t* p, uint32_t n) { (void)p; (void)n; return 0x1234U; }
+
+FsmState fsm_state(void) { return ST_IDLE; }
+uint8_t  fsm_stages(void) { return 0U; }
+
+/* Requête encodée comme tools/hil.py (CRC figé par le stub ci-dessus) */
+static void req(uint8_t seq, uint8_t op, const uint8_t* a, uint32_t n)
+{
+    uint8_t raw[16] = { TELEM_T_HIL, seq, op };
+    uint8_t enc[20];
+    (void)memcpy(&raw[3], a, n);
+    raw[3U + n] = 0x12U;
+    raw[4U + n] = 0x34U;
+    const uint32_t len = 5U + n;
+
+    uint32_t o = 1U, code_at = 0U;
+    uint8_t code = 1U;
+    for (uint32_t i = 0U; i < len; i++) {
+        if (raw[i] == 0U) { enc[code_at] = code; code_at = o++; code = 1U; }
+        else { enc[o++] = raw[i]; code++; }
+    }
+    enc[code_at] = code;
+    g_rsp_new = false;
+    hil_on_frame(enc, o);
+}
+
+int main(void)
+{
+    const uint8_t on[1] = { 1U };
+    const uint8_t steps[2] = { 5U, 0U };
+
+    evq_init();
+    tmr_init();
+    hil_init();
+    CHECK(hil_gate());
+
+    /* Hôte actif: le gel tient au-delà du délai tant que les requêtes arrivent */
+    g_now = 100U;
+    req(1U, HIL_OP_FREEZE, on, 1U);
+    CHECK(g_rsp_new && (g_rsp[2] == HIL_OK) && !hil_gate());
+    g_now += HIL_FREEZE_MAX_MS - 1U;
+    hil_poll();
+    CHECK(!hil_gate());
+    req(2U, HIL_OP_PING, NULL, 0U);
+    CHECK(g_rsp_new && (g_rsp[6] == 1U));
+    g_now += HIL_FREEZE_MAX_MS - 1U;
+    hil_poll();
+    CHECK(!hil_gate());
+
+    /* Hôte perdu: relâché au délai, sans attendre de requête */
+    g_now++;
+    hil_poll();
+    HilStats s;
+    hil_get_stats(&s);
+    CHECK(hil_gate() && (s.expired == 1U));
+
+    /* STEP en attente au moment du relâchement: réponse envoyée quand même */
+    req(3U, HIL_OP_FREEZE, on, 1U);
+    req(4U, HIL_OP_STEP, steps, 2U);
+    CHECK(!g_rsp_new && hil_gate());
+    g_now += HIL_FREEZE_MAX_MS;
+    hil_poll();
+    CHECK(g_rsp_new && (g_rsp[0] == 4U) && (g_rsp[1] == HIL_OP_STEP) && (g_rsp[3] == 0U));
+    CHECK(hil_gate());
+    hil_get_stats(&s);
+    CHECK(s.expired == 2U);
+
+    if (g_fail == 0) { printf("ok\n"); }
+    return (g_fail == 0) ? 0 : 1;
+}
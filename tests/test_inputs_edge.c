@@ -0,0 +1,84 @@
+/* Mode EXTI (compilé avec INP_SRC=INP_SRC_EXTI): inputs_on_edge() appelé en
+   ISR ne touche pas au service timers; l’échéance est armée par
+   inputs_process() puis confirmée par inputs_on_settle(). */
+#include "inputs.h"
+#include "timers.h"
+#include "events.h"
+#include <stdio.h>
+
+static int g_fail;
+#define CHECK(c) do { if (!(c)) { printf("ECHEC %s:%d: %s\n", __FILE__, __LINE__, #c); g_fail++; } } while (0)
+
+static uint32_t g_pins;   /* niveau électrique des voies */
+uint32_t hw_inputs_snapshot(void) { return g_pins; }
+
+static const InpDesc k_desc[] = {
+    { INP_CH_TH, 0U, 30U, EVT_TH_ON, EVT_TH_OFF, INP_SEL_NONE, 0U, 0U, 0U, 0U, 0U },
+};
+
+static const TimerId k_tmr = (TimerId)(TMR_INP_0 + INP_CH_TH);
+
+/* Avance jusqu’à l’échéance et la livre à inputs_on_settle() */
+static void settle(uint32_t* now_ms)
+{
+    EventMsg ev;
+    for (unsigned t = 0U; t < 100U; t++) {
+        tmr_tick();
+        *now_ms += TMR_TICK_MS;
+        if (tmr_pop_expired(&ev)) {
+            CHECK(ev.type == EVT_INP_SETTLE);
+            inputs_on_settle(ev.arg.u8, *now_ms);
+            return;
+        }
+    }
+    CHECK(!"échéance jamais livrée");
+}
+
+int main(void)
+{
+    const InputsConfig cfg = { .desc = k_desc, .n_desc = 1U, .sel = NULL, .n_sel = 0U };
+    uint32_t now_ms = 0U;
+    EventMsg ev;
+
+    evq_init();
+    tmr_init();
+    inputs_init(&cfg);
+    g_pins = 0U;
+    inputs_seed_from_hw();
+
+    /* Front en ISR: rien n’est armé tant que la boucle principale n’est pas passée */
+    g_pins = INP_BIT(INP_CH_TH);
+    inputs_on_edge(INP_BIT(INP_CH_TH) | INP_BIT(INP_CH_MODEC));   /* voie hors table ignorée */
+    CHECK(!tmr_is_active(k_tmr));
+    inputs_process();
+    CHECK(tmr_is_active(k_tmr));
+    CHECK(tmr_remaining_ms(k_tmr) >= 30U);
+
+    /* Rebonds avant l’échéance: réarmée depuis le dernier front */
+    tmr_tick(); tmr_tick();
+    inputs_on_edge(INP_BIT(INP_CH_TH));
+    inputs_on_edge(INP_BIT(INP_CH_TH));
+    inputs_process();
+    CHECK(tmr_remaining_ms(k_tmr) >= 30U);
+
+    settle(&now_ms);
+    CHECK(evq_pop_next(&ev) && (ev.type == EVT_TH_ON));
+    CHECK(!evq_pop_next(&ev));
+
+    /* Parasite: front puis retour au niveau stable avant l’échéance → aucun événement */
+    g_pins = 0U;
+    inputs_on_edge(INP_BIT(INP_CH_TH));
+    g_pins = INP_BIT(INP_CH_TH);
+    inputs_on_edge(INP_BIT(INP_CH_TH));
+    inputs_process();
+    settle(&now_ms);
+    CHECK(!evq_pop_next(&ev));
+
+    /* Passage sans front: rien à armer */
+    inputs_process();
+    CHECK(!tmr_is_active(k_tmr));
+
+    if (g_fail != 0) { printf("%d échec(s)\n", g_fail); return 1; }
+    printf("ok\n");
+    return 0;
+}
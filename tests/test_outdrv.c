@@ -0,0 +1,123 @@
+/* Driver de sorties (outdrv.c) sur un faux backend, chaîne de 3 circuits:
+   aucune trame quand rien ne change, mot de chaque circuit à sa place
+   (LEN-1-dev), trame en erreur relancée par le flush suivant, défauts
+   d’état livrés une fois à l’apparition, coupure PGOOD. */
+#include "outdrv.h"
+#include <stdio.h>
+#include <string.h>
+
+static int g_fail;
+#define CHECK(c) do { if (!(c)) { printf("ECHEC %s:%d: %s\n", __FILE__, __LINE__, #c); g_fail++; } } while (0)
+
+_Static_assert(OUTDRV_CHAIN_LEN == 3U, "test écrit pour une chaîne de 3 circuits");
+
+/* Faux backend: la trame reste « en vol » jusqu’à done() */
+static uint16_t g_frame[OUTDRV_CHAIN_LEN];
+static uint32_t g_starts;
+static bool     g_in_flight;
+static bool     g_refuse;
+
+bool hw_outdrv_xfer_start(const uint16_t* tx, uint32_t n)
+{
+    CHECK(n == OUTDRV_CHAIN_LEN);
+    CHECK(!g_in_flight);
+    if (g_refuse) { return false; }
+    (void)memcpy(g_frame, tx, n * sizeof(tx[0]));
+    g_starts++;
+    g_in_flight = true;
+    return true;
+}
+
+void hw_outdrv_enable(bool on) { (void)on; }
+
+/* Fin de transfert; st[dev] = octet d’état renvoyé par le circuit dev */
+static void done(bool ok, const uint8_t st[OUTDRV_CHAIN_LEN])
+{
+    uint16_t rx[OUTDRV_CHAIN_LEN] = { 0U };
+    for (uint32_t dev = 0U; (st != NULL) && (dev < OUTDRV_CHAIN_LEN); dev++) {
+        rx[OUTDRV_CHAIN_SLOT(dev)] = (uint16_t)((uint16_t)st[dev] << 8);
+    }
+    g_in_flight = false;
+    outdrv_on_xfer_done(ok, ok ? rx : NULL);
+}
+
+static void drain(void)
+{
+    for (uint32_t i = 0U; g_in_flight && (i < 100U); i++) { done(true, NULL); }
+    CHECK(outdrv_idle());
+}
+
+int main(void)
+{
+    static const uint8_t ok_st[OUTDRV_CHAIN_LEN] = { 0U, 0U, 0U };
+    OutdrvStats s;
+    EventMsg ev;
+
+    /* Boot: tous les registres partent une fois */
+    outdrv_init();
+    CHECK(!outdrv_idle());
+    outdrv_flush();
+    drain();
+    CHECK(g_starts == OUTDRV_REG_COUNT);
+
+    /* Valeur déjà en place: pas de trame */
+    CHECK(outdrv_dev_write(1U, OUTDRV_REG_OUT, 0U));
+    CHECK(!g_in_flight && (g_starts == OUTDRV_REG_COUNT));
+    outdrv_get_stats(&s);
+    CHECK(s.skipped == 1U);
+
+    /* Ordre de chaîne: le mot du circuit dev est en position LEN-1-dev */
+    g_refuse = true;   /* retient la trame le temps de poser les deux circuits */
+    CHECK(outdrv_dev_write(0U, OUTDRV_REG_OUT, 0xA1U));
+    CHECK(outdrv_dev_write(2U, OUTDRV_REG_OUT, 0xC1U));
+    g_refuse = false;
+    outdrv_flush();
+    CHECK(g_in_flight);
+    CHECK(g_frame[2] == OUTDRV_FRAME_WR(OUTDRV_REG_OUT, 0xA1U));
+    CHECK(g_frame[1] == OUTDRV_FRAME_WR(OUTDRV_REG_OUT, 0U));
+    CHECK(g_frame[0] == OUTDRV_FRAME_WR(OUTDRV_REG_OUT, 0xC1U));
+
+    /* Erreur de transfert: rien depuis l’ISR, relancée au flush suivant */
+    const uint32_t starts = g_starts;
+    done(false, NULL);
+    CHECK(!g_in_flight && (g_starts == starts) && !outdrv_idle());
+    outdrv_flush();
+    CHECK(g_in_flight && (g_starts == starts + 1U));
+    CHECK(g_frame[2] == OUTDRV_FRAME_WR(OUTDRV_REG_OUT, 0xA1U));
+    done(true, ok_st);
+    CHECK(outdrv_idle());
+    CHECK(outdrv_dev_write(0U, OUTDRV_REG_OUT, 0xA1U));   /* désormais en place */
+    CHECK(!g_in_flight);
+    outdrv_get_stats(&s);
+    CHECK(s.errors == 3U);   /* deux refus de démarrage + la trame perdue */
+
+    /* Défaut d’état: livré une fois à l’apparition, de nouveau après retour */
+    const uint8_t oc[OUTDRV_CHAIN_LEN] = { 0U, 0U, OUTDRV_ST_OVERCURRENT };
+    outdrv_request_diag();
+    CHECK(g_in_flight && (g_frame[0] == OUTDRV_FRAME_RD(OUTDRV_REG_DIAG)));
+    done(true, oc);
+    CHECK(outdrv_pop_fault(&ev));
+    CHECK((ev.type == EVT_FAULT_OUT_OVERCURRENT) && (ev.arg.u16 == 2U) && (ev.arg.u8 == OUTDRV_ST_OVERCURRENT));
+    CHECK(!outdrv_pop_fault(&ev));
+    CHECK(outdrv_dev_status(2U) == OUTDRV_ST_OVERCURRENT);
+    outdrv_request_diag();
+    done(true, oc);
+    CHECK(!outdrv_pop_fault(&ev));   /* défaut maintenu */
+    outdrv_request_diag();
+    done(true, ok_st);
+    outdrv_request_diag();
+    done(true, oc);
+    CHECK(outdrv_pop_fault(&ev) && (ev.type == EVT_FAULT_OUT_OVERCURRENT));
+
+    /* Perte de PGOOD: défaut sur le circuit 0, tous les registres renvoyés */
+    outdrv_on_hw_trip(OUTDRV_TRIP_PGOOD);
+    CHECK(outdrv_pop_fault(&ev) && (ev.type == EVT_FAULT_OUT_POWER) && (ev.arg.u16 == 0U));
+    CHECK(!outdrv_pop_fault(&ev));
+    const uint32_t before = g_starts;
+    outdrv_flush();
+    drain();
+    CHECK(g_starts == before + OUTDRV_REG_COUNT);
+
+    if (g_fail == 0) { printf("ok\n"); }
+    return (g_fail == 0) ? 0 : 1;
+}
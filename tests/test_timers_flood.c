@@ -0,0 +1,126 @@
+/* Stress: EVQ_NORMAL saturée en continu pendant que tous les timers expirent.
+   Vérifie que chaque expiration est livrée exactement une fois par
+   tmr_pop_expired(), que tmr_tick() ne pousse rien dans les files (pas de
+   push raté retenté à chaque tick), et qu’un réarmement remplace bien une
+   expiration non livrée. */
+#include "timers.h"
+#include "events.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static int g_fail;
+#define CHECK(c) do { if (!(c)) { printf("ECHEC %s:%d: %s\n", __FILE__, __LINE__, #c); g_fail++; } } while (0)
+
+/* Remplit EVQ_NORMAL jusqu’au refus */
+static unsigned flood(void)
+{
+    unsigned n = 0U;
+    while (evq_push(EVQ_NORMAL, EVT_TEMP_SAFE, EVARG_NONE())) { n++; }
+    return n;
+}
+
+static void test_flood_no_loss(void)
+{
+    evq_init();
+    tmr_init();
+
+    unsigned armed[TMR_COUNT] = {0};
+    unsigned delivered[TMR_COUNT] = {0};
+    srand(26);
+
+    (void)flood();
+    EvQueueStats before;
+    evq_get_stats(EVQ_NORMAL, &before);
+
+    for (unsigned tick = 0U; tick < 200000U; tick++) {
+        /* Réarmements aléatoires (délais courts: beaucoup d’expirations) */
+        const unsigned id = (unsigned)rand() % TMR_COUNT;
+        if (!tmr_is_active((TimerId)id)) {
+            const uint32_t ms = ((uint32_t)rand() % 8U) * TMR_TICK_MS;
+            CHECK(tmr_set((TimerId)id, ms, EVT_SEQ_STEP_TIMEOUT, EVARG_U8((uint8_t)id)));
+            armed[id]++;
+        }
+        tmr_tick();
+
+        /* Dispatcher lent: draine une fois sur 4, file normale toujours pleine */
+        if ((tick % 4U) == 0U) {
+            EventMsg ev;
+            while (tmr_pop_expired(&ev)) {
+                CHECK(ev.type == EVT_SEQ_STEP_TIMEOUT);
+                CHECK(ev.arg.u8 < TMR_COUNT);
+                delivered[ev.arg.u8]++;
+            }
+        }
+    }
+    /* Fin: laisser tout expirer et tout livrer */
+    for (unsigned t = 0U; t < 16U; t++) { tmr_tick(); }
+    EventMsg ev;
+    while (tmr_pop_expired(&ev)) { delivered[ev.arg.u8]++; }
+
+    unsigned total = 0U;
+    for (unsigned i = 0U; i < TMR_COUNT; i++) {
+        CHECK(delivered[i] == armed[i]);
+        total += delivered[i];
+    }
+
+    /* Le tick n’a rien poussé: aucun refus supplémentaire sur la file pleine */
+    EvQueueStats after;
+    evq_get_stats(EVQ_NORMAL, &after);
+    CHECK(after.dropped == before.dropped);
+    CHECK(after.pushed == before.pushed);
+    printf("flood: %u expirations livrées sur file pleine, 0 perte, 0 push depuis le tick\n", total);
+}
+
+static void test_rearm_replaces_pending(void)
+{
+    evq_init();
+    tmr_init();
+    (void)flood();
+
+    CHECK(tmr_set(TMR_USER_0, TMR_TICK_MS, EVT_MIN_OFF_DONE, EVARG_NONE()));
+    tmr_tick();                                   /* expirée, non livrée */
+    CHECK(tmr_is_active(TMR_USER_0));             /* vrai jusqu’à la livraison */
+    CHECK(tmr_set(TMR_USER_0, 3U * TMR_TICK_MS, EVT_COOLDOWN_TIMEOUT, EVARG_NONE()));
+
+    EventMsg ev;
+    CHECK(!tmr_pop_expired(&ev));                 /* l’ancienne expiration est annulée */
+    tmr_tick(); tmr_tick(); tmr_tick();
+    CHECK(tmr_pop_expired(&ev) && (ev.type == EVT_COOLDOWN_TIMEOUT));
+    CHECK(!tmr_pop_expired(&ev));
+
+    tmr_cancel(TMR_USER_0);
+    CHECK(tmr_set(TMR_USER_0, TMR_TICK_MS, EVT_MIN_OFF_DONE, EVARG_NONE()));
+    tmr_tick();
+    tmr_cancel(TMR_USER_0);                       /* annulée après expiration: rien à livrer */
+    CHECK(!tmr_pop_expired(&ev));
+}
+
+/* Toutes les expirations d’un même tick, ordre des ids croissant */
+static void test_burst_order(void)
+{
+    evq_init();
+    tmr_init();
+    (void)flood();
+    for (unsigned i = 0U; i < TMR_COUNT; i++) {
+        CHECK(tmr_set((TimerId)i, 5U * TMR_TICK_MS, EVT_SEQ_STEP_TIMEOUT, EVARG_U8((uint8_t)i)));
+    }
+    for (unsigned t = 0U; t < 5U; t++) { tmr_tick(); }
+
+    EventMsg ev;
+    unsigned n = 0U;
+    while (tmr_pop_expired(&ev)) {
+        CHECK(ev.arg.u8 == n);
+        n++;
+    }
+    CHECK(n == TMR_COUNT);
+}
+
+int main(void)
+{
+    test_flood_no_loss();
+    test_rearm_replaces_pending();
+    test_burst_order();
+    if (g_fail != 0) { printf("%d échec(s)\n", g_fail); return 1; }
+    printf("ok\n");
+    return 0;
+}
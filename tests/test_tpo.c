@@ -0,0 +1,131 @@
+/* Modulation des éléments (tpo) et son pilotage par la séquence (fsm):
+   jamais deux allumages au même front, placement circulaire quand la somme
+   des rapports dépasse la période, énergie conforme au rapport demandé, et
+   arrêt de la modulation en fin de chauffe et en défaut. */
+#include "tpo.h"
+#include "fsm.h"
+#include "coord.h"
+#include <stdio.h>
+
+static int g_fail;
+#define CHECK(c) do { if (!(c)) { printf("ECHEC %s:%d: %s\n", __FILE__, __LINE__, #c); g_fail++; } } while (0)
+
+bool coord_request_stage(void) { return true; }
+void coord_cancel_request(void) {}
+
+/* Sorties appliquées: allumages par front et temps allumé par élément */
+static uint32_t g_mask;
+static uint32_t g_max_rise;
+static uint32_t g_on_ms[TPO_CH_COUNT];
+
+void tpo_apply(uint32_t on_mask)
+{
+    const uint32_t rise = on_mask & ~g_mask;
+    if ((uint32_t)__builtin_popcount(rise) > g_max_rise) { g_max_rise = (uint32_t)__builtin_popcount(rise); }
+    g_mask = on_mask;
+}
+
+static void push(EventType t, uint16_t u16)
+{
+    const EventMsg ev = { .type = t, .arg = EVARG_U16(u16), .tick = 0U };
+    (void)fsm_handle_event(&ev);
+}
+
+/* Dispatcher minimal: fronts de modulation à tpo, le reste à la FSM */
+static void run_ms(uint32_t ms)
+{
+    for (uint32_t t = 0U; t < ms / TMR_TICK_MS; t++) {
+        tmr_tick();
+        EventMsg ev;
+        for (;;) {
+            if (!tmr_pop_expired(&ev) && !evq_pop_next(&ev)) { break; }
+            if (ev.type == EVT_TPO_EDGE) { tpo_on_edge(); } else { (void)fsm_handle_event(&ev); }
+        }
+        for (uint32_t ch = 0U; ch < TPO_CH_COUNT; ch++) {
+            if ((g_mask & (1UL << ch)) != 0U) { g_on_ms[ch] += TMR_TICK_MS; }
+        }
+    }
+}
+
+static void reset(void)
+{
+    evq_init();
+    tmr_init();
+    tpo_init();
+    g_mask = 0U;
+    g_max_rise = 0U;
+}
+
+/* Rapports dont la somme dépasse la période: allumages distincts, énergie tenue */
+static void test_overflow(uint16_t duty)
+{
+    reset();
+    for (uint8_t ch = 0U; ch < TPO_CH_COUNT; ch++) { CHECK(tpo_set_duty(ch, duty)); }
+    tpo_start();
+    run_ms(TPO_PERIOD_MS);                           /* première période (sans queues) */
+
+    for (uint32_t ch = 0U; ch < TPO_CH_COUNT; ch++) { g_on_ms[ch] = 0U; }
+    run_ms(5U * TPO_PERIOD_MS);
+    CHECK(g_max_rise == 1U);
+    for (uint32_t ch = 0U; ch < TPO_CH_COUNT; ch++) {
+        const uint32_t want = 5U * (((uint32_t)duty * TPO_PERIOD_MS) / TPO_DUTY_MAX);
+        CHECK((g_on_ms[ch] + (5U * TMR_TICK_MS) >= want) && (g_on_ms[ch] <= want + (5U * TMR_TICK_MS)));
+    }
+    tpo_stop();
+    CHECK(g_mask == 0U);
+}
+
+/* Séquence élec: étages modulés à la puissance demandée, tout coupé à l’arrêt et en défaut */
+static void test_sequence(void)
+{
+    reset();
+    fsm_init(ST_IDLE);
+    push(EVT_USER_MODE_ELEC, 0U);
+    push(EVT_TH_ON, 0U);
+    CHECK(fsm_state() == ST_STARTING);
+    CHECK(tpo_outputs() == 0x1U);
+    run_ms(40000U);
+    CHECK(fsm_state() == ST_HEAT_ELEC);
+    CHECK(tpo_outputs() == 0x7U);                    /* pleine puissance par défaut */
+    CHECK(g_max_rise == 1U);
+
+    push(EVT_POWER_SET, 600U);
+    run_ms(TPO_PERIOD_MS);
+    for (uint32_t ch = 0U; ch < TPO_CH_COUNT; ch++) { g_on_ms[ch] = 0U; }
+    run_ms(2U * TPO_PERIOD_MS);
+    for (uint32_t ch = 0U; ch < TPO_CH_COUNT; ch++) {
+        CHECK((g_on_ms[ch] >= 11900U) && (g_on_ms[ch] <= 12100U));
+    }
+    CHECK(g_max_rise == 1U);
+
+    push(EVT_TH_OFF, 0U);
+    CHECK(fsm_state() == ST_STOPPING);
+    CHECK(fsm_stages() == 2U);
+    run_ms(40000U);
+    CHECK(fsm_state() == ST_COOLDOWN);
+    CHECK(g_mask == 0U);
+    CHECK(!tmr_is_active(TMR_TPO));
+
+    /* Défaut en chauffe: modulation arrêtée */
+    reset();
+    fsm_init(ST_IDLE);
+    push(EVT_USER_MODE_ELEC, 0U);
+    push(EVT_TH_ON, 0U);
+    run_ms(40000U);
+    push(EVT_FAULT_OUT_THERMAL, 0U);
+    CHECK(fsm_state() == ST_FAULT);
+    CHECK(g_mask == 0U);
+    CHECK(!tmr_is_active(TMR_TPO));
+}
+
+int main(void)
+{
+    test_overflow(600U);    /* 3 × 60 %: l’ancien placement allumait E2 et E3 ensemble */
+    test_overflow(500U);    /* 3 × 50 %: le troisième retombe sur 0, décalé d’un tick */
+    test_overflow(900U);
+    test_overflow(250U);    /* somme < période: file simple */
+    test_sequence();
+    if (g_fail != 0) { printf("%d échec(s)\n", g_fail); return 1; }
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Récupération d'un objet par le transfert de masse CAN FD (canbulk.h).
+
+Nécessite python-can et une interface CAN FD (débit nominal 125 kbit/s,
+données 1 Mbit/s, comme hw_can_stm32.h). Objets: 0 = instantané de
+diagnostic (CanBulkDiag, canbulk_table.c, affiché en clair); 1 = RAM et
+2 = flash seulement sur une unité compilée avec CANBULK_FULL_DUMP=1.
+
+    tools/can_bulk_pull.py --node 1 --obj 0 -o diag.bin
+    tools/can_bulk_pull.py --node 2 --obj 2 -o flash.bin --interface pcan --channel PCAN_USBBUS1
+"""
+import argparse
+import struct
+import sys
+import time
+
+ID_CMD, ID_CTRL, ID_DATA = 0x700, 0x740, 0x780
+OP_OPEN, OP_ACK, OP_ABORT, OP_NAK = 0x01, 0x02, 0x03, 0x04
+OP_INFO, OP_DONE, OP_ERR = 0x81, 0x82, 0xFF
+ERRORS = {1: "objet inconnu", 2: "outil muet (délai)", 3: "objet trop grand"}
+
+# CanBulkDiag version 1: mots 32 bits dans l'ordre des champs
+EVQ = ["pushed", "popped", "dropped", "coalesced", "ignored"]
+DIAG_FIELDS = (["version", "at_ms", "fsm_state", "stages", "tpo_out", "inputs"]
+               + ["evq_normal." + k for k in EVQ] + ["evq_faults." + k for k in EVQ]
+               + ["can." + k for k in ("received", "pool_empty", "hw_lost", "sent", "tx_full")]
+               + ["outdrv." + k for k in ("frames", "skipped", "errors")]
+               + ["telem." + k for k in ("frames", "bytes", "dropped", "errors")]
+               + ["log_dropped", "snap_overruns", "trip_count", "trip_source", "trip_isr_cycles", "trip_glitches"]
+               + ["inp_glitches[%d]" % i for i in range(8)] + ["inp_debounce_ms[%d]" % i for i in range(8)])
+
+
+def print_diag(data):
+    words = struct.unpack_from("<%dI" % (len(data) // 4), data)
+    if not words or words[0] != 1 or len(words) != len(DIAG_FIELDS):
+        print("instantané de version inconnue (%d mots)" % len(words), file=sys.stderr)
+        return
+    for name, v in zip(DIAG_FIELDS, words):
+        if name.startswith("inp_glitches") and v == 0xFFFFFFFF:
+            continue   # voie non décrite
+        print("%-22s %u" % (name, v))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--node", type=int, default=1, help="COORD_NODE_ID de l'unité")
+    ap.add_argument("--obj", type=int, default=0, help="numéro d'objet (CANBULK_OBJS)")
+    ap.add_argument("--window", type=int, default=16, help="segments accordés en vol (max 32 côté unité)")
+    ap.add_argument("--interface", default="socketcan")
+    ap.add_argument("--channel", default="can0")
+    ap.add_argument("-o", "--output", required=True)
+    args = ap.parse_args()
+
+    try:
+        import can
+    except ImportError:
+        sys.exit("python-can requis (pip install python-can)")
+
+    bus = can.Bus(interface=args.interface, channel=args.channel, fd=True,
+                  bitrate=125000, data_bitrate=1000000)
+    n = args.node
+    bus.set_filters([{"can_id": ID_CTRL + n, "can_mask": 0x7FF}, {"can_id": ID_DATA + n, "can_mask": 0x7FF}])
+
+    def cmd(data):
+        bus.send(can.Message(arbitration_id=ID_CMD + n, is_extended_id=False, data=bytes(data)))
+
+    def ack(op, nxt):
+        cmd([op, nxt & 0xFF, nxt >> 8, args.window])
+
+    size = nseg = None
+    for _ in range(5):
+        cmd([OP_OPEN, args.obj, args.window])
+        deadline = time.monotonic() + 0.5
+        while time.monotonic() < deadline:
+            m = bus.recv(0.1)
+            if m is None or m.arbitration_id != ID_CTRL + n:
+                continue
+            if m.data[0] == OP_ERR:
+                sys.exit("refus: " + ERRORS.get(m.data[2], str(m.data[2])))
+            if m.data[0] == OP_INFO:
+                size, nseg = struct.unpack_from("<IH", m.data, 2)
+                break
+        if size is not None:
+            break
+    if size is None:
+        sys.exit("pas de réponse de l'unité %d" % n)
+
+    seg = 62   # CANBULK_SEG_DATA en FD; 6 si l'unité est en CAN classique
+    out = bytearray()
+    expect = 0
+    since_ack = 0
+    nak_for = None
+    t0 = time.monotonic()
+    last = t0
+    while expect < nseg:
+        m = bus.recv(0.05)
+        if m is None:
+            if time.monotonic() - last > 0.1:
+                ack(OP_ACK, expect)   # relance (fenêtre ou ACK perdu)
+                last = time.monotonic()
+            continue
+        if m.arbitration_id == ID_CTRL + n and m.data[0] == OP_ERR:
+            sys.exit("abandon: " + ERRORS.get(m.data[2], str(m.data[2])))
+        if m.arbitration_id != ID_DATA + n:
+            continue
+        if expect == 0 and len(m.data) <= 8:
+            seg = 6
+        s = m.data[0] | (m.data[1] << 8)
+        if s == expect:
+            out += m.data[2:2 + min(seg, size - len(out))]
+            expect += 1
+            since_ack += 1
+            nak_for = None
+            last = time.monotonic()
+            if since_ack >= max(1, args.window // 2) or expect == nseg:
+                ack(OP_ACK, expect)
+                since_ack = 0
+        elif s > expect and nak_for != expect:
+            ack(OP_NAK, expect)   # trou: retour arrière une seule fois par trou
+            nak_for = expect
+        print("\r%d/%d segments" % (expect, nseg), end="", file=sys.stderr)
+
+    dt = time.monotonic() - t0
+    with open(args.output, "wb") as f:
+        f.write(out)
+    print("\n%d octets en %.2f s (%.1f ko/s)" % (len(out), dt, len(out) / 1024.0 / max(dt, 1e-6)), file=sys.stderr)
+    if args.obj == 0:
+        print_diag(bytes(out))
+
+
+if __name__ == "__main__":
+    main()
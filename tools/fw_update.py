@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+"""Mise à jour du firmware d'une unité par CAN (fwupd.h).
+
+L'image (.bin lié pour FLASH_BASE) est écrite dans la banque inactive pendant
+que l'unité tourne, vérifiée (CRC32 par bloc puis relecture complète), et les
+banques ne sont échangées qu'avec --commit, si la table de vecteurs de
+l'image est amorçable. La nouvelle image tourne alors à l'essai: sans
+confirmation (FWUPD_CONFIRM_MS de fonctionnement), l'unité revient d'elle-même
+à l'image précédente; pas de nouvelle mise à jour pendant l'essai.
+Nécessite python-can et une interface CAN FD (mêmes débits que hw_can_stm32.h);
+--classic pour une unité compilée avec CAN_FD=0.
+
+--loopback remplace le bus par LoopbackUnit, une réécriture en Python du
+protocole (flash en mémoire, pertes de trames): elle sert à essayer l'outil
+sans matériel, elle n'exécute pas fwupd.c. Le code de l'unité est testé par
+tests/test_fwupd.c (même protocole, flash simulée).
+
+    tools/fw_update.py --node 1 build/firmware.bin --commit
+    tools/fw_update.py --loopback --loss 0.05 build/firmware.bin
+"""
+import argparse
+import random
+import struct
+import sys
+import time
+import zlib
+
+ID_CMD, ID_RSP = 0x7C0, 0x7E0
+OP_START, OP_DATA, OP_BLKEND, OP_FINISH, OP_COMMIT, OP_ABORT = 0x10, 0x20, 0x21, 0x30, 0x31, 0x3F
+OP_READY, OP_ACK, OP_NAK, OP_DONE, OP_ERR = 0xA0, 0xA1, 0xA2, 0xB0, 0xEE
+ERRORS = {1: "hors séquence / flash occupée (ou image à l'essai)", 2: "taille refusée", 3: "erreur flash",
+          4: "image non amorçable (table de vecteurs)"}
+SRAM_BASE, SRAM_END, FLASH_BASE = 0x20000000, 0x20008000, 0x08000000   # H503, cf. hw_fwupd_vectors_ok()
+
+
+def vectors_ok(img):
+    sp, rst = struct.unpack_from("<II", img)
+    return (SRAM_BASE < sp <= SRAM_END and sp % 8 == 0 and rst & 1
+            and FLASH_BASE + 8 <= (rst & ~1) < FLASH_BASE + len(img))
+
+
+class CanLink:
+    def __init__(self, args):
+        import can
+        self.can = can
+        self.fd = not args.classic
+        self.bus = can.Bus(interface=args.interface, channel=args.channel, fd=self.fd,
+                           bitrate=125000, data_bitrate=1000000)
+        self.node = args.node
+        self.bus.set_filters([{"can_id": ID_RSP + self.node, "can_mask": 0x7FF}])
+
+    def send(self, data):
+        self.bus.send(self.can.Message(arbitration_id=ID_CMD + self.node, is_extended_id=False,
+                                       is_fd=self.fd, bitrate_switch=self.fd, data=bytes(data)))
+
+    def recv(self, timeout):
+        m = self.bus.recv(timeout)
+        return bytes(m.data) if m is not None else None
+
+
+class LoopbackUnit:
+    """Unité simulée en Python (pas fwupd.c): mêmes réponses, flash effacée à 0xFF."""
+
+    def __init__(self, args):
+        self.fd = not args.classic
+        self.loss = args.loss
+        self.capacity = 64 * 1024
+        self.flash = bytearray(b"\xff" * self.capacity)
+        self.rx = []
+        self.state = "idle"
+        self.swapped = False
+
+    def _reply(self, data):
+        if random.random() >= self.loss:
+            self.rx.append(bytes(data) + bytes(8 - len(data)))
+
+    def send(self, d):
+        if random.random() < self.loss:
+            return
+        op = d[0]
+        if op == OP_START:
+            size = struct.unpack_from("<I", d, 1)[0]
+            if size == 0 or size % 16 or size > self.capacity:
+                self.state = "failed"
+                return self._reply([OP_ERR, 2])
+            self.size, self.next, self.frames, self.buf = size, 0, set(), bytearray(block_size(self.fd))
+            self.flash[:size] = b"\xff" * size
+            self.state = "receiving"
+            self._reply(struct.pack("<BHB", OP_READY, block_size(self.fd), 16))
+        elif op == OP_DATA and self.state == "receiving":
+            blk, idx = struct.unpack_from("<HB", d, 1)
+            if blk == self.next and idx < 16:
+                fd = frame_data(self.fd)
+                self.buf[idx * fd:idx * fd + len(d) - 4] = d[4:]
+                self.frames.add(idx)
+        elif op == OP_BLKEND and self.state == "receiving":
+            blk, crc = struct.unpack_from("<HI", d, 1)
+            if blk + 1 == self.next:
+                return self._reply(struct.pack("<BH", OP_ACK, blk))
+            if blk != self.next:
+                return
+            off = blk * block_size(self.fd)
+            n = min(block_size(self.fd), self.size - off)
+            want = (n + frame_data(self.fd) - 1) // frame_data(self.fd)
+            missing = sum(1 << i for i in range(want) if i not in self.frames)
+            if missing:
+                return self._reply(struct.pack("<BHH", OP_NAK, blk, missing))
+            if zlib.crc32(self.buf[:n]) != crc:
+                self.frames = set()
+                return self._reply(struct.pack("<BHH", OP_NAK, blk, 0))
+            self.flash[off:off + n] = self.buf[:n]
+            self.next, self.frames = self.next + 1, set()
+            self._reply(struct.pack("<BH", OP_ACK, blk))
+        elif op == OP_FINISH:
+            if self.state == "receiving" and self.next * block_size(self.fd) >= self.size:
+                got = zlib.crc32(self.flash[:self.size])
+                self.state = "verified" if got == struct.unpack_from("<I", d, 1)[0] else "failed"
+                self.read_crc = got
+                if self.state == "verified" and not vectors_ok(self.flash[:self.size]):
+                    self.state = "failed"
+                    return self._reply([OP_ERR, 4])
+                self._reply(struct.pack("<BBI", OP_DONE, self.state == "verified", got))
+            elif self.state == "verified":
+                self._reply(struct.pack("<BBI", OP_DONE, 1, self.read_crc))
+            else:
+                self._reply([OP_ERR, 1])
+        elif op == OP_COMMIT:
+            if self.state == "verified":
+                self.swapped = True   # l'unité redémarre: plus de réponse
+            else:
+                self._reply([OP_ERR, 1])
+        elif op == OP_ABORT:
+            self.state = "idle"
+
+    def recv(self, timeout):
+        return self.rx.pop(0) if self.rx else None
+
+
+def frame_data(fd):
+    return (64 if fd else 8) - 4
+
+
+def block_size(fd):
+    return frame_data(fd) * 16
+
+
+def request(link, data, ops, tries=20, timeout=0.3):
+    """Envoie data jusqu'à obtenir une réponse dont l'opcode est dans ops."""
+    for _ in range(tries):
+        link.send(data)
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            r = link.recv(0.05)
+            if r is None:
+                continue
+            if r[0] == OP_ERR:
+                sys.exit("refus: " + ERRORS.get(r[1], str(r[1])))
+            if r[0] in ops:
+                return r
+    sys.exit("pas de réponse de l'unité")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("image")
+    ap.add_argument("--node", type=int, default=1, help="COORD_NODE_ID de l'unité")
+    ap.add_argument("--commit", action="store_true", help="échanger les banques et redémarrer après vérification")
+    ap.add_argument("--classic", action="store_true", help="unité en CAN classique (CAN_FD=0)")
+    ap.add_argument("--interface", default="socketcan")
+    ap.add_argument("--channel", default="can0")
+    ap.add_argument("--loopback", action="store_true", help="unité simulée, sans bus")
+    ap.add_argument("--loss", type=float, default=0.0, help="taux de pertes de l'unité simulée")
+    args = ap.parse_args()
+
+    with open(args.image, "rb") as f:
+        img = f.read()
+    img += b"\xff" * (-len(img) % 16)   # programmation par quad-mots
+
+    if args.loopback:
+        link = LoopbackUnit(args)
+    else:
+        try:
+            link = CanLink(args)
+        except ImportError:
+            sys.exit("python-can requis (pip install python-can)")
+
+    t0 = time.monotonic()
+    r = request(link, struct.pack("<BI", OP_START, len(img)), (OP_READY,), timeout=3.0)   # effacement
+    block, frames = struct.unpack_from("<HB", r, 1)
+    fdata = block // frames
+    nblk = (len(img) + block - 1) // block
+    retries = 0
+
+    for b in range(nblk):
+        chunk = img[b * block:(b + 1) * block]
+        crc = zlib.crc32(chunk)
+        full = want = (1 << ((len(chunk) + fdata - 1) // fdata)) - 1
+        while True:
+            for i in range(frames):
+                if want & (1 << i):
+                    link.send(struct.pack("<BHB", OP_DATA, b, i) + chunk[i * fdata:(i + 1) * fdata])
+            r = request(link, struct.pack("<BHI", OP_BLKEND, b, crc), (OP_ACK, OP_NAK))
+            blk = struct.unpack_from("<H", r, 1)[0]
+            if r[0] == OP_ACK and blk == b:
+                break
+            if r[0] == OP_NAK and blk == b:
+                want = struct.unpack_from("<H", r, 3)[0] or full   # 0: CRC faux
+                retries += 1
+            else:
+                want = 0   # réponse à un bloc précédent: relancer BLKEND seul
+        print("\r%d/%d blocs" % (b + 1, nblk), end="", file=sys.stderr)
+
+    r = request(link, struct.pack("<BI", OP_FINISH, zlib.crc32(img)), (OP_DONE,), timeout=2.0)
+    ok, got = struct.unpack_from("<BI", r, 1)
+    dt = time.monotonic() - t0
+    print("\n%d octets en %.2f s (%.1f ko/s), %d renvoi(s), crc relu %08x" %
+          (len(img), dt, len(img) / 1024.0 / max(dt, 1e-6), retries, got), file=sys.stderr)
+    if not ok:
+        sys.exit("vérification en flash échouée: image en service conservée")
+    if args.commit:
+        link.send([OP_COMMIT])
+        print("échange de banques demandé, l'unité redémarre à l'essai", file=sys.stderr)
+    if args.loopback:
+        assert link.flash[:len(img)] == img
+
+
+if __name__ == "__main__":
+    main()
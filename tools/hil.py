@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Client banc de test (hil.h): injection d'événements, lecture d'état,
+gel et pas-à-pas du dispatcher, sur la ligne console/télémétrie (USART2).
+
+Utilisable en ligne de commande ou importé par un script de scénarios:
+
+    tools/hil.py /dev/ttyACM0 ping
+    tools/hil.py /dev/ttyACM0 push 3 --u8 1         # EVT n°3 dans la file normale
+    tools/hil.py /dev/ttyACM0 freeze 1
+    tools/hil.py /dev/ttyACM0 step 1
+    tools/hil.py /dev/ttyACM0 state evq tmr
+
+    from hil import Hil
+    h = Hil("/dev/ttyACM0")
+    h.freeze(True); h.push(1); done, last, state = h.step(1)   # EVT_TH_ON
+
+Seulement sur un firmware compilé avec HIL_ENABLE=1 (cmake -DHIL_ENABLE=ON):
+sinon aucune réponse. Pendant le gel, les défauts (file FAULTS, driver de
+sorties) sont quand même servis, et l'unité relâche le gel après
+HIL_FREEZE_MAX_MS sans requête: un script qui attend longtemps envoie des ping.
+
+Les trames de texte et de journal qui arrivent entre deux réponses sont ignorées
+(tools/log_decode.py pour les lire). Nécessite pyserial.
+"""
+import argparse
+import struct
+import sys
+import time
+
+from log_decode import cobs_decode, crc16
+
+TELEM_T_HIL = 0x03
+OP_PING, OP_PUSH, OP_STATE, OP_EVQ, OP_TMR, OP_FREEZE, OP_STEP = 0x01, 0x10, 0x20, 0x21, 0x22, 0x30, 0x31
+STATUS = {1: "arguments invalides", 2: "opération inconnue", 3: "file pleine", 4: "pas-à-pas refusé (gel?)"}
+EVQ_NORMAL, EVQ_FAULTS = 0, 1
+TMR_PER_FRAME = 12   # HIL_TMR_PER_FRAME
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_at, code = 0, 1
+    for b in data:
+        if b == 0:
+            out[code_at] = code
+            code_at, code = len(out), 1
+            out.append(0)
+        else:
+            out.append(b)
+            code += 1
+    out[code_at] = code
+    return bytes(out)
+
+
+class HilError(Exception):
+    pass
+
+
+class Hil:
+    def __init__(self, port, baud=115200, timeout=0.2, tries=5):
+        import serial
+        self.ser = serial.Serial(port, baud, timeout=0.02)
+        self.timeout = timeout
+        self.tries = tries
+        self.seq = int(time.monotonic() * 1000) & 0xFF   # différent du dernier seq mémorisé par l'unité
+        self.buf = bytearray()
+
+    def _frames(self):
+        chunk = self.ser.read(256)
+        self.buf += chunk
+        while b"\0" in self.buf:
+            raw, _, rest = self.buf.partition(b"\0")
+            self.buf = bytearray(rest)
+            try:
+                f = cobs_decode(raw)
+            except ValueError:
+                continue
+            if len(f) >= 4 and crc16(f[:-2]) == struct.unpack(">H", f[-2:])[0]:
+                yield f[0], f[2:-2]
+
+    def request(self, op, args=b"", timeout=None):
+        """Requête → données de la réponse. Même seq à chaque relance: jamais exécutée deux fois."""
+        self.seq = (self.seq + 1) & 0xFF
+        raw = bytes([TELEM_T_HIL, self.seq, op]) + bytes(args)
+        frame = b"\0" + cobs_encode(raw + struct.pack(">H", crc16(raw))) + b"\0"
+        for _ in range(self.tries):
+            self.ser.write(frame)
+            deadline = time.monotonic() + (timeout or self.timeout)
+            while time.monotonic() < deadline:
+                for t, p in self._frames():
+                    if t == TELEM_T_HIL and len(p) >= 3 and p[0] == self.seq and p[1] == op:
+                        if p[2] != 0:
+                            raise HilError(STATUS.get(p[2], "statut %d" % p[2]))
+                        return bytes(p[3:])
+        raise HilError("pas de réponse")
+
+    def ping(self):
+        version, evt_max, tmr_count, frozen = struct.unpack("<4B", self.request(OP_PING))
+        return dict(version=version, evt_max=evt_max, tmr_count=tmr_count, frozen=bool(frozen))
+
+    def push(self, evt, u8=0, u16=0, queue=EVQ_NORMAL):
+        self.request(OP_PUSH, struct.pack("<BBBH", queue, evt, u8, u16))
+
+    def state(self):
+        st, stages, frozen, tick = struct.unpack("<BBBI", self.request(OP_STATE))
+        return dict(state=st, stages=stages, frozen=bool(frozen), tick_ms=tick)
+
+    def evq(self, queue=EVQ_NORMAL):
+        keys = ("pushed", "popped", "dropped", "coalesced", "ignored")
+        return dict(zip(keys, struct.unpack("<5I", self.request(OP_EVQ, [queue]))))
+
+    def timers(self):
+        """{id: ms restantes} des timers actifs."""
+        out, first = {}, 0
+        while True:
+            d = self.request(OP_TMR, [first])
+            first, n, active = struct.unpack_from("<BBI", d)
+            for i, ms in enumerate(struct.unpack_from("<%dI" % n, d, 6)):
+                if active & (1 << i):
+                    out[first + i] = ms
+            first += n
+            if n < TMR_PER_FRAME:
+                return out
+
+    def freeze(self, on=True):
+        self.request(OP_FREEZE, [1 if on else 0])
+
+    def step(self, n=1):
+        """Sert n événements (gel requis). Retourne (faits, dernier type, état FSM)."""
+        return struct.unpack("<HBB", self.request(OP_STEP, struct.pack("<H", n), timeout=1.0))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("port")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("cmd", nargs="+", help="ping | state | evq | tmr | push EVT | freeze 0|1 | step N")
+    ap.add_argument("--u8", type=int, default=0)
+    ap.add_argument("--u16", type=int, default=0)
+    ap.add_argument("--faults", action="store_true", help="push/evq sur la file FAULTS")
+    args = ap.parse_args()
+
+    try:
+        h = Hil(args.port, args.baud)
+    except ImportError:
+        sys.exit("pyserial requis (pip install pyserial)")
+    q = EVQ_FAULTS if args.faults else EVQ_NORMAL
+    words = iter(args.cmd)
+    try:
+        for w in words:
+            if w == "ping":
+                print(h.ping())
+            elif w == "state":
+                print(h.state())
+            elif w == "evq":
+                print(h.evq(q))
+            elif w == "tmr":
+                print(h.timers())
+            elif w == "push":
+                h.push(int(next(words), 0), args.u8, args.u16, q)
+                print("ok")
+            elif w == "freeze":
+                h.freeze(next(words) != "0")
+                print("ok")
+            elif w == "step":
+                done, last, st = h.step(int(next(words), 0))
+                print("faits %d, dernier evt %d, état %d" % (done, last, st))
+            else:
+                sys.exit("commande inconnue: " + w)
+    except (HilError, StopIteration) as e:
+        sys.exit("erreur: %s" % (e or "argument manquant"))
+
+
+if __name__ == "__main__":
+    main()
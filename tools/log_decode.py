@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Décodeur du flux de télémétrie (telem.c) et du journal tokenisé (log.h).
+
+Entrée: octets bruts de la ligne USART2 (fichier de capture, '-' pour stdin,
+ou un port série si pyserial est installé). Trames COBS délimitées par 0x00,
+CRC16-CCITT vérifié. Les entrées TELEM_T_LOG sont reconstruites à partir de la
+table des chaînes extraite de l'ELF au post-build (build/<type>/polyvarium_v2.logstr).
+
+    tools/log_decode.py build/Debug/polyvarium_v2.logstr capture.bin
+    tools/log_decode.py build/Debug/polyvarium_v2.logstr /dev/ttyACM0 --baud 115200
+"""
+import argparse
+import re
+import struct
+import sys
+
+TELEM_T_TEXT = 0x01
+TELEM_T_LOG = 0x02
+LEVELS = "EWID"   # LOG_LVL_ERR, WRN, INF, DBG
+
+# Spécification printf: drapeaux, largeur, modificateur de taille ignoré, conversion
+SPEC = re.compile(r"%([-+ 0#]*\d*)(?:hh|h|ll|l|z|t)?([diuxXc%])")
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("COBS invalide")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def format_c(fmt, args):
+    it = iter(args)
+
+    def conv(m):
+        flags, kind = m.group(1), m.group(2)
+        if kind == "%":
+            return "%"
+        v = next(it, 0)
+        if kind in "di":
+            v = v - (1 << 32) if v & 0x80000000 else v
+            return ("%" + flags + "d") % v
+        if kind == "c":
+            return chr(v & 0xFF)
+        return ("%" + flags + kind) % v
+
+    return SPEC.sub(conv, fmt)
+
+
+class Strings:
+    def __init__(self, path, base):
+        with open(path, "rb") as f:
+            self.blob = f.read()
+        self.base = base
+
+    def get(self, sid):
+        off = sid - self.base
+        if off < 0 or off >= len(self.blob):
+            return None
+        end = self.blob.find(b"\0", off)
+        s = self.blob[off:end if end >= 0 else None].decode("utf-8", "replace")
+        where, _, fmt = s.partition("\x1f")
+        return where, fmt
+
+
+def decode_log(payload, strings, out):
+    i = 0
+    while i + 9 <= len(payload):
+        sid, ts, ln = struct.unpack_from("<IIB", payload, i)
+        lvl, nargs = ln >> 4, ln & 0x0F
+        i += 9
+        args = list(struct.unpack_from("<%dI" % nargs, payload, i))
+        i += 4 * nargs
+        entry = strings.get(sid)
+        tag = LEVELS[lvl] if lvl < len(LEVELS) else "?"
+        if entry is None:
+            out.write("%10.3f %s <id 0x%08x inconnu> %s\n" % (ts / 1000.0, tag, sid, args))
+            continue
+        where, fmt = entry
+        where = where.rsplit("/", 1)[-1]
+        out.write("%10.3f %s %-24s %s\n" % (ts / 1000.0, tag, where, format_c(fmt, args)))
+
+
+def frames(stream):
+    buf = bytearray()
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            return
+        if chunk[0] != 0:
+            buf += chunk
+            continue
+        if buf:
+            yield bytes(buf)
+        buf.clear()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("table", help="table des chaînes (.logstr)")
+    ap.add_argument("input", help="capture binaire, '-' pour stdin, ou port série")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--base", type=lambda s: int(s, 0), default=0,
+                    help="adresse de la section .logstr (0 avec le script de liens du projet)")
+    a = ap.parse_args()
+
+    strings = Strings(a.table, a.base)
+    if a.input == "-":
+        stream = sys.stdin.buffer
+    elif a.input.startswith("/dev/") or a.input.upper().startswith("COM"):
+        import serial  # pyserial
+        stream = serial.Serial(a.input, a.baud)
+    else:
+        stream = open(a.input, "rb")
+
+    last_seq = None
+    out = sys.stdout
+    for raw in frames(stream):
+        try:
+            f = cobs_decode(raw)
+        except ValueError:
+            out.write("# trame COBS invalide\n")
+            continue
+        if len(f) < 4 or crc16(f[:-2]) != struct.unpack(">H", f[-2:])[0]:
+            out.write("# CRC faux (%d octets)\n" % len(f))
+            continue
+        ftype, seq, payload = f[0], f[1], f[2:-2]
+        if last_seq is not None and seq != (last_seq + 1) & 0xFF:
+            out.write("# %d trame(s) perdue(s)\n" % ((seq - last_seq - 1) & 0xFF))
+        last_seq = seq
+        if ftype == TELEM_T_LOG:
+            decode_log(payload, strings, out)
+        elif ftype == TELEM_T_TEXT:
+            out.write(payload.decode("utf-8", "replace"))
+        else:
+            out.write("# type 0x%02x: %s\n" % (ftype, payload.hex()))
+        out.flush()
+
+
+if __name__ == "__main__":
+    main()